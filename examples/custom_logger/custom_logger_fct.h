@@ -165,6 +165,21 @@ custlog__on_test_skip(fct_logger_i *l, fct_logger_evt_t const *e)
           );
 }
 
+/* When a benchmark was measured, for example FCT_BENCH_BGN() run with
+--bench. */
+static void
+custlog__on_bench(fct_logger_i *l, fct_logger_evt_t const *e)
+{
+    fct_test_t const *test = e->test;
+    (void)l;
+    printf("on_bench:\n"
+           "    -      name: %s\n"
+           "    - ns per op: %f\n",
+           fct_test__name(test),
+           test->bench->ns_per_op
+          );
+}
+
 /* Handles the clean up of the logger object. Perform your special
 clean up code here. */
 static void
@@ -200,6 +215,7 @@ custlog_new(void)
     logger->vtable.on_warn = custlog__on_warn;
     logger->vtable.on_test_suite_skip =  custlog__on_test_suite_skip;
     logger->vtable.on_test_skip = custlog__on_test_skip;
+    logger->vtable.on_bench = custlog__on_bench;
     return (fct_logger_i*)logger;
 }
 
@@ -81,6 +81,29 @@ with a standard logger. */
 #define FCT_MAX_NAME           256
 #define FCT_MAX_LOG_LINE       256
 
+/* The default for --max-failures, the most failed checks that are kept
+and logged for one test. */
+#if !defined(FCT_MAX_FAILURES)
+#   define FCT_MAX_FAILURES    100
+#endif
+
+/* The default for --bench-time, about how long in seconds a benchmark is
+measured for. */
+#if !defined(FCT_BENCH_TIME)
+#   define FCT_BENCH_TIME      1.0
+#endif
+
+/* The most batches a benchmark times, each is one sample. */
+#if !defined(FCT_BENCH_SAMPLES)
+#   define FCT_BENCH_SAMPLES   50
+#endif
+
+/* The default for --bench-threshold, how many percent slower than its
+--bench-baseline a benchmark may be. */
+#if !defined(FCT_BENCH_THRESHOLD)
+#   define FCT_BENCH_THRESHOLD 10.0
+#endif
+
 #define nbool_t int
 #define FCT_TRUE   1
 #define FCT_FALSE  0
@@ -118,6 +141,7 @@ typedef struct _fctchk_t fctchk_t;
 typedef struct _fct_test_t fct_test_t;
 typedef struct _fct_ts_t fct_ts_t;
 typedef struct _fctkern_t fctkern_t;
+typedef struct _fct_task_t fct_task_t;
 
 /* Forward declare some functions used throughout. */
 static fct_logger_i*
@@ -165,6 +189,9 @@ fct_logger__on_test_skip(
 static void
 fct_logger__on_warn(fct_logger_i *logger, char const *warn);
 
+static void
+fct_logger__on_bench(fct_logger_i *logger, fct_test_t const *test);
+
 
 
 /* Explicitly indicate a no-op */
@@ -172,6 +199,53 @@ fct_logger__on_warn(fct_logger_i *logger, char const *warn);
 
 #define fct_unused(x)  (void)(x)
 
+/* With a __COUNTER__ every test gets a unique id. */
+#if defined(__COUNTER__)
+#   define FCT_TEST_IDS
+#endif
+
+/* Define FCT_CONF_JUMP_DISPATCH to use the test ids to jump straight to
+a test, instead of walking past all the tests in front of it. Each test
+is a case label of a switch opened by FCT_SETUP_END, so every test must
+sit directly in its suite, not inside a loop or a block of its own, and
+in C++ there can be no initialized declarations between the tests. By
+default, or with FCT_CONF_NO_JUMP_DISPATCH, the suite is walked. */
+#if defined(FCT_CONF_JUMP_DISPATCH) && defined(FCT_TEST_IDS) \
+    && !defined(FCT_CONF_NO_JUMP_DISPATCH)
+#   define FCT_JUMP_DISPATCH
+#endif
+
+/* Define FCT_CONF_REGISTRY to have every suite and test leave a
+descriptor behind in a linker section, see "TEST REGISTRY" below. Only
+available with GCC compatible compilers building ELF objects, elsewhere
+it is quietly ignored. */
+#if defined(FCT_CONF_REGISTRY) && defined(FCT_TEST_IDS) \
+    && defined(__GNUC__) && defined(__ELF__)
+#   define FCT_REGISTRY
+#endif
+
+/* Define FCT_CONF_ALLOC to count the heap allocations of each test, see
+"ALLOCATION COUNTS" below. Needs the GNU linker and Linux, elsewhere it
+is quietly ignored. */
+#if defined(FCT_CONF_ALLOC) && defined(__linux__) && defined(__GNUC__)
+#   define FCT_ALLOC
+#   include <malloc.h>
+#   if defined(__cplusplus)
+extern "C" {
+#   endif
+    void *__real_malloc(size_t sz);
+    void *__real_calloc(size_t num, size_t sz);
+    void *__real_realloc(void *ptr, size_t sz);
+    void __real_free(void *ptr);
+    void *__wrap_malloc(size_t sz);
+    void *__wrap_calloc(size_t num, size_t sz);
+    void *__wrap_realloc(void *ptr, size_t sz);
+    void __wrap_free(void *ptr);
+#   if defined(__cplusplus)
+}
+#   endif
+#endif
+
 /* This is just a little trick to let me put comments inside of macros. I
 really only want to bother with this when we are "unwinding" the macros
 for debugging purposes. */
@@ -181,6 +255,202 @@ for debugging purposes. */
 #   define _fct_cmt(string)
 #endif
 
+/*
+--------------------------------------------------------
+MEMORY
+--------------------------------------------------------
+Everything FCTX allocates goes through fct_malloc, fct_calloc,
+fct_realloc and fct_free, or fct_free_fn where a function is wanted. By
+default these are the C library ones.
+
+Define FCT_CONF_NO_HEAP to take it all from a static pool of
+FCT_POOL_SIZE bytes instead, so FCTX never touches the heap, and uses
+the same memory from one run to the next. The pool is carved into blocks
+of power of two sizes, a freed block is kept for the next allocation of
+its size. With GCC there is one pool for the program, shared by each
+file that includes fct.h, so FCT_POOL_SIZE must be the same in each of
+them. Running out is reported on stderr and ends the run with
+EXIT_FAILURE, so nothing in FCTX is ever handed a NULL.
+
+With FCT_CONF_ALLOC they go straight to the C library, past the counting
+wrappers, so only what the tests allocate is counted.
+*/
+
+#if defined(FCT_CONF_NO_HEAP)
+
+#if !defined(FCT_POOL_SIZE)
+#   define FCT_POOL_SIZE   (4*1024*1024)
+#endif
+
+/* Sits in front of each block, and keeps what follows aligned. */
+typedef union _fct_pool_hdr_t
+{
+    long l;
+    double d;
+    void *p;
+    /* The size class, the block holds 1 << cls bytes with this. */
+    size_t cls;
+    /* Links a freed block into its free list. */
+    union _fct_pool_hdr_t *next;
+} fct_pool_hdr_t;
+
+#define FCT_POOL_NUM_CLASSES   (sizeof(size_t)*8)
+
+typedef struct _fct_pool_t
+{
+    fct_pool_hdr_t mem[FCT_POOL_SIZE/sizeof(fct_pool_hdr_t)];
+    /* How much of MEM has been carved into blocks so far. */
+    size_t used;
+    /* The size of MEM, as the first file to allocate saw it. */
+    size_t size;
+    fct_pool_hdr_t *free_list[FCT_POOL_NUM_CLASSES];
+#if defined(__GNUC__)
+    volatile int lock;
+#endif
+} fct_pool_t;
+
+/* Weak, so the files of a program share the one pool. */
+#if defined(__GNUC__)
+fct_pool_t fct_pool __attribute__((weak));
+#else
+static fct_pool_t fct_pool;
+#endif
+
+/* Checks can come from any thread. */
+#if defined(__GNUC__)
+#   define fct_pool__lock() \
+        while ( __sync_lock_test_and_set(&(fct_pool.lock), 1) ) {}
+#   define fct_pool__unlock()  __sync_lock_release(&(fct_pool.lock))
+#else
+#   define fct_pool__lock()
+#   define fct_pool__unlock()
+#endif
+
+
+static void *
+fct_pool__malloc(size_t sz)
+{
+    fct_pool_hdr_t *blk =NULL;
+    size_t cls =0;
+    size_t blk_sz =0;
+    while ( ((size_t)1 << cls) < sz + sizeof(fct_pool_hdr_t) )
+    {
+        ++cls;
+    }
+    blk_sz = (size_t)1 << cls;
+    fct_pool__lock();
+    if ( fct_pool.size == 0 )
+    {
+        fct_pool.size = sizeof(fct_pool.mem);
+    }
+    else if ( fct_pool.size != sizeof(fct_pool.mem) )
+    {
+        fct_pool__unlock();
+        fprintf(stderr,
+                "fct: FCT_POOL_SIZE is not the same in each file\n");
+        exit(EXIT_FAILURE);
+    }
+    blk = fct_pool.free_list[cls];
+    if ( blk != NULL )
+    {
+        fct_pool.free_list[cls] = blk->next;
+    }
+    else if ( sizeof(fct_pool.mem) - fct_pool.used >= blk_sz )
+    {
+        blk = (fct_pool_hdr_t*)((char*)fct_pool.mem + fct_pool.used);
+        fct_pool.used += blk_sz;
+    }
+    else
+    {
+        fct_pool__unlock();
+        fprintf(stderr,
+                "fct: out of static memory, %lu bytes wanted with %lu of "
+                "%lu in use (raise FCT_POOL_SIZE)\n",
+                (unsigned long)sz,
+                (unsigned long)fct_pool.used,
+                (unsigned long)sizeof(fct_pool.mem));
+        exit(EXIT_FAILURE);
+    }
+    fct_pool__unlock();
+    blk->cls = cls;
+    return blk + 1;
+}
+
+
+static void
+fct_pool__free(void *ptr)
+{
+    fct_pool_hdr_t *blk =NULL;
+    size_t cls =0;
+    if ( ptr == NULL )
+    {
+        return;
+    }
+    blk = (fct_pool_hdr_t*)ptr - 1;
+    cls = blk->cls;
+    fct_pool__lock();
+    blk->next = fct_pool.free_list[cls];
+    fct_pool.free_list[cls] = blk;
+    fct_pool__unlock();
+}
+
+
+static void *
+fct_pool__calloc(size_t num, size_t sz)
+{
+    void *ptr = fct_pool__malloc(num*sz);
+    memset(ptr, 0, num*sz);
+    return ptr;
+}
+
+
+/* Stays in place while the block is big enough. */
+static void *
+fct_pool__realloc(void *ptr, size_t sz)
+{
+    size_t avail =0;
+    void *new_ptr =NULL;
+    if ( ptr == NULL )
+    {
+        return fct_pool__malloc(sz);
+    }
+    avail = ((size_t)1 << ((fct_pool_hdr_t*)ptr - 1)->cls)
+            - sizeof(fct_pool_hdr_t);
+    if ( sz <= avail )
+    {
+        return ptr;
+    }
+    new_ptr = fct_pool__malloc(sz);
+    memcpy(new_ptr, ptr, avail);
+    fct_pool__free(ptr);
+    return new_ptr;
+}
+
+#   define fct_malloc(_SZ_)          fct_pool__malloc(_SZ_)
+#   define fct_calloc(_NUM_, _SZ_)   fct_pool__calloc((_NUM_), (_SZ_))
+#   define fct_realloc(_PTR_, _SZ_)  fct_pool__realloc((_PTR_), (_SZ_))
+#   define fct_free(_PTR_)           fct_pool__free(_PTR_)
+#   define fct_free_fn               fct_pool__free
+
+#elif defined(FCT_ALLOC)
+
+#   define fct_malloc(_SZ_)          __real_malloc(_SZ_)
+#   define fct_calloc(_NUM_, _SZ_)   __real_calloc((_NUM_), (_SZ_))
+#   define fct_realloc(_PTR_, _SZ_)  __real_realloc((_PTR_), (_SZ_))
+#   define fct_free(_PTR_)           __real_free(_PTR_)
+#   define fct_free_fn               __real_free
+
+#else
+
+#   define fct_malloc(_SZ_)          malloc(_SZ_)
+#   define fct_calloc(_NUM_, _SZ_)   calloc((_NUM_), (_SZ_))
+#   define fct_realloc(_PTR_, _SZ_)  realloc((_PTR_), (_SZ_))
+#   define fct_free(_PTR_)           free(_PTR_)
+#   define fct_free_fn               free
+
+#endif /* FCT_CONF_NO_HEAP */
+
+
 /*
 --------------------------------------------------------
 UTILITIES
@@ -218,6 +488,93 @@ that follows the ISO C++ conformant naming convention. */
 #    define _fct_read  read
 #endif /* WIN32 */
 
+/* Running tests in worker processes (--jobs) needs fork, anonymous shared
+memory and GCC style atomics, see "PARALLEL JOBS" below. Elsewhere the
+option is accepted and the tests run as usual. Define FCT_CONF_NO_JOBS to
+leave it out. */
+#if !defined(WIN32) && !defined(FCT_CONF_NO_JOBS) && defined(__GNUC__) \
+    && defined(_POSIX_VERSION)
+#    include <sys/types.h>
+#    include <sys/mman.h>
+#    include <sys/wait.h>
+#    include <poll.h>
+#    include <errno.h>
+#    include <limits.h>
+#    if defined(MAP_ANONYMOUS)
+#        define FCT_MAP_ANON MAP_ANONYMOUS
+#    elif defined(MAP_ANON)
+#        define FCT_MAP_ANON MAP_ANON
+#    endif
+#    if defined(FCT_MAP_ANON)
+#        define FCT_JOBS
+#    endif
+#endif
+
+/* Define FCT_CONF_THREADS to be able to run the FCTMF suites on a pool
+of threads (--threads), see "THREADED SUITES" below. Needs POSIX threads
+and GCC style thread locals, so link with -pthread. */
+#if defined(FCT_CONF_THREADS) && !defined(WIN32) && defined(__GNUC__) \
+    && defined(_POSIX_VERSION)
+#    include <pthread.h>
+#    define FCT_THREADS
+#endif
+
+/* Checks made from threads that a test starts itself go into buffers of
+their own, and are added to the test at FCT_TEST_END, see "A TEST"
+below. Needs GCC style thread locals and atomics. Define
+FCT_CONF_NO_CHK_THREADS to leave it out. */
+#if defined(__GNUC__) && !defined(FCT_CONF_NO_CHK_THREADS)
+#    define FCT_CHK_THREADS
+#endif
+/* With variable argument macros fct_xchk can skip the message on the pass
+path, define FCT_CONF_NO_VARIADIC_MACROS to not use them. */
+#if !defined(FCT_CONF_NO_VARIADIC_MACROS) \
+    && ((defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L) \
+        || (defined(__cplusplus) && __cplusplus >= 201103L) \
+        || (defined(__GNUC__) && !defined(__STRICT_ANSI__)) \
+        || (defined(_MSC_VER) && _MSC_VER >= 1400))
+#    define FCT_VARIADIC_MACROS
+#endif
+
+/* The timers use clock_gettime where there is one. */
+#if !defined(WIN32) && defined(_POSIX_TIMERS) && (_POSIX_TIMERS > 0) \
+    && defined(CLOCK_MONOTONIC)
+#    define FCT_CLOCK_GETTIME
+#endif
+
+/* Each test takes what it used from getrusage where there is one, see
+"RESOURCE USAGE" below. */
+#if !defined(WIN32) && defined(_POSIX_VERSION)
+#    include <sys/resource.h>
+#    define FCT_RUSAGE
+#endif
+
+/* Define FCT_CONF_RDTSC to read the wall clock from the time stamp
+counter, see "TIMER" below. Needs GCC on x86, and clock_gettime to
+scale it. */
+#if defined(FCT_CONF_RDTSC) && defined(FCT_CLOCK_GETTIME) \
+    && defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#    define FCT_RDTSC
+#endif
+
+/* Define FCT_CONF_PERF to count CPU events around each test and
+benchmark, see "PERF COUNTERS" below. Linux only. */
+#if defined(FCT_CONF_PERF) && defined(__linux__) && defined(__GNUC__)
+#    include <linux/perf_event.h>
+#    include <sys/syscall.h>
+#    include <sys/types.h>
+#    include <unistd.h>
+#    if defined(__NR_perf_event_open)
+#        define FCT_PERF
+#    endif
+#endif
+
+#if defined(FCT_THREADS) || defined(FCT_CHK_THREADS)
+#    define FCT_TLS __thread
+#else
+#    define FCT_TLS
+#endif
+
 
 
 
@@ -313,8 +670,11 @@ fctstr_clone(char const *s)
     size_t klen =0;
     FCT_ASSERT( s != NULL && "invalid arg");
     klen = strlen(s)+1;
-    k = (char*)malloc(sizeof(char)*klen+1);
-    fctstr_safe_cpy(k, s, klen);
+    k = (char*)fct_malloc(sizeof(char)*klen+1);
+    if ( k != NULL )
+    {
+        fctstr_safe_cpy(k, s, klen);
+    }
     return k;
 }
 
@@ -331,7 +691,11 @@ fctstr_clone_lower(char const *s)
         return NULL;
     }
     klen = strlen(s)+1;
-    k = (char*)malloc(sizeof(char)*klen+1);
+    k = (char*)fct_malloc(sizeof(char)*klen+1);
+    if ( k == NULL )
+    {
+        return NULL;
+    }
     for ( i=0; i != klen; ++i )
     {
         k[i] = (char)tolower(s[i]);
@@ -389,6 +753,54 @@ fct_filter_pass(char const *prefix, char const *test_str)
 }
 
 
+/* A filter written as "suite.prefix" is qualified by a suite name. Returns
+the length of the suite part, or 0 if the filter is a plain prefix. */
+static size_t
+fct_filter_suite_len(char const *filter)
+{
+    char const *dot = NULL;
+    FCT_ASSERT( filter != NULL );
+    dot = strchr(filter, '.');
+    return (dot == NULL) ? 0 : (size_t)(dot - filter);
+}
+
+
+/* Returns FCT_TRUE if the suite part of a qualified filter (of length
+SUITE_LEN) is exactly SUITE_NAME. */
+static nbool_t
+fct_filter_is_suite(char const *filter,
+                    size_t suite_len,
+                    char const *suite_name)
+{
+    FCT_ASSERT( filter != NULL );
+    FCT_ASSERT( suite_name != NULL );
+    return strlen(suite_name) == suite_len
+           && strncmp(filter, suite_name, suite_len) == 0;
+}
+
+
+/* Like fct_filter_pass, but understands suite qualified filters. If
+the SUITE_NAME is NULL only the plain prefix filters can match. A
+qualified filter with nothing after the '.' matches the whole suite. */
+static nbool_t
+fct_filter_pass2(char const *filter,
+                 char const *suite_name,
+                 char const *test_str)
+{
+    size_t suite_len = fct_filter_suite_len(filter);
+    if ( suite_len == 0 )
+    {
+        return fct_filter_pass(filter, test_str);
+    }
+    if ( suite_name == NULL
+            || !fct_filter_is_suite(filter, suite_len, suite_name) )
+    {
+        return FCT_FALSE;
+    }
+    return fct_filter_pass(filter + suite_len + 1, test_str);
+}
+
+
 /* Routine checks if two strings are equal. Taken from
 http://publications.gbdirect.co.uk/c_book/chapter5/character_handling.html
 */
@@ -476,8 +888,8 @@ fctstr_iincl(char const *str, char const *check_incl)
     char *lstr = fctstr_clone_lower(str);
     char *lcheck_incl = fctstr_clone_lower(check_incl);
     int found = fctstr_incl(lstr, lcheck_incl);
-    free(lstr);
-    free(lcheck_incl);
+    fct_free(lstr);
+    fct_free(lcheck_incl);
     return found;
 }
 
@@ -511,8 +923,8 @@ fctstr_istartswith(char const *str, char const *check)
     char *icheck = fctstr_clone_lower(check);
     /* TODO: check for memory. */
     int startswith = fctstr_startswith(istr, icheck);
-    free(istr);
-    free(icheck);
+    fct_free(istr);
+    fct_free(icheck);
     return startswith;
 }
 
@@ -622,18 +1034,140 @@ fct_dotted_line_end(char const *endswith)
 --------------------------------------------------------
 TIMER
 --------------------------------------------------------
-This is a low-res implementation at the moment.
-
-We will improve this in the future, and isolate the
-implementation from the rest of the code.
+A timer keeps three times: the wall clock, the CPU time of the whole
+process, and the CPU time of the thread that ran it. With POSIX
+clock_gettime these come from CLOCK_MONOTONIC,
+CLOCK_PROCESS_CPUTIME_ID and CLOCK_THREAD_CPUTIME_ID, in nanoseconds.
+Elsewhere all three fall back to clock().
+
+Define FCT_CONF_RDTSC to read the wall clock from the x86 time stamp
+counter instead, which is cheaper to read. It is scaled to seconds
+against CLOCK_MONOTONIC the first time it is used, so it needs an
+invariant TSC to be right.
 */
 
+/* One reading of a clock. The seconds and nanoseconds are kept apart so
+the difference of two readings is exact. */
+typedef struct _fct_tick_t fct_tick_t;
+struct _fct_tick_t
+{
+    long sec;
+    long nsec;
+};
+
+
+static void
+fct_tick__from_clock(fct_tick_t *tick, clock_t c)
+{
+    tick->sec = (long)(c / CLOCKS_PER_SEC);
+    tick->nsec = (long)((double)(c % CLOCKS_PER_SEC)
+                        * (1000000000.0 / CLOCKS_PER_SEC));
+}
+
+
+#if defined(FCT_CLOCK_GETTIME)
+static void
+fct_tick__from_clock_id(fct_tick_t *tick, clockid_t id)
+{
+    struct timespec ts;
+    if ( clock_gettime(id, &ts) != 0 )
+    {
+        fct_tick__from_clock(tick, clock());
+        return;
+    }
+    tick->sec = (long)ts.tv_sec;
+    tick->nsec = ts.tv_nsec;
+}
+#endif /* FCT_CLOCK_GETTIME */
+
+
+/* Returns the difference, STOP - START, in seconds. */
+static double
+fct_tick__diff(fct_tick_t const *stop, fct_tick_t const *start)
+{
+    return (double)(stop->sec - start->sec)
+           + (double)(stop->nsec - start->nsec) / 1000000000.0;
+}
+
+
+#if defined(FCT_RDTSC)
+/* The counter at the time we scaled it, and its ticks a second. */
+static unsigned long long fct_tsc_base =0;
+static double fct_tsc_hz =0.0;
+
+/* Counts the ticks over 10ms of the monotonic clock. */
+static void
+fct_tsc__calibrate(void)
+{
+    fct_tick_t start;
+    fct_tick_t now;
+    unsigned long long tsc_start =0;
+    fct_tick__from_clock_id(&start, CLOCK_MONOTONIC);
+    tsc_start = __builtin_ia32_rdtsc();
+    do
+    {
+        fct_tick__from_clock_id(&now, CLOCK_MONOTONIC);
+    }
+    while ( fct_tick__diff(&now, &start) < 0.01 );
+    fct_tsc_hz = (double)(__builtin_ia32_rdtsc() - tsc_start)
+                 / fct_tick__diff(&now, &start);
+    fct_tsc_base = tsc_start;
+}
+#endif /* FCT_RDTSC */
+
+
+static void
+fct_tick__wall(fct_tick_t *tick)
+{
+#if defined(FCT_RDTSC)
+    double secs =0.0;
+    if ( fct_tsc_hz <= 0.0 )
+    {
+        fct_tsc__calibrate();
+    }
+    secs = (double)(__builtin_ia32_rdtsc() - fct_tsc_base) / fct_tsc_hz;
+    tick->sec = (long)secs;
+    tick->nsec = (long)((secs - (double)tick->sec) * 1000000000.0);
+#elif defined(FCT_CLOCK_GETTIME)
+    fct_tick__from_clock_id(tick, CLOCK_MONOTONIC);
+#else
+    fct_tick__from_clock(tick, clock());
+#endif
+}
+
+
+static void
+fct_tick__cpu(fct_tick_t *tick)
+{
+#if defined(FCT_CLOCK_GETTIME) && defined(CLOCK_PROCESS_CPUTIME_ID)
+    fct_tick__from_clock_id(tick, CLOCK_PROCESS_CPUTIME_ID);
+#else
+    fct_tick__from_clock(tick, clock());
+#endif
+}
+
+
+static void
+fct_tick__thread(fct_tick_t *tick)
+{
+#if defined(FCT_CLOCK_GETTIME) && defined(CLOCK_THREAD_CPUTIME_ID)
+    fct_tick__from_clock_id(tick, CLOCK_THREAD_CPUTIME_ID);
+#else
+    fct_tick__cpu(tick);
+#endif
+}
+
+
 typedef struct _fct_timer_t fct_timer_t;
 struct _fct_timer_t
 {
-    clock_t start;
-    clock_t stop;
+    fct_tick_t start;
+    fct_tick_t cpu_start;
+    fct_tick_t thread_start;
+    /* In seconds, set when the timer stops. */
     double duration;
+    double cpu_duration;
+    double thread_duration;
 };
 
 
@@ -649,20 +1183,27 @@ static void
 fct_timer__start(fct_timer_t *timer)
 {
     FCT_ASSERT(timer != NULL);
-    timer->start = clock();
+    fct_tick__cpu(&(timer->cpu_start));
+    fct_tick__thread(&(timer->thread_start));
+    fct_tick__wall(&(timer->start));
 }
 
 
 static void
 fct_timer__stop(fct_timer_t *timer)
 {
+    fct_tick_t stop;
     FCT_ASSERT(timer != NULL);
-    timer->stop = clock();
-    timer->duration = (double) (timer->stop - timer->start) / CLOCKS_PER_SEC;
+    fct_tick__wall(&stop);
+    timer->duration = fct_tick__diff(&stop, &(timer->start));
+    fct_tick__thread(&stop);
+    timer->thread_duration = fct_tick__diff(&stop, &(timer->thread_start));
+    fct_tick__cpu(&stop);
+    timer->cpu_duration = fct_tick__diff(&stop, &(timer->cpu_start));
 }
 
 
-/* Returns the time in seconds. */
+/* Returns the wall clock time in seconds. */
 static double
 fct_timer__duration(fct_timer_t const *timer)
 {
@@ -671,2519 +1212,7445 @@ fct_timer__duration(fct_timer_t const *timer)
 }
 
 
+/* Returns the CPU time of the process in seconds, so with other
+threads busy it can be more than the wall clock time. */
+#define fct_timer__cpu_duration(_TIMER_)     ((_TIMER_)->cpu_duration)
+
+/* Returns the CPU time of the thread that ran the timer, in seconds. */
+#define fct_timer__thread_duration(_TIMER_)  ((_TIMER_)->thread_duration)
+
+
 /*
 --------------------------------------------------------
-GENERIC LIST
+PERF COUNTERS
 --------------------------------------------------------
+With FCT_CONF_PERF on Linux, each test body and each timed batch of a
+benchmark is wrapped in hardware counters from perf_event_open: the
+cycles, the instructions, the branch misses, and the L1 data and last
+level cache misses. They count the thread that runs the test, in user
+space. Each thread opens its counters the first time, and a forked
+worker opens its own. The counters are one group led by the cycles, so
+they are on the CPU together and read at once. When the kernel has to
+share the CPU's counters the counts are scaled up to the time the group
+was enabled, and a group that never got on the CPU is not read. A
+counter the kernel will not give us, say in a virtual machine or under
+a strict perf_event_paranoid, is left out, and without the cycles the
+tests are only timed.
 */
 
-/* For now we will just keep it at a linear growth rate. */
-#define FCT_LIST_GROWTH_FACTOR   2
-
-/* Starting size for the list, to keep it simple we will start
-at a reasonable size. */
-#define FCT_LIST_DEFAULT_START_SZ      8
+enum
+{
+    FCT_PERF_CYCLES =0,
+    FCT_PERF_INSTRUCTIONS,
+    FCT_PERF_BRANCH_MISSES,
+    FCT_PERF_L1D_MISSES,
+    FCT_PERF_LLC_MISSES,
+    FCT_PERF_NUM
+};
 
-/* Helper macros for quickly iterating through a list. You should be able
-to do something like,
+/* As the loggers show them. */
+static char const *fct_perf_names[FCT_PERF_NUM] =
+{
+    "cycles",
+    "instructions",
+    "branch_misses",
+    "l1d_misses",
+    "llc_misses"
+};
 
-  FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, my_list)
-  {
-     fct_logger__on_blah(logger);
-  }
-  FCT_NLIST_FOREACH_END();
+typedef struct _fct_perf_t fct_perf_t;
+struct _fct_perf_t
+{
+    /* A bit for each counter that was read. */
+    unsigned int mask;
+    /* The counts so far, and the readings when last started. */
+    double counts[FCT_PERF_NUM];
+    double start[FCT_PERF_NUM];
+    /* How long the group was enabled, and on the CPU, when last started.
+    Those are only good if it is_started. */
+    double start_enabled;
+    double start_running;
+    nbool_t is_started;
+};
 
-*/
-#define FCT_NLIST_FOREACH_BGN(Type, Var, List)\
-{\
-   if ( List != NULL ) {\
-      size_t item_i##Var;\
-      size_t num_items##Var = fct_nlist__size(List);\
-      for( item_i##Var =0; item_i##Var != num_items##Var; ++item_i##Var )\
-      {\
-         Type Var = (Type) fct_nlist__at((List), item_i##Var);
+#define fct_perf__is_read(_PERF_, _CNTR_) \
+    ((((_PERF_)->mask) >> (_CNTR_)) & 1U)
 
-#define FCT_NLIST_FOREACH_END() }}}
 
-/* Used to manage a list of loggers. This works mostly like
-the STL vector, where the array grows as more items are
-appended. */
-typedef struct _fct_nlist_t fct_nlist_t;
-struct _fct_nlist_t
+static void
+fct_perf__init(fct_perf_t *perf)
 {
-    /* Item's are stored as pointers to void. */
-    void **itm_list;
+    FCT_ASSERT( perf != NULL );
+    memset(perf, 0, sizeof(fct_perf_t));
+}
 
-    /* Indicates the number of element's in the array. */
-    size_t avail_itm_num;
 
-    /* Indicates the number of actually elements in the array. */
-    size_t used_itm_num;
-};
-typedef void (*fct_nlist_on_del_t)(void*);
+#if defined(FCT_PERF)
+/* This thread's counters, -1 where there is none. They belong to the
+process that opened them. */
+static FCT_TLS int fct_perf_fds[FCT_PERF_NUM];
+static FCT_TLS pid_t fct_perf_pid =0;
+
+#if defined(PERF_FLAG_FD_CLOEXEC)
+#    define FCT_PERF_FLAGS PERF_FLAG_FD_CLOEXEC
+#else
+#    define FCT_PERF_FLAGS 0UL
+#endif /* PERF_FLAG_FD_CLOEXEC */
 
 
-/* Clears the contents of the list, and sets the list count to 0. The
-actual count remains unchanged. If on_del is supplied it is executed
-against each list element. */
+/* Opens a counter in the group led by GROUP_FD, or leading its own group
+if that is -1. */
+static int
+fct_perf__open(unsigned int type, unsigned long long config, int group_fd)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP
+                       | PERF_FORMAT_TOTAL_TIME_ENABLED
+                       | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(__NR_perf_event_open,
+                        &attr,
+                        0,
+                        -1,
+                        group_fd,
+                        FCT_PERF_FLAGS);
+}
+
+
+/* Closes this thread's counters, if it has any. A thread of the pool
+calls it on its way out. */
 static void
-fct_nlist__clear(fct_nlist_t *list, fct_nlist_on_del_t on_del)
+fct_perf__close(void)
 {
-    size_t itm_i__ =0;
-    FCT_ASSERT( list != NULL );
-    if ( on_del != NULL )
+    int cntr_i =0;
+    for ( cntr_i =0; cntr_i != FCT_PERF_NUM; ++cntr_i )
     {
-        for ( itm_i__=0; itm_i__ != list->used_itm_num; ++itm_i__ )
+        if ( fct_perf_pid != 0 && fct_perf_fds[cntr_i] >= 0 )
         {
-            on_del(list->itm_list[itm_i__]);
+            close(fct_perf_fds[cntr_i]);
         }
+        fct_perf_fds[cntr_i] = -1;
     }
-    list->used_itm_num =0;
+    fct_perf_pid = 0;
 }
 
 
-/* If you used init, then close with final. This is useful for
-working with structures that live on the stack. */
-static void
-fct_nlist__final(fct_nlist_t *list, fct_nlist_on_del_t on_del)
+/* Returns the counters for this thread, opening them if need be. */
+static int const *
+fct_perf__fds(void)
 {
-    FCT_ASSERT( list != NULL );
-    fct_nlist__clear(list, on_del);
-    free(list->itm_list);
+    pid_t pid = getpid();
+    int lead_fd =-1;
+    if ( fct_perf_pid == pid )
+    {
+        return fct_perf_fds;
+    }
+    /* Those of our parent count our parent. */
+    fct_perf__close();
+    lead_fd = fct_perf__open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+    fct_perf_fds[FCT_PERF_CYCLES] = lead_fd;
+    /* The rest are read through the cycles, so are no use without them. */
+    if ( lead_fd >= 0 )
+    {
+        fct_perf_fds[FCT_PERF_INSTRUCTIONS] =
+            fct_perf__open(PERF_TYPE_HARDWARE,
+                           PERF_COUNT_HW_INSTRUCTIONS,
+                           lead_fd);
+        fct_perf_fds[FCT_PERF_BRANCH_MISSES] =
+            fct_perf__open(PERF_TYPE_HARDWARE,
+                           PERF_COUNT_HW_BRANCH_MISSES,
+                           lead_fd);
+        fct_perf_fds[FCT_PERF_L1D_MISSES] =
+            fct_perf__open(PERF_TYPE_HW_CACHE,
+                           PERF_COUNT_HW_CACHE_L1D
+                           | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                           | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+                           lead_fd);
+        fct_perf_fds[FCT_PERF_LLC_MISSES] =
+            fct_perf__open(PERF_TYPE_HARDWARE,
+                           PERF_COUNT_HW_CACHE_MISSES,
+                           lead_fd);
+    }
+    fct_perf_pid = pid;
+    return fct_perf_fds;
 }
 
 
-static int
-fct_nlist__init2(fct_nlist_t *list, size_t start_sz)
-{
-    FCT_ASSERT( list != NULL );
-    if ( start_sz == 0 )
+/* Reads the group into VALUES, a count for each counter that is open,
+with how long it was ENABLED and RUNNING on the CPU. Returns FCT_FALSE
+if it can not. */
+static nbool_t
+fct_perf__read(int const *fds,
+               double *values,
+               double *enabled,
+               double *running)
+{
+    /* The number of counters, the two times, then a count for each
+    counter in the order they where opened. */
+    unsigned long long buf[3 + FCT_PERF_NUM];
+    ssize_t len =0;
+    size_t val_i =0;
+    int cntr_i =0;
+    if ( fds[FCT_PERF_CYCLES] < 0 )
     {
-        list->itm_list = NULL;
+        return FCT_FALSE;
     }
-    else
+    len = read(fds[FCT_PERF_CYCLES], buf, sizeof(buf));
+    if ( len < (ssize_t)(3 * sizeof(buf[0]))
+         || (size_t)len < (3 + (size_t)buf[0]) * sizeof(buf[0]) )
     {
-        list->itm_list = (void**)malloc(sizeof(void*)*start_sz);
-        if ( list->itm_list == NULL )
+        return FCT_FALSE;
+    }
+    *enabled = (double)buf[1];
+    *running = (double)buf[2];
+    for ( cntr_i =0; cntr_i != FCT_PERF_NUM; ++cntr_i )
+    {
+        if ( fds[cntr_i] >= 0 && val_i < (size_t)buf[0] )
         {
-            return 0;
+            values[cntr_i] = (double)buf[3 + val_i];
+            ++val_i;
         }
     }
-    /* If these are both 0, then they are equal and that means
-    that the first append operation will allocate memory. The beauty
-    here is that if the list remains empty, then we save a malloc.
-    Empty lists are relatively common in FCT (consider an error list). */
-    list->avail_itm_num = start_sz;
-    list->used_itm_num =0;
-    return 1;
+    return FCT_TRUE;
 }
+#endif /* FCT_PERF */
 
 
-/* Initializes a list. Useful for populating existing structures.
-Returns 0 if there was an error allocating memory. Returns 1 otherwise. */
-#define fct_nlist__init(_LIST_PTR_) \
-   (fct_nlist__init2((_LIST_PTR_), FCT_LIST_DEFAULT_START_SZ))
+static void
+fct_perf__start(fct_perf_t *perf)
+{
+#if defined(FCT_PERF)
+    perf->is_started = fct_perf__read(fct_perf__fds(),
+                                      perf->start,
+                                      &(perf->start_enabled),
+                                      &(perf->start_running));
+#else
+    fct_unused(perf);
+#endif /* FCT_PERF */
+}
 
 
-/* Returns the number of elements within the list. */
-static size_t
-fct_nlist__size(fct_nlist_t const *list)
-{
-    FCT_ASSERT( list != NULL );
-    return list->used_itm_num;
+/* Adds what was counted since the start, scaled up to the time the group
+was enabled if it had to share the CPU's counters. It may be started and
+stopped again, to add up several runs. */
+static void
+fct_perf__stop(fct_perf_t *perf)
+{
+#if defined(FCT_PERF)
+    int const *fds = fct_perf__fds();
+    double now[FCT_PERF_NUM];
+    double enabled =0.0;
+    double running =0.0;
+    double scale =0.0;
+    int cntr_i =0;
+    if ( !perf->is_started
+         || !fct_perf__read(fds, now, &enabled, &running) )
+    {
+        return;
+    }
+    perf->is_started = FCT_FALSE;
+    running -= perf->start_running;
+    enabled -= perf->start_enabled;
+    /* Never on the CPU, so nothing was counted. */
+    if ( running <= 0.0 )
+    {
+        return;
+    }
+    scale = enabled / running;
+    for ( cntr_i =0; cntr_i != FCT_PERF_NUM; ++cntr_i )
+    {
+        if ( fds[cntr_i] >= 0 )
+        {
+            perf->counts[cntr_i] += (now[cntr_i] - perf->start[cntr_i])
+                                    * scale;
+            perf->mask |= 1U << cntr_i;
+        }
+    }
+#else
+    fct_unused(perf);
+#endif /* FCT_PERF */
 }
 
 
-/* Returns the item at idx, asserts otherwise. */
-static void*
-fct_nlist__at(fct_nlist_t const *list, size_t idx)
-{
-    FCT_ASSERT( list != NULL );
-    FCT_ASSERT( idx < list->used_itm_num );
-    return list->itm_list[idx];
+/* Writes the counts as text for --jobs, and reads them back. */
+static void
+fct_perf__to_str(fct_perf_t const *perf, char *buf, size_t len)
+{
+    fct_snprintf(buf, len, "%u %.17g %.17g %.17g %.17g %.17g",
+                 perf->mask,
+                 perf->counts[0],
+                 perf->counts[1],
+                 perf->counts[2],
+                 perf->counts[3],
+                 perf->counts[4]);
 }
 
 
 static void
-fct_nlist__append(fct_nlist_t *list, void *itm)
+fct_perf__from_str(fct_perf_t *perf, char const *str)
 {
-    FCT_ASSERT( list != NULL );
-    /* If we ran out of room, then the last increment should be equal to the
-    available space, in this case we need to grow a little more. If this
-    list started as size 0, then we should encounter the same effect as
-    "running out of room." */
-    if ( list->used_itm_num == list->avail_itm_num )
+    char *end =NULL;
+    int cntr_i =0;
+    fct_perf__init(perf);
+    perf->mask = (unsigned int)strtoul(str, &end, 10);
+    for ( cntr_i =0; cntr_i != FCT_PERF_NUM; ++cntr_i )
     {
-        /* Use multiple and add, since the avail_itm_num could be 0. */
-        list->avail_itm_num = list->avail_itm_num*FCT_LIST_GROWTH_FACTOR+\
-                              FCT_LIST_GROWTH_FACTOR;
-        list->itm_list = (void**)realloc(
-                             list->itm_list, sizeof(void*)*list->avail_itm_num
-                         );
-        FCT_ASSERT( list->itm_list != NULL && "memory check");
+        perf->counts[cntr_i] = strtod(end, &end);
     }
-
-    list->itm_list[list->used_itm_num] = itm;
-    ++(list->used_itm_num);
 }
 
 
-
 /*
------------------------------------------------------------
-A SINGLE CHECK
------------------------------------------------------------
-This defines a single check. It indicates what the check was,
-and where it occurred. A "Test" object will have-a bunch
-of "checks".
+--------------------------------------------------------
+ALLOCATION COUNTS
+--------------------------------------------------------
+With FCT_CONF_ALLOC each test body counts its calls to malloc, calloc
+and realloc, the bytes it asked for, and the most bytes it had live at
+once. The program has to be linked with
+
+    -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free
+
+so the calls come to the wrappers below, and the real ones are reached
+as __real_malloc and so on. Only calls from the objects linked that way
+are seen, not those made inside shared libraries, so C++ new is missed.
+A test counts the thread that runs it. The live bytes are as the C
+library sizes the blocks, and a block from before the test that it
+frees takes them below zero, so the peak is what was live on top of the
+start. Define FCT_CONF_ALLOC in each file that includes fct.h, the
+wrappers are weak, so any one of them will do.
 */
 
-struct _fctchk_t
+typedef struct _fct_alloc_t fct_alloc_t;
+struct _fct_alloc_t
 {
-    /* This string that represents the condition. */
-    char cndtn[FCT_MAX_LOG_LINE];
-
-    /* These indicate where the condition occurred. */
-    char file[FCT_MAX_LOG_LINE];
-
-    int lineno;
-
-    nbool_t is_pass;
-
-    /* This is a message that we can "format into", if
-    no format string is specified this should be
-    equivalent to the cntdn. */
-    char msg[FCT_MAX_LOG_LINE];
+    size_t num_allocs;
+    size_t num_bytes;
+    size_t peak_bytes;
+    long live_bytes;
 };
 
-#define fctchk__is_pass(_CHK_) ((_CHK_)->is_pass)
-#define fctchk__file(_CHK_)    ((_CHK_)->file)
-#define fctchk__lineno(_CHK_)  ((_CHK_)->lineno)
-#define fctchk__cndtn(_CHK_)   ((_CHK_)->cndtn)
-#define fctchk__msg(_CHK_)     ((_CHK_)->msg)
 
-static fctchk_t*
-fctchk_new(int is_pass,
-           char const *cndtn,
-           char const *file,
-           int lineno,
-           char const *format,
-           va_list args)
+static void
+fct_alloc__init(fct_alloc_t *alloc)
 {
-    fctchk_t *chk = NULL;
-
-    FCT_ASSERT( cndtn != NULL );
-    FCT_ASSERT( file != NULL );
-    FCT_ASSERT( lineno > 0 );
+    FCT_ASSERT( alloc != NULL );
+    memset(alloc, 0, sizeof(fct_alloc_t));
+}
 
-    chk = (fctchk_t*)calloc(1, sizeof(fctchk_t));
-    if ( chk == NULL )
-    {
-        return NULL;
-    }
 
-    fctstr_safe_cpy(chk->cndtn, cndtn, FCT_MAX_LOG_LINE);
-    fctstr_safe_cpy(chk->file, file, FCT_MAX_LOG_LINE);
-    chk->lineno = lineno;
+#if defined(FCT_ALLOC)
+/* What this thread is counting into, if anything. */
+FCT_TLS fct_alloc_t *fct_alloc_curr __attribute__((weak)) =NULL;
 
-    chk->is_pass =is_pass;
 
-    if ( format != NULL )
+static void
+fct_alloc__add(fct_alloc_t *alloc, void *ptr, size_t sz)
+{
+    if ( alloc == NULL || ptr == NULL )
     {
-        fct_vsnprintf(chk->msg, FCT_MAX_LOG_LINE, format, args);
+        return;
     }
-    else
+    ++(alloc->num_allocs);
+    alloc->num_bytes += sz;
+    alloc->live_bytes += (long)malloc_usable_size(ptr);
+    if ( alloc->live_bytes > 0
+            && (size_t)alloc->live_bytes > alloc->peak_bytes )
     {
-        /* Default to make the condition be the message, if there was no format
-        specified. */
-        fctstr_safe_cpy(chk->msg, cndtn, FCT_MAX_LOG_LINE);
+        alloc->peak_bytes = (size_t)alloc->live_bytes;
     }
-
-    return chk;
 }
 
 
-/* Cleans up a "check" object. If the `chk` is NULL, this function does
-nothing. */
 static void
-fctchk__del(fctchk_t *chk)
+fct_alloc__sub(fct_alloc_t *alloc, void *ptr)
 {
-    if ( chk == NULL )
+    if ( alloc == NULL || ptr == NULL )
     {
         return;
     }
-    free( chk );
+    alloc->live_bytes -= (long)malloc_usable_size(ptr);
 }
 
 
-/*
------------------------------------------------------------
-A TEST
------------------------------------------------------------
-A suite will have-a list of tests. Where each test will have-a
-list of failed and passed checks.
-*/
-
-struct _fct_test_t
+__attribute__((weak)) void *
+__wrap_malloc(size_t sz)
 {
-    /* List of failed and passed "checks" (fctchk_t). Two separate
-    lists make it faster to determine how many checks passed and how
-    many checks failed. */
-    fct_nlist_t failed_chks;
-    fct_nlist_t passed_chks;
-
-    /* To store the test run time */
-    fct_timer_t timer;
+    void *ptr = __real_malloc(sz);
+    fct_alloc__add(fct_alloc_curr, ptr, sz);
+    return ptr;
+}
 
-    /* The name of the test case. */
-    char name[FCT_MAX_NAME];
-};
 
-#define fct_test__name(_TEST_) ((_TEST_)->name)
+__attribute__((weak)) void *
+__wrap_calloc(size_t num, size_t sz)
+{
+    void *ptr = __real_calloc(num, sz);
+    fct_alloc__add(fct_alloc_curr, ptr, num*sz);
+    return ptr;
+}
 
-/* Clears the failed tests ... partly for internal testing. */
-#define fct_test__clear_failed(test) \
-    fct_nlist__clear(test->failed_chks, (fct_nlist_on_del_t)fctchk__del);\
- 
 
-static void
-fct_test__del(fct_test_t *test)
+/* Counts as freeing the old block and allocating the new one. */
+__attribute__((weak)) void *
+__wrap_realloc(void *ptr, size_t sz)
 {
-    if (test == NULL )
+    fct_alloc_t *alloc = fct_alloc_curr;
+    size_t old_sz = (ptr == NULL) ? 0 : malloc_usable_size(ptr);
+    void *new_ptr = __real_realloc(ptr, sz);
+    if ( alloc != NULL && (new_ptr != NULL || sz == 0) )
     {
-        return;
+        alloc->live_bytes -= (long)old_sz;
+        fct_alloc__add(alloc, new_ptr, sz);
     }
-    fct_nlist__final(&(test->passed_chks), (fct_nlist_on_del_t)fctchk__del);
-    fct_nlist__final(&(test->failed_chks), (fct_nlist_on_del_t)fctchk__del);
-    free(test);
+    return new_ptr;
 }
 
 
-static fct_test_t*
-fct_test_new(char const *name)
+__attribute__((weak)) void
+__wrap_free(void *ptr)
 {
-    nbool_t ok =FCT_FALSE;
-    fct_test_t *test =NULL;
-
-    test = (fct_test_t*)malloc(sizeof(fct_test_t));
-    if ( test == NULL )
-    {
-        return NULL;
-    }
+    fct_alloc__sub(fct_alloc_curr, ptr);
+    __real_free(ptr);
+}
+#endif /* FCT_ALLOC */
 
-    fctstr_safe_cpy(test->name, name, FCT_MAX_NAME);
 
-    /* Failures are an exception, so lets not allocate up
-    the list until we need to. */
-    fct_nlist__init2(&(test->failed_chks), 0);
-    if (!fct_nlist__init(&(test->passed_chks)))
-    {
-        ok =FCT_FALSE;
-        goto finally;
-    }
+/* It may be started and stopped again, to add up several runs. */
+static void
+fct_alloc__start(fct_alloc_t *alloc)
+{
+#if defined(FCT_ALLOC)
+    fct_alloc_curr = alloc;
+#else
+    fct_unused(alloc);
+#endif /* FCT_ALLOC */
+}
 
-    fct_timer__init(&(test->timer));
 
-    ok =FCT_TRUE;
-finally:
-    if ( !ok )
-    {
-        fct_test__del(test);
-        test =NULL;
-    }
-    return test;
+static void
+fct_alloc__stop(fct_alloc_t *alloc)
+{
+    fct_unused(alloc);
+#if defined(FCT_ALLOC)
+    fct_alloc_curr = NULL;
+#endif /* FCT_ALLOC */
 }
 
 
+/* Writes the counts as text for --jobs, and reads them back. */
 static void
-fct_test__start_timer(fct_test_t *test)
+fct_alloc__to_str(fct_alloc_t const *alloc, char *buf, size_t len)
 {
-    FCT_ASSERT( test != NULL );
-    fct_timer__start(&(test->timer));
+    fct_snprintf(buf, len, "%lu %lu %lu %ld",
+                 (unsigned long)alloc->num_allocs,
+                 (unsigned long)alloc->num_bytes,
+                 (unsigned long)alloc->peak_bytes,
+                 alloc->live_bytes);
 }
 
 
 static void
-fct_test__stop_timer(fct_test_t *test)
+fct_alloc__from_str(fct_alloc_t *alloc, char const *str)
 {
-    FCT_ASSERT( test != NULL );
-    fct_timer__stop(&(test->timer));
+    char *end =NULL;
+    alloc->num_allocs = (size_t)strtoul(str, &end, 10);
+    alloc->num_bytes = (size_t)strtoul(end, &end, 10);
+    alloc->peak_bytes = (size_t)strtoul(end, &end, 10);
+    alloc->live_bytes = strtol(end, &end, 10);
 }
 
 
-static double
-fct_test__duration(fct_test_t const *test)
+/*
+--------------------------------------------------------
+RESOURCE USAGE
+--------------------------------------------------------
+Each test body takes the difference in getrusage across it: the user
+and system CPU time, how much the peak resident set grew, the minor and
+major page faults, and the voluntary and involuntary context switches.
+A suite adds up its tests. With FCT_CONF_THREADS, on Linux, a test only
+counts its own thread, since the others are running other suites.
+Elsewhere --threads warns and counts the whole process. The peak
+resident set is for the whole process, and only ever grows.
+*/
+
+#if defined(FCT_RUSAGE) && defined(FCT_THREADS) && defined(RUSAGE_THREAD)
+#   define FCT_RUSAGE_WHO  RUSAGE_THREAD
+#elif defined(FCT_RUSAGE) && defined(FCT_THREADS) && defined(__linux__)
+/* glibc only declares RUSAGE_THREAD with _GNU_SOURCE. */
+#   define FCT_RUSAGE_WHO  1
+#else
+#   define FCT_RUSAGE_WHO  RUSAGE_SELF
+#endif
+
+typedef struct _fct_rusage_t fct_rusage_t;
+struct _fct_rusage_t
+{
+    /* In seconds. */
+    double user_time;
+    double sys_time;
+    /* In kilobytes. */
+    long maxrss_growth;
+    long minor_faults;
+    long major_faults;
+    long vol_switches;
+    long invol_switches;
+#if defined(FCT_RUSAGE)
+    /* From when last started. */
+    struct rusage start;
+#endif /* FCT_RUSAGE */
+};
+
+
+static void
+fct_rusage__init(fct_rusage_t *rusage)
 {
-    FCT_ASSERT( test != NULL );
-    return fct_timer__duration(&(test->timer));
+    FCT_ASSERT( rusage != NULL );
+    memset(rusage, 0, sizeof(fct_rusage_t));
 }
 
 
-static nbool_t
-fct_test__is_pass(fct_test_t const *test)
+static void
+fct_rusage__start(fct_rusage_t *rusage)
 {
-    FCT_ASSERT( test != NULL );
-    return fct_nlist__size(&(test->failed_chks)) == 0;
+#if defined(FCT_RUSAGE)
+    (void)getrusage(FCT_RUSAGE_WHO, &(rusage->start));
+#else
+    fct_unused(rusage);
+#endif /* FCT_RUSAGE */
 }
 
 
-static void
-fct_test__add(fct_test_t *test, fctchk_t *chk)
+#if defined(FCT_RUSAGE)
+static double
+fct_rusage__tv_diff(struct timeval const *stop, struct timeval const *start)
 {
+    return (double)(stop->tv_sec - start->tv_sec)
+           + (double)(stop->tv_usec - start->tv_usec) / 1000000.0;
+}
+#endif /* FCT_RUSAGE */
 
-    FCT_ASSERT( test != NULL );
-    FCT_ASSERT( chk != NULL );
 
-    if ( fctchk__is_pass(chk) )
-    {
-        fct_nlist__append(&(test->passed_chks), (void*)chk);
-    }
-    else
+/* Adds what was used since the start. It may be started and stopped
+again, to add up several runs. */
+static void
+fct_rusage__stop(fct_rusage_t *rusage)
+{
+#if defined(FCT_RUSAGE)
+    struct rusage stop;
+    struct rusage const *start = &(rusage->start);
+    if ( getrusage(FCT_RUSAGE_WHO, &stop) != 0 )
     {
-        fct_nlist__append(&(test->failed_chks), (void*)chk);
+        return;
     }
+    rusage->user_time += fct_rusage__tv_diff(&(stop.ru_utime),
+                                             &(start->ru_utime));
+    rusage->sys_time += fct_rusage__tv_diff(&(stop.ru_stime),
+                                            &(start->ru_stime));
+#if defined(__APPLE__)
+    /* In bytes here. */
+    rusage->maxrss_growth += (stop.ru_maxrss - start->ru_maxrss) / 1024;
+#else
+    rusage->maxrss_growth += stop.ru_maxrss - start->ru_maxrss;
+#endif /* __APPLE__ */
+    rusage->minor_faults += stop.ru_minflt - start->ru_minflt;
+    rusage->major_faults += stop.ru_majflt - start->ru_majflt;
+    rusage->vol_switches += stop.ru_nvcsw - start->ru_nvcsw;
+    rusage->invol_switches += stop.ru_nivcsw - start->ru_nivcsw;
+#else
+    fct_unused(rusage);
+#endif /* FCT_RUSAGE */
 }
 
-/* Returns the number of checks made throughout the test. */
-static size_t
-fct_test__chk_cnt(fct_test_t const *test)
-{
-    FCT_ASSERT( test != NULL );
-    return fct_nlist__size(&(test->failed_chks)) \
-           + fct_nlist__size(&(test->passed_chks));
+
+/* For the suite to add up its tests. */
+static void
+fct_rusage__add(fct_rusage_t *rusage, fct_rusage_t const *other)
+{
+    rusage->user_time += other->user_time;
+    rusage->sys_time += other->sys_time;
+    rusage->maxrss_growth += other->maxrss_growth;
+    rusage->minor_faults += other->minor_faults;
+    rusage->major_faults += other->major_faults;
+    rusage->vol_switches += other->vol_switches;
+    rusage->invol_switches += other->invol_switches;
+}
+
+
+/* Writes the usage as text for --jobs, and reads it back. */
+static void
+fct_rusage__to_str(fct_rusage_t const *rusage, char *buf, size_t len)
+{
+    fct_snprintf(buf, len, "%.17g %.17g %ld %ld %ld %ld %ld",
+                 rusage->user_time,
+                 rusage->sys_time,
+                 rusage->maxrss_growth,
+                 rusage->minor_faults,
+                 rusage->major_faults,
+                 rusage->vol_switches,
+                 rusage->invol_switches);
+}
+
+
+static void
+fct_rusage__from_str(fct_rusage_t *rusage, char const *str)
+{
+    char *end =NULL;
+    rusage->user_time = strtod(str, &end);
+    rusage->sys_time = strtod(end, &end);
+    rusage->maxrss_growth = strtol(end, &end, 10);
+    rusage->minor_faults = strtol(end, &end, 10);
+    rusage->major_faults = strtol(end, &end, 10);
+    rusage->vol_switches = strtol(end, &end, 10);
+    rusage->invol_switches = strtol(end, &end, 10);
 }
 
 
 /*
------------------------------------------------------------
-TEST SUITE (TS)
------------------------------------------------------------
+--------------------------------------------------------
+GENERIC LIST
+--------------------------------------------------------
 */
 
+/* For now we will just keep it at a linear growth rate. */
+#define FCT_LIST_GROWTH_FACTOR   2
 
-/* The different types of 'modes' that a test suite can be in.
+/* Starting size for the list, to keep it simple we will start
+at a reasonable size. */
+#define FCT_LIST_DEFAULT_START_SZ      8
 
-While the test suite is iterating through all the tests, its "State"
-can change from "setup mode", to "test mode" to "tear down" mode.
-These help to indicate what mode are currently in. Think of it as a
-basic FSM.
+/* Helper macros for quickly iterating through a list. You should be able
+to do something like,
 
-            if the count was 0                                 end
-           +--------->---------------------> ending_mode-----+-+
-           |                                       ^         |
-           ^                                       |         ^
-start      |                              [if no more tests] |
-  |        |                                       |         |
-  +-count_mode -> setup_mode -> test_mode -> teardown_mode->-+
-                   |  ^                           |          |
-                   |  +-----------<---------------+          |
-                   +----------->---[if fct_req fails]--------+
+  FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, my_list)
+  {
+     fct_logger__on_blah(logger);
+  }
+  FCT_NLIST_FOREACH_END();
 
 */
-enum ts_mode
-{
-    ts_mode_cnt,         /* To setup when done counting. */
-    ts_mode_setup,       /* To test when done setup. */
-    ts_mode_teardown,    /* To ending mode, when no more tests. */
-    ts_mode_test,        /* To tear down mode. */
-    ts_mode_ending,      /* To ... */
-    ts_mode_end,         /* .. The End. */
-    ts_mode_abort        /* Abort */
-};
-
-/* Types of states the test could be in. */
-typedef enum
-{
-    fct_test_status_SUCCESS,
-    fct_test_status_FAILURE
-} fct_test_status;
+#define FCT_NLIST_FOREACH_BGN(Type, Var, List)\
+{\
+   if ( List != NULL ) {\
+      size_t item_i##Var;\
+      size_t num_items##Var = fct_nlist__size(List);\
+      for( item_i##Var =0; item_i##Var != num_items##Var; ++item_i##Var )\
+      {\
+         Type Var = (Type) fct_nlist__at((List), item_i##Var);
 
+#define FCT_NLIST_FOREACH_END() }}}
 
-struct _fct_ts_t
+/* Used to manage a list of loggers. This works mostly like
+the STL vector, where the array grows as more items are
+appended. */
+typedef struct _fct_nlist_t fct_nlist_t;
+struct _fct_nlist_t
 {
-    /* For counting our 'current' test number, and the total number of
-    tests. */
-    int  curr_test_num;
-    int  total_test_num;
-
-    /* Keeps track of the current state of the object while it is walking
-    through its "FSM" */
-    enum ts_mode mode;
+    /* Item's are stored as pointers to void. */
+    void **itm_list;
 
-    /* The name of the test suite. */
-    char name[FCT_MAX_NAME];
+    /* Indicates the number of element's in the array. */
+    size_t avail_itm_num;
 
-    /* List of tests that where executed within the test suite. */
-    fct_nlist_t test_list;
+    /* Indicates the number of actually elements in the array. */
+    size_t used_itm_num;
 };
+typedef void (*fct_nlist_on_del_t)(void*);
 
 
-#define fct_ts__is_setup_mode(ts)     ((ts)->mode == ts_mode_setup)
-#define fct_ts__is_teardown_mode(ts)  ((ts)->mode == ts_mode_teardown)
-#define fct_ts__is_test_mode(ts)      ((ts)->mode == ts_mode_test)
-#define fct_ts__is_ending_mode(ts)    ((ts)->mode == ts_mode_ending)
-#define fct_ts__is_end(ts)            ((ts)->mode == ts_mode_end)
-#define fct_ts__is_cnt_mode(ts)       ((ts)->mode == ts_mode_cnt)
-#define fct_ts__is_abort_mode(ts)     ((ts)->mode == ts_mode_abort)
-
-/* This cndtn is set when we have iterated through all the tests, and
-there was nothing more to do. */
-#define fct_ts__ending(ts)          ((ts)->mode = ts_mode_ending)
-
-/* Flag a test suite as complete. It will no longer accept any more tests. */
-#define fct_ts__end(ts)  ((ts)->mode = ts_mode_end)
-
-#define fct_ts__name(ts)              ((ts)->name)
-
-
+/* Clears the contents of the list, and sets the list count to 0. The
+actual count remains unchanged. If on_del is supplied it is executed
+against each list element. */
 static void
-fct_ts__del(fct_ts_t *ts)
+fct_nlist__clear(fct_nlist_t *list, fct_nlist_on_del_t on_del)
 {
-    if ( ts == NULL )
+    size_t itm_i__ =0;
+    FCT_ASSERT( list != NULL );
+    if ( on_del != NULL )
     {
-        return;
+        for ( itm_i__=0; itm_i__ != list->used_itm_num; ++itm_i__ )
+        {
+            on_del(list->itm_list[itm_i__]);
+        }
     }
-    fct_nlist__final(&(ts->test_list), (fct_nlist_on_del_t)fct_test__del);
-    free(ts);
+    list->used_itm_num =0;
 }
 
-static fct_ts_t *
-fct_ts_new(char const *name)
+
+/* If you used init, then close with final. This is useful for
+working with structures that live on the stack. */
+static void
+fct_nlist__final(fct_nlist_t *list, fct_nlist_on_del_t on_del)
 {
-    fct_ts_t *ts =NULL;
-    ts = (fct_ts_t*)calloc(1, sizeof(fct_ts_t));
-    FCT_ASSERT( ts != NULL );
+    FCT_ASSERT( list != NULL );
+    fct_nlist__clear(list, on_del);
+    fct_free(list->itm_list);
+}
 
-    fctstr_safe_cpy(ts->name, name, FCT_MAX_NAME);
-    ts->mode = ts_mode_cnt;
-    fct_nlist__init(&(ts->test_list));
-    return ts;
+
+static int
+fct_nlist__init2(fct_nlist_t *list, size_t start_sz)
+{
+    FCT_ASSERT( list != NULL );
+    if ( start_sz == 0 )
+    {
+        list->itm_list = NULL;
+    }
+    else
+    {
+        list->itm_list = (void**)fct_malloc(sizeof(void*)*start_sz);
+        if ( list->itm_list == NULL )
+        {
+            return 0;
+        }
+    }
+    /* If these are both 0, then they are equal and that means
+    that the first append operation will allocate memory. The beauty
+    here is that if the list remains empty, then we save a malloc.
+    Empty lists are relatively common in FCT (consider an error list). */
+    list->avail_itm_num = start_sz;
+    list->used_itm_num =0;
+    return 1;
 }
 
 
+/* Initializes a list. Useful for populating existing structures.
+Returns 0 if there was an error allocating memory. Returns 1 otherwise. */
+#define fct_nlist__init(_LIST_PTR_) \
+   (fct_nlist__init2((_LIST_PTR_), FCT_LIST_DEFAULT_START_SZ))
+
 
-static nbool_t
-fct_ts__is_more_tests(fct_ts_t const *ts)
+/* Returns the number of elements within the list. */
+static size_t
+fct_nlist__size(fct_nlist_t const *list)
 {
-    FCT_ASSERT( ts != NULL );
-    FCT_ASSERT( !fct_ts__is_end(ts) );
-    return ts->curr_test_num < ts->total_test_num;
+    FCT_ASSERT( list != NULL );
+    return list->used_itm_num;
 }
 
 
-/* Indicates that we have started a test case. */
-static void
-fct_ts__test_begin(fct_ts_t *ts)
+/* Returns the item at idx, asserts otherwise. */
+static void*
+fct_nlist__at(fct_nlist_t const *list, size_t idx)
 {
-    FCT_ASSERT( !fct_ts__is_end(ts) );
-    ++(ts->curr_test_num);
+    FCT_ASSERT( list != NULL );
+    FCT_ASSERT( idx < list->used_itm_num );
+    return list->itm_list[idx];
 }
 
 
-/* Takes OWNERSHIP of a test object, and warehouses it for later stat
-generation. */
 static void
-fct_ts__add_test(fct_ts_t *ts, fct_test_t *test)
+fct_nlist__append(fct_nlist_t *list, void *itm)
 {
-    FCT_ASSERT( ts != NULL && "invalid arg");
-    FCT_ASSERT( test != NULL && "invalid arg");
-    FCT_ASSERT( !fct_ts__is_end(ts) );
-    fct_nlist__append(&(ts->test_list), test);
+    FCT_ASSERT( list != NULL );
+    /* If we ran out of room, then the last increment should be equal to the
+    available space, in this case we need to grow a little more. If this
+    list started as size 0, then we should encounter the same effect as
+    "running out of room." */
+    if ( list->used_itm_num == list->avail_itm_num )
+    {
+        /* Use multiple and add, since the avail_itm_num could be 0. */
+        list->avail_itm_num = list->avail_itm_num*FCT_LIST_GROWTH_FACTOR+\
+                              FCT_LIST_GROWTH_FACTOR;
+        list->itm_list = (void**)fct_realloc(
+                             list->itm_list, sizeof(void*)*list->avail_itm_num
+                         );
+        FCT_ASSERT( list->itm_list != NULL && "memory check");
+    }
+
+    list->itm_list[list->used_itm_num] = itm;
+    ++(list->used_itm_num);
 }
 
 
-static void
-fct_ts__test_end(fct_ts_t *ts)
+/*
+-----------------------------------------------------------
+ARENA
+-----------------------------------------------------------
+Hands out memory by bumping a pointer through large blocks. Nothing is
+freed on its own, the blocks all go at once when the arena is finished.
+A test suite keeps one for its tests and checks. An arena is not thread
+safe.
+*/
+
+/* The size of a block, anything bigger gets a block of its own. */
+#define FCT_ARENA_BLK_SZ   8192
+
+/* Everything handed out is aligned for the most demanding of these. */
+typedef union _fct_arena_align_t
 {
-    FCT_ASSERT( ts != NULL );
-    /* After a test has completed, move to teardown mode. */
-    ts->mode = ts_mode_teardown;
-}
+    long l;
+    double d;
+    void *p;
+} fct_arena_align_t;
+
+typedef struct _fct_arena_blk_t fct_arena_blk_t;
+struct _fct_arena_blk_t
+{
+    fct_arena_blk_t *next;
+    size_t used;
+    size_t avail;
+    fct_arena_align_t data[1];
+};
+
+typedef struct _fct_arena_t fct_arena_t;
+struct _fct_arena_t
+{
+    /* The block we are taking from, followed by the full ones. */
+    fct_arena_blk_t *blks;
+};
 
 
-/* Increments the internal count by 1. */
 static void
-fct_ts__inc_total_test_num(fct_ts_t *ts)
+fct_arena__init(fct_arena_t *arena)
 {
-    FCT_ASSERT( ts != NULL );
-    FCT_ASSERT( fct_ts__is_cnt_mode(ts) );
-    FCT_ASSERT( !fct_ts__is_end(ts) );
-    ++(ts->total_test_num);
+    FCT_ASSERT( arena != NULL );
+    arena->blks = NULL;
 }
 
 
-/* Flags the end of the setup, which implies we are going to move into
-setup mode. You must be already in setup mode for this to work! */
+/* Frees every block, and so everything that was taken from the arena. */
 static void
-fct_ts__setup_end(fct_ts_t *ts)
+fct_arena__final(fct_arena_t *arena)
 {
-    if ( ts->mode != ts_mode_abort )
+    fct_arena_blk_t *blk =NULL;
+    fct_arena_blk_t *next =NULL;
+    FCT_ASSERT( arena != NULL );
+    for ( blk = arena->blks; blk != NULL; blk = next )
     {
-        ts->mode = ts_mode_test;
+        next = blk->next;
+        fct_free(blk);
     }
+    arena->blks = NULL;
 }
 
 
-static fct_test_t *
-fct_ts__make_abort_test(fct_ts_t *ts)
+/* Returns SZ bytes from the arena, or NULL if we ran out of memory. */
+static void *
+fct_arena__alloc(fct_arena_t *arena, size_t sz)
 {
-    char setup_testname[FCT_MAX_LOG_LINE+1] = {'\0'};
-    char const *suitename = fct_ts__name(ts);
-    fct_snprintf(setup_testname, FCT_MAX_LOG_LINE, "setup_%s", suitename);
-    return fct_test_new(setup_testname);
+    fct_arena_blk_t *blk =NULL;
+    void *ptr =NULL;
+    FCT_ASSERT( arena != NULL );
+    sz = (sz + sizeof(fct_arena_align_t) - 1)
+         / sizeof(fct_arena_align_t) * sizeof(fct_arena_align_t);
+    blk = arena->blks;
+    if ( blk == NULL || blk->avail - blk->used < sz )
+    {
+        size_t avail = (sz > FCT_ARENA_BLK_SZ) ? sz : FCT_ARENA_BLK_SZ;
+        blk = (fct_arena_blk_t*)fct_malloc(sizeof(fct_arena_blk_t) + avail);
+        if ( blk == NULL )
+        {
+            return NULL;
+        }
+        blk->used = 0;
+        blk->avail = avail;
+        /* A big one goes behind the current block, so we keep filling
+        that. */
+        if ( sz > FCT_ARENA_BLK_SZ && arena->blks != NULL )
+        {
+            blk->next = arena->blks->next;
+            arena->blks->next = blk;
+        }
+        else
+        {
+            blk->next = arena->blks;
+            arena->blks = blk;
+        }
+    }
+    ptr = (char*)(blk->data) + blk->used;
+    blk->used += sz;
+    return ptr;
 }
 
-/* Flags a pre-mature abort of a setup (like a failed fct_req). */
-static void
-fct_ts__setup_abort(fct_ts_t *ts)
-{
-    FCT_ASSERT( ts != NULL );
-    ts->mode = ts_mode_abort;
-}
 
-/* Flags the end of the teardown, which implies we are going to move
-into setup mode (for the next 'iteration'). */
-static void
-fct_ts__teardown_end(fct_ts_t *ts)
+/* Copies S into the arena, returns NULL if we ran out of memory. */
+static char *
+fct_arena__strdup(fct_arena_t *arena, char const *s)
 {
-    if ( ts->mode == ts_mode_abort )
+    size_t len =0;
+    char *dup =NULL;
+    FCT_ASSERT( s != NULL );
+    len = strlen(s) + 1;
+    dup = (char*)fct_arena__alloc(arena, len);
+    if ( dup != NULL )
     {
-        return; /* Because we are aborting . */
-    }
-    /* We have to decide if we should keep on testing by moving into tear down
-    mode or if we have reached the real end and should be moving into the
-    ending mode. */
-    if ( fct_ts__is_more_tests(ts) )
-    {
-        ts->mode = ts_mode_setup;
-    }
-    else
-    {
-        ts->mode = ts_mode_ending;
+        memcpy(dup, s, len);
     }
+    return dup;
 }
 
 
-/* Flags the end of the counting, and proceeding to the first setup.
-Consider the special case when a test suite has NO tests in it, in
-that case we will have a current count that is zero, in which case
-we can skip right to 'ending'. */
+
+/*
+-----------------------------------------------------------
+A SINGLE CHECK
+-----------------------------------------------------------
+This defines a single check. It indicates what the check was,
+and where it occurred. A "Test" object will have-a bunch
+of "checks".
+*/
+
+struct _fctchk_t
+{
+    /* This string that represents the condition. */
+    char const *cndtn;
+
+    /* These indicate where the condition occurred. */
+    char const *file;
+
+    int lineno;
+
+    nbool_t is_pass;
+
+    /* This is a message that we can "format into", if
+    no format string is specified this should be
+    equivalent to the cntdn. */
+    char const *msg;
+
+    /* The strings above are normally literals, and are only pointed at.
+    When they are not, they are copied into here, and this is freed with
+    the check. */
+    char *buf;
+
+    /* The arena the check, and its buf, came from. NULL if they are on
+    the heap. */
+    fct_arena_t *arena;
+};
+
+#define fctchk__is_pass(_CHK_) ((_CHK_)->is_pass)
+#define fctchk__file(_CHK_)    ((_CHK_)->file)
+#define fctchk__lineno(_CHK_)  ((_CHK_)->lineno)
+#define fctchk__cndtn(_CHK_)   ((_CHK_)->cndtn)
+#define fctchk__msg(_CHK_)     ((_CHK_)->msg)
+
+/* Fills in CHK, which the caller provides, with MSG taken as it is. The
+strings are pointed at, not copied, so they must outlive the check. */
 static void
-fct_ts__cnt_end(fct_ts_t *ts)
+fctchk__init_plain(fctchk_t *chk,
+                   int is_pass,
+                   char const *cndtn,
+                   char const *file,
+                   int lineno,
+                   char const *msg)
 {
-    FCT_ASSERT( ts != NULL );
-    FCT_ASSERT( fct_ts__is_cnt_mode(ts) );
-    FCT_ASSERT( !fct_ts__is_end(ts) );
-    if (ts->total_test_num == 0  )
+    FCT_ASSERT( chk != NULL );
+    FCT_ASSERT( cndtn != NULL );
+    FCT_ASSERT( file != NULL );
+    FCT_ASSERT( lineno > 0 );
+    FCT_ASSERT( msg != NULL );
+
+    chk->cndtn = cndtn;
+    chk->file = file;
+    chk->lineno = lineno;
+
+    chk->is_pass =is_pass;
+
+    chk->msg = msg;
+    chk->buf = NULL;
+}
+
+
+/* Copies the strings of CHK into its own buffer, so it no longer points
+at anything it does not own. Returns false if we ran out of memory. */
+static nbool_t
+fctchk__own(fctchk_t *chk)
+{
+    size_t cndtn_len =0;
+    size_t file_len =0;
+    size_t msg_len =0;
+    char *buf =NULL;
+    FCT_ASSERT( chk != NULL );
+    if ( chk->buf != NULL )
     {
-        ts->mode = ts_mode_ending;
+        return FCT_TRUE;
+    }
+    cndtn_len = strlen(chk->cndtn) + 1;
+    file_len = strlen(chk->file) + 1;
+    msg_len = strlen(chk->msg) + 1;
+    if ( chk->arena != NULL )
+    {
+        buf = (char*)fct_arena__alloc(chk->arena,
+                                      cndtn_len + file_len + msg_len);
     }
     else
     {
-        ts->mode = ts_mode_setup;
+        buf = (char*)fct_malloc(sizeof(char)*(cndtn_len + file_len + msg_len));
+    }
+    if ( buf == NULL )
+    {
+        return FCT_FALSE;
     }
+    memcpy(buf, chk->cndtn, cndtn_len);
+    memcpy(buf + cndtn_len, chk->file, file_len);
+    memcpy(buf + cndtn_len + file_len, chk->msg, msg_len);
+    chk->cndtn = buf;
+    chk->file = buf + cndtn_len;
+    chk->msg = buf + cndtn_len + file_len;
+    chk->buf = buf;
+    return FCT_TRUE;
 }
 
 
+/* Fills in CHK, formatting its message. A formatted message is copied
+into the check, and is still cut to FCT_MAX_LOG_LINE. Returns false if we
+ran out of memory. */
 static nbool_t
-fct_ts__is_test_cnt(fct_ts_t const *ts, int test_num)
+fctchk__init(fctchk_t *chk,
+             int is_pass,
+             char const *cndtn,
+             char const *file,
+             int lineno,
+             char const *format,
+             va_list args)
 {
-    FCT_ASSERT( ts != NULL );
-    FCT_ASSERT( 0 <= test_num );
-    FCT_ASSERT( test_num < ts->total_test_num );
-    FCT_ASSERT( !fct_ts__is_end(ts) );
-
-    /* As we roll through the tests we increment the count. With this
-    count we can decide if we need to execute a test or not. */
-    return test_num == ts->curr_test_num;
+    if ( format != NULL )
+    {
+        char msg[FCT_MAX_LOG_LINE];
+        fct_vsnprintf(msg, FCT_MAX_LOG_LINE, format, args);
+        fctchk__init_plain(chk, is_pass, cndtn, file, lineno, msg);
+        return fctchk__own(chk);
+    }
+    /* Default to make the condition be the message, if there was no format
+    specified. */
+    fctchk__init_plain(chk, is_pass, cndtn, file, lineno, cndtn);
+    return FCT_TRUE;
 }
 
 
-/* Returns the # of tests on the FCT TS object. This is the actual
-# of tests executed. */
-static size_t
-fct_ts__tst_cnt(fct_ts_t const *ts)
+/* Returns an empty check, taken from the ARENA, or from the heap if
+ARENA is NULL. Returns NULL if we ran out of memory. */
+static fctchk_t*
+fctchk__alloc(fct_arena_t *arena)
 {
-    FCT_ASSERT( ts != NULL );
-    FCT_ASSERT(
-        fct_ts__is_end(ts)
-        && "can't count number of tests executed until the test suite ends"
-    );
-    return fct_nlist__size(&(ts->test_list));
+    fctchk_t *chk = NULL;
+    if ( arena != NULL )
+    {
+        chk = (fctchk_t*)fct_arena__alloc(arena, sizeof(fctchk_t));
+        if ( chk != NULL )
+        {
+            memset(chk, 0, sizeof(fctchk_t));
+        }
+    }
+    else
+    {
+        chk = (fctchk_t*)fct_calloc(1, sizeof(fctchk_t));
+    }
+    if ( chk != NULL )
+    {
+        chk->arena = arena;
+    }
+    return chk;
 }
 
 
-/* Returns the # of tests in the TS object that passed. */
-static size_t
-fct_ts__tst_cnt_passed(fct_ts_t const *ts)
-{
-    size_t tally =0;
+static void
+fctchk__del(fctchk_t *chk);
 
-    FCT_ASSERT( ts != NULL );
-    FCT_ASSERT( fct_ts__is_end(ts) );
 
-    FCT_NLIST_FOREACH_BGN(fct_test_t*, test, &(ts->test_list))
+static fctchk_t*
+fctchk_new(fct_arena_t *arena,
+           int is_pass,
+           char const *cndtn,
+           char const *file,
+           int lineno,
+           char const *format,
+           va_list args)
+{
+    fctchk_t *chk = NULL;
+
+    chk = fctchk__alloc(arena);
+    if ( chk == NULL )
     {
-        if ( fct_test__is_pass(test) )
-        {
-            tally += 1;
-        }
+        return NULL;
     }
-    FCT_NLIST_FOREACH_END();
-    return tally;
+    if ( !fctchk__init(chk, is_pass, cndtn, file, lineno, format, args) )
+    {
+        fctchk__del(chk);
+        return NULL;
+    }
+    return chk;
 }
 
 
-/* Returns the # of checks made throughout a test suite. */
-static size_t
-fct_ts__chk_cnt(fct_ts_t const *ts)
-{
-    size_t tally =0;
-
-    FCT_ASSERT( ts != NULL );
 
-    FCT_NLIST_FOREACH_BGN(fct_test_t *, test, &(ts->test_list))
+/* Cleans up a "check" object. If the `chk` is NULL, or came from an
+arena, this function does nothing. */
+static void
+fctchk__del(fctchk_t *chk)
+{
+    if ( chk == NULL || chk->arena != NULL )
     {
-        tally += fct_test__chk_cnt(test);
+        return;
     }
-    FCT_NLIST_FOREACH_END();
-    return tally;
+    if ( chk->buf != NULL )
+    {
+        fct_free( chk->buf );
+    }
+    fct_free( chk );
 }
 
-/* Currently the duration is simply a sum of all the tests. */
-static double
-fct_ts__duration(fct_ts_t const *ts)
+
+/* Makes a copy of CHK, which owns whatever strings CHK owned. Returns
+NULL if we ran out of memory. */
+static fctchk_t*
+fctchk_clone(fctchk_t const *chk)
 {
-    double tally =0.0;
-    FCT_ASSERT( ts != NULL );
-    FCT_NLIST_FOREACH_BGN(fct_test_t *, test, &(ts->test_list))
+    fctchk_t *clone =NULL;
+    FCT_ASSERT( chk != NULL );
+    clone = (fctchk_t*)fct_malloc(sizeof(fctchk_t));
+    if ( clone == NULL )
     {
-        tally += fct_test__duration(test);
+        return NULL;
     }
-    FCT_NLIST_FOREACH_END();
-    return tally;
+    memcpy(clone, chk, sizeof(fctchk_t));
+    clone->buf = NULL;
+    clone->arena = NULL;
+    if ( chk->buf != NULL && !fctchk__own(clone) )
+    {
+        fct_free(clone);
+        return NULL;
+    }
+    return clone;
 }
 
 
 /*
---------------------------------------------------------
-FCT COMMAND LINE OPTION INITIALIZATION (fctcl_init)
---------------------------------------------------------
+-----------------------------------------------------------
+A TEST
+-----------------------------------------------------------
+A suite will have-a list of tests. Where each test will have-a
+list of failed and passed checks.
 
-Structure used for command line initialization. To keep it clear that we do
-not delete the char*'s present on this structure.
+A test belongs to the thread that made it. Checks from any other
+thread, say one the test started itself, are kept in a buffer for that
+thread. The buffers are pushed onto the test without a lock, and only
+the thread that owns the test ever takes them off, at FCT_TEST_END. So
+these threads must be done checking by the end of the test.
 */
 
-
-typedef enum
-{
-    FCTCL_STORE_UNDEFINED,
-    FCTCL_STORE_TRUE,
-    FCTCL_STORE_VALUE
-} fctcl_store_t;
-
-
-typedef struct _fctcl_init_t
+#if defined(FCT_CHK_THREADS)
+typedef struct _fct_chk_buf_t fct_chk_buf_t;
+struct _fct_chk_buf_t
 {
-    /* What to parse for this option. --long versus -s. */
-    char const *long_opt;     /* i.e. --help */
-    char const *short_opt;    /* i.e. -h */
-
-    /* What action to take when the option is activated. */
-    fctcl_store_t action;
-
-    /* The help string for the action. */
-    char const *help;
-} fctcl_init_t;
-
-
-/* Use when defining the option list. */
-#define FCTCL_INIT_NULL  \
-    {NULL, NULL, FCTCL_STORE_UNDEFINED, NULL}
-
+    /* The checks made by one thread, in order. */
+    fct_nlist_t chks;
+    fct_chk_buf_t *next;
+};
 
-/*
---------------------------------------------------------
-FCT COMMAND LINE OPTION (fctcl)
---------------------------------------------------------
+/* Only its address is used, to tell the threads apart. */
+static FCT_TLS char fct_thread_id =0;
+/* The buffer this thread is using, and the test it is for. */
+static FCT_TLS fct_chk_buf_t *fct_thread_chk_buf =NULL;
+static FCT_TLS unsigned long fct_thread_chk_epoch =0;
+/* Hands out a unique epoch to each test. */
+static unsigned long fct_test_epoch =0;
+#endif /* FCT_CHK_THREADS */
+
+/* What a benchmark measured, see FCT_BENCH_BGN. */
+typedef struct _fct_bench_stats_t fct_bench_stats_t;
+struct _fct_bench_stats_t
+{
+    /* The iterations run to warm up, and then in each timed batch. */
+    size_t num_warmup_iters;
+    size_t batch;
+    /* The nanoseconds an iteration took, one sample for each batch. */
+    double samples[FCT_BENCH_SAMPLES];
+    size_t num_samples;
+    /* Worked out from the samples by fct_bench_stats__update. The mean
+    leaves out the outliers, the percentiles are interpolated. */
+    double ns_per_op;
+    double median;
+    double min;
+    double p90;
+    double p99;
+    /* The median absolute deviation from the median. */
+    double mad;
+    /* A 95% confidence interval for the median. */
+    double ci_low;
+    double ci_high;
+    /* Counted over the timed batches, see PERF COUNTERS. */
+    fct_perf_t perf;
+    /* The samples past Tukey's fences, 1.5 times the interquartile range
+    beyond the quartiles. */
+    size_t num_outliers;
+};
 
-Specifies the command line configuration options. Use this
-to help initialize the fct_clp (command line parser).
-*/
+#define fct_bench_stats__num_iters(_STATS_) \
+    ((_STATS_)->batch * (_STATS_)->num_samples)
 
 
-/* Handy strings for storing "true" and "false". We can reference
-these strings throughout the parse operation and not have to
-worry about dealing with memory. */
-#define FCTCL_TRUE_STR "1"
+/* For qsort, orders doubles from least to greatest. */
+static int
+fct_bench__cmp_dbl(void const *a, void const *b)
+{
+    double x = *(double const*)a;
+    double y = *(double const*)b;
+    return (x < y) ? -1 : ((x > y) ? 1 : 0);
+}
 
 
-typedef struct _fctcl_t
+/* Returns the P quantile of the NUM SORTED values, interpolating
+between the two closest. */
+static double
+fct_bench__quantile(double const *sorted, size_t num, double p)
 {
-    /* What to parse for this option. --long versus -s. */
-    char *long_opt;     /* i.e. --help */
-    char *short_opt;    /* i.e. -h */
+    double pos = p * (double)(num - 1);
+    size_t i = (size_t)pos;
+    if ( i + 1 >= num )
+    {
+        return sorted[num - 1];
+    }
+    return sorted[i] + (pos - (double)i) * (sorted[i + 1] - sorted[i]);
+}
 
-    /* What action to take when the option is activated. */
-    fctcl_store_t action;
 
-    /* The help string for the action. */
-    char *help;
+/* A square root by Newton's method. Compilers do fabs inline, but sqrt
+stays a call into the math library, for errno, which every test program
+would then have to link with -lm. */
+static double
+fct_bench__sqrt(double x)
+{
+    double root = x;
+    int iter_i =0;
+    if ( x <= 0.0 )
+    {
+        return 0.0;
+    }
+    for ( iter_i =0; iter_i != 32; ++iter_i )
+    {
+        root = 0.5 * (root + x / root);
+    }
+    return root;
+}
 
-    /* The result. */
-    char *value;
-} fctcl_t;
 
+/* Works out the figures from the samples. The confidence interval of the
+median is taken from the ranks n/2 - 0.98 sqrt(n) and 1 + n/2 + 0.98
+sqrt(n) of the sorted samples, which needs no assumptions about their
+distribution. */
+static void
+fct_bench_stats__update(fct_bench_stats_t *stats)
+{
+    double sorted[FCT_BENCH_SAMPLES];
+    double devs[FCT_BENCH_SAMPLES];
+    double num =0.0;
+    double spread =0.0;
+    double q1 =0.0;
+    double q3 =0.0;
+    double sum =0.0;
+    size_t num_kept =0;
+    size_t low =0;
+    size_t high =0;
+    size_t sample_i =0;
+    FCT_ASSERT( stats != NULL );
+    stats->num_outliers = 0;
+    if ( stats->num_samples == 0 )
+    {
+        stats->ns_per_op = stats->median = stats->min = 0.0;
+        stats->p90 = stats->p99 = stats->mad = 0.0;
+        stats->ci_low = stats->ci_high = 0.0;
+        return;
+    }
+    memcpy(sorted, stats->samples, stats->num_samples * sizeof(double));
+    qsort(sorted, stats->num_samples, sizeof(double), fct_bench__cmp_dbl);
+    stats->min = sorted[0];
+    stats->median = fct_bench__quantile(sorted, stats->num_samples, 0.5);
+    stats->p90 = fct_bench__quantile(sorted, stats->num_samples, 0.90);
+    stats->p99 = fct_bench__quantile(sorted, stats->num_samples, 0.99);
+
+    for ( sample_i =0; sample_i != stats->num_samples; ++sample_i )
+    {
+        devs[sample_i] = sorted[sample_i] - stats->median;
+        if ( devs[sample_i] < 0.0 )
+        {
+            devs[sample_i] = -devs[sample_i];
+        }
+    }
+    qsort(devs, stats->num_samples, sizeof(double), fct_bench__cmp_dbl);
+    stats->mad = fct_bench__quantile(devs, stats->num_samples, 0.5);
+
+    num = (double)stats->num_samples;
+    spread = 0.98 * fct_bench__sqrt(num);
+    low = (num / 2.0 - spread + 0.5 < 1.0) ?
+          1 : (size_t)(num / 2.0 - spread + 0.5);
+    high = (size_t)(1.0 + num / 2.0 + spread + 0.5);
+    if ( high > stats->num_samples )
+    {
+        high = stats->num_samples;
+    }
+    stats->ci_low = sorted[low - 1];
+    stats->ci_high = sorted[high - 1];
 
-#define fctcl_new()  ((fctcl_t*)calloc(1, sizeof(fctcl_t)))
+    q1 = fct_bench__quantile(sorted, stats->num_samples, 0.25);
+    q3 = fct_bench__quantile(sorted, stats->num_samples, 0.75);
+    for ( sample_i =0; sample_i != stats->num_samples; ++sample_i )
+    {
+        if ( sorted[sample_i] < q1 - 1.5 * (q3 - q1)
+                || sorted[sample_i] > q3 + 1.5 * (q3 - q1) )
+        {
+            ++(stats->num_outliers);
+            continue;
+        }
+        sum += sorted[sample_i];
+        ++num_kept;
+    }
+    stats->ns_per_op = (num_kept > 0) ?
+                       sum / (double)num_kept : stats->median;
+}
 
 
+/* Writes the batch size and the samples on one line, each sample ends in
+a space. */
 static void
-fctcl__del(fctcl_t *clo)
+fct_bench_stats__write(fct_bench_stats_t const *stats, FILE *out)
 {
-    if ( clo == NULL )
+    size_t sample_i =0;
+    fprintf(out, "%lu ", (unsigned long)stats->batch);
+    for ( sample_i =0; sample_i != stats->num_samples; ++sample_i )
     {
-        return;
+        fprintf(out, "%.9g ", stats->samples[sample_i]);
     }
-    free(clo->long_opt);
-    free(clo->short_opt);
-    free(clo->value);
-    free(clo->help);
-    free(clo);
+    fprintf(out, "\n");
 }
 
 
-static fctcl_t*
-fctcl_new2(fctcl_init_t const *clo_init)
+/* Reads the samples from TEXT, each must end in a space, so one that was
+cut short is left off. Then works out the figures. */
+static void
+fct_bench_stats__read_samples(fct_bench_stats_t *stats, char const *text)
 {
-    fctcl_t *clone = NULL;
-    int ok =0;
-    clone = fctcl_new();
-    if ( clone == NULL )
+    char *end =NULL;
+    stats->num_samples = 0;
+    while ( stats->num_samples != FCT_BENCH_SAMPLES )
+    {
+        double sample = strtod(text, &end);
+        if ( end == text || *end != ' ' )
+        {
+            break;
+        }
+        stats->samples[stats->num_samples++] = sample;
+        text = end + 1;
+    }
+    fct_bench_stats__update(stats);
+}
+
+struct _fct_test_t
+{
+    /* List of failed and passed "checks" (fctchk_t). Two separate
+    lists make it faster to determine how many checks passed and how
+    many checks failed. The passed checks are only counted, unless
+    FCT_CONF_KEEP_PASSED_CHKS is defined, and the list is left empty. */
+    fct_nlist_t failed_chks;
+    fct_nlist_t passed_chks;
+    size_t num_passed;
+
+    /* Failed checks past --max-failures, these are only counted. */
+    size_t num_dropped;
+
+    /* To store the test run time */
+    fct_timer_t timer;
+
+    /* The setup before the test and the teardown after it. The teardown
+    is only known once the test has been logged. */
+    fct_timer_t setup_timer;
+    fct_timer_t teardown_timer;
+
+    /* Set by a benchmark run with --bench, NULL otherwise. */
+    fct_bench_stats_t *bench;
+
+    /* Counted over the test body, see PERF COUNTERS. */
+    fct_perf_t perf;
+
+    /* Counted over the test body, see ALLOCATION COUNTS. */
+    fct_alloc_t alloc;
+
+    /* Used over the test body, see RESOURCE USAGE. */
+    fct_rusage_t rusage;
+
+    /* The name of the test case, and our copy of it if it was not a
+    literal. */
+    char const *name;
+    char *name_buf;
+
+    /* The arena the test came from, its checks are taken from here too.
+    NULL if it is on the heap. */
+    fct_arena_t *arena;
+
+#if defined(FCT_CHK_THREADS)
+    /* The thread that made the test, and its unique epoch. A test may be
+    freed and another made at the same address, but never with the
+    same epoch. */
+    char const *owner;
+    unsigned long epoch;
+    /* Checks from the other threads, newest buffer first. */
+    fct_chk_buf_t *volatile chk_bufs;
+#endif /* FCT_CHK_THREADS */
+};
+
+#define fct_test__name(_TEST_) ((_TEST_)->name)
+
+#if defined(FCT_CHK_THREADS)
+static void
+fct_chk_buf__del(fct_chk_buf_t *buf)
+{
+    if ( buf == NULL )
+    {
+        return;
+    }
+    fct_nlist__final(&(buf->chks), (fct_nlist_on_del_t)fctchk__del);
+    fct_free(buf);
+}
+
+
+/* Takes all the buffers off of the test, oldest first. Only the thread
+that owns the test calls this. */
+static fct_chk_buf_t *
+fct_test__take_chk_bufs(fct_test_t *test)
+{
+    fct_chk_buf_t *buf =NULL;
+    fct_chk_buf_t *prev =NULL;
+    fct_chk_buf_t *next =NULL;
+    FCT_ASSERT( test != NULL );
+    if ( test->chk_bufs == NULL )
     {
         return NULL;
     }
-    clone->action = clo_init->action;
-    if ( clo_init->help == NULL )
+    buf = __sync_lock_test_and_set(&(test->chk_bufs), (fct_chk_buf_t*)NULL);
+    __sync_synchronize();
+    for ( ; buf != NULL; buf = next )
     {
-        clone->help = NULL;
+        next = buf->next;
+        buf->next = prev;
+        prev = buf;
     }
-    else
+    return prev;
+}
+#endif /* FCT_CHK_THREADS */
+
+/* Clears the failed tests ... partly for internal testing. */
+#define fct_test__clear_failed(test) \
+    fct_nlist__clear(test->failed_chks, (fct_nlist_on_del_t)fctchk__del);\
+ 
+
+static void
+fct_test__del(fct_test_t *test)
+{
+    if (test == NULL )
     {
-        clone->help = fctstr_clone(clo_init->help);
-        if ( clone->help == NULL )
+        return;
+    }
+    fct_nlist__final(&(test->passed_chks), (fct_nlist_on_del_t)fctchk__del);
+    fct_nlist__final(&(test->failed_chks), (fct_nlist_on_del_t)fctchk__del);
+#if defined(FCT_CHK_THREADS)
+    {
+        fct_chk_buf_t *buf =fct_test__take_chk_bufs(test);
+        fct_chk_buf_t *next =NULL;
+        for ( ; buf != NULL; buf = next )
         {
-            ok =0;
-            goto finally;
+            next = buf->next;
+            fct_chk_buf__del(buf);
         }
     }
-    if ( clo_init->long_opt == NULL )
+#endif /* FCT_CHK_THREADS */
+    if ( test->arena != NULL )
     {
-        clone->long_opt = NULL;
+        return;
+    }
+    if ( test->name_buf != NULL )
+    {
+        fct_free(test->name_buf);
+    }
+    fct_free(test->bench);
+    fct_free(test);
+}
+
+
+/* Makes a new test. A NAME that IS_STATIC, like a string literal, is only
+pointed at, otherwise it is copied. The test, its name and its checks are
+taken from the ARENA, or from the heap if ARENA is NULL. */
+static fct_test_t*
+fct_test_new2(char const *name, nbool_t is_static, fct_arena_t *arena)
+{
+    nbool_t ok =FCT_FALSE;
+    fct_test_t *test =NULL;
+
+    if ( arena != NULL )
+    {
+        test = (fct_test_t*)fct_arena__alloc(arena, sizeof(fct_test_t));
     }
     else
     {
-        clone->long_opt = fctstr_clone(clo_init->long_opt);
-        if ( clone->long_opt == NULL )
+        test = (fct_test_t*)fct_malloc(sizeof(fct_test_t));
+    }
+    if ( test == NULL )
+    {
+        goto finally;
+    }
+
+    test->arena = arena;
+    test->name_buf = NULL;
+    test->name = name;
+    test->bench = NULL;
+#if defined(FCT_CHK_THREADS)
+    test->chk_bufs = NULL;
+#endif /* FCT_CHK_THREADS */
+
+    /* Failures are an exception, so lets not allocate up
+    the list until we need to. */
+    fct_nlist__init2(&(test->failed_chks), 0);
+    fct_nlist__init2(&(test->passed_chks), 0);
+#if defined(FCT_CONF_KEEP_PASSED_CHKS)
+    if (!fct_nlist__init(&(test->passed_chks)))
+    {
+        goto finally;
+    }
+#endif /* FCT_CONF_KEEP_PASSED_CHKS */
+    test->num_passed = 0;
+    test->num_dropped = 0;
+
+    if ( !is_static && arena != NULL )
+    {
+        test->name = fct_arena__strdup(arena, name);
+        if ( test->name == NULL )
         {
-            ok = 0;
             goto finally;
         }
     }
-    if ( clo_init->short_opt == NULL )
-    {
-        clone->short_opt = NULL;
-    }
-    else
+    else if ( !is_static )
     {
-        clone->short_opt = fctstr_clone(clo_init->short_opt);
-        if ( clone->short_opt == NULL )
+        test->name_buf = fctstr_clone(name);
+        if ( test->name_buf == NULL )
         {
-            ok =0;
             goto finally;
         }
+        test->name = test->name_buf;
     }
-    ok = 1;
+
+    fct_timer__init(&(test->timer));
+    fct_timer__init(&(test->setup_timer));
+    fct_timer__init(&(test->teardown_timer));
+    fct_perf__init(&(test->perf));
+    fct_alloc__init(&(test->alloc));
+    fct_rusage__init(&(test->rusage));
+
+#if defined(FCT_CHK_THREADS)
+    test->owner = &fct_thread_id;
+    test->epoch = __sync_add_and_fetch(&fct_test_epoch, 1);
+#endif /* FCT_CHK_THREADS */
+
+    ok =FCT_TRUE;
 finally:
     if ( !ok )
     {
-        fctcl__del(clone);
-        clone = NULL;
+        fct_test__del(test);
+        test =NULL;
     }
-    return clone;
+    return test;
 }
 
 
-static int
-fctcl__is_option(fctcl_t const *clo, char const *option)
+/* Makes a new test, with its own copy of NAME. */
+static fct_test_t*
+fct_test_new(char const *name)
 {
-    FCT_ASSERT( clo != NULL );
-    if ( option == NULL )
-    {
-        return 0;
-    }
-    return ((clo->long_opt != NULL
-             && fctstr_eq(clo->long_opt, option))
-            ||
-            (clo->short_opt != NULL
-             && fctstr_eq(clo->short_opt, option))
-           );
+    return fct_test_new2(name, FCT_FALSE, NULL);
 }
 
 
-#define fctcl__set_value(_CLO_, _VAL_) \
-    (_CLO_)->value = fctstr_clone((_VAL_));
-
-/*
---------------------------------------------------------
-FCT COMMAND PARSER (fct_clp)
---------------------------------------------------------
-*/
+/* The counters go outside the timer, so reading them is not timed. */
+static void
+fct_test__start_timer(fct_test_t *test)
+{
+    FCT_ASSERT( test != NULL );
+    fct_rusage__start(&(test->rusage));
+    fct_perf__start(&(test->perf));
+    fct_timer__start(&(test->timer));
+    fct_alloc__start(&(test->alloc));
+}
 
-#define FCT_CLP_MAX_ERR_MSG_LEN     256
 
-typedef struct _fct_clp_t
+static void
+fct_test__stop_timer(fct_test_t *test)
 {
-    /* List of command line options. */
-    fct_nlist_t clo_list;
+    FCT_ASSERT( test != NULL );
+    fct_alloc__stop(&(test->alloc));
+    fct_timer__stop(&(test->timer));
+    fct_perf__stop(&(test->perf));
+    fct_rusage__stop(&(test->rusage));
+}
 
-    /* List of parameters (not options). */
-    fct_nlist_t param_list;
 
-    char error_msg[FCT_CLP_MAX_ERR_MSG_LEN];
-    int is_error;
-} fct_clp_t;
+static double
+fct_test__duration(fct_test_t const *test)
+{
+    FCT_ASSERT( test != NULL );
+    return fct_timer__duration(&(test->timer));
+}
 
+#define fct_test__setup_duration(_TEST_) \
+    fct_timer__duration(&((_TEST_)->setup_timer))
+#define fct_test__teardown_duration(_TEST_) \
+    fct_timer__duration(&((_TEST_)->teardown_timer))
+#define fct_test__cpu_duration(_TEST_) \
+    fct_timer__cpu_duration(&((_TEST_)->timer))
+#define fct_test__thread_duration(_TEST_) \
+    fct_timer__thread_duration(&((_TEST_)->timer))
 
-static void
-fct_clp__final(fct_clp_t *clp)
+
+static nbool_t
+fct_test__is_pass(fct_test_t const *test)
 {
-    fct_nlist__final(&(clp->clo_list), (fct_nlist_on_del_t)fctcl__del);
-    fct_nlist__final(&(clp->param_list), (fct_nlist_on_del_t)free);
+    FCT_ASSERT( test != NULL );
+    return fct_nlist__size(&(test->failed_chks)) == 0;
 }
 
 
-/* Add an configuration options. */
-static int
-fct_clp__add_options(fct_clp_t *clp, fctcl_init_t const *options)
+/* Counts a check that passed, without keeping it. */
+#define fct_test__add_pass(_TEST_) (++((_TEST_)->num_passed))
+
+
+/* The test takes the check, so log it before adding it. A check that
+passed is only counted, and freed here, unless FCT_CONF_KEEP_PASSED_CHKS
+is defined. */
+static void
+fct_test__add(fct_test_t *test, fctchk_t *chk)
 {
-    fctcl_init_t const *pclo =NULL;
-    int ok;
-    for ( pclo = options; pclo->action != FCTCL_STORE_UNDEFINED; ++pclo )
+
+    FCT_ASSERT( test != NULL );
+    FCT_ASSERT( chk != NULL );
+
+    if ( fctchk__is_pass(chk) )
     {
-        fctcl_t *cpy = fctcl_new2(pclo);
-        if ( cpy == NULL )
-        {
-            ok = 0;
-            goto finally;
-        }
-        fct_nlist__append(&(clp->clo_list), (void*)cpy);
+#if defined(FCT_CONF_KEEP_PASSED_CHKS)
+        fct_nlist__append(&(test->passed_chks), (void*)chk);
+#else
+        fct_test__add_pass(test);
+        fctchk__del(chk);
+#endif /* FCT_CONF_KEEP_PASSED_CHKS */
+    }
+    else
+    {
+        fct_nlist__append(&(test->failed_chks), (void*)chk);
     }
-    ok =1;
-finally:
-    return ok;
 }
 
-/* Returns false if we ran out of memory. */
-static int
-fct_clp__init(fct_clp_t *clp, fctcl_init_t const *options)
+#if defined(FCT_CHK_THREADS)
+/* True when called from the thread that made the test. */
+#   define fct_test__is_owner(_TEST_) ((_TEST_)->owner == &fct_thread_id)
+
+/* Keeps a check from a thread other than the owner in that thread's
+buffer, until the owner merges it at the end of the test. Returns false
+if the buffer could not be made, the check is then still ours to free. */
+static nbool_t
+fct_test__add_from_thread(fct_test_t *test, fctchk_t *chk)
 {
-    int ok =0;
-    FCT_ASSERT( clp != NULL );
-    /* It is just much saner to manage a clone of the options. Then we know
-    who is in charge of the memory. */
-    ok = fct_nlist__init(&(clp->clo_list));
-    if ( !ok )
-    {
-        goto finally;
-    }
-    if ( options != NULL )
+    fct_chk_buf_t *buf =fct_thread_chk_buf;
+    FCT_ASSERT( test != NULL );
+    FCT_ASSERT( chk != NULL );
+    if ( buf == NULL || fct_thread_chk_epoch != test->epoch )
     {
-        ok = fct_clp__add_options(clp, options);
-        if ( !ok )
+        buf = (fct_chk_buf_t*)fct_malloc(sizeof(fct_chk_buf_t));
+        if ( buf == NULL )
         {
-            goto finally;
+            return FCT_FALSE;
         }
+        fct_nlist__init2(&(buf->chks), 0);
+        /* Each failed swap hands back the newer head to go after. */
+        buf->next = NULL;
+        for (;;)
+        {
+            fct_chk_buf_t *head =
+                __sync_val_compare_and_swap(&(test->chk_bufs), buf->next, buf);
+            if ( head == buf->next )
+            {
+                break;
+            }
+            buf->next = head;
+        }
+        fct_thread_chk_buf = buf;
+        fct_thread_chk_epoch = test->epoch;
     }
-    ok = fct_nlist__init(&(clp->param_list));
-    if ( !ok )
-    {
-        goto finally;
-    }
-    ok =1;
-finally:
-    if ( !ok )
-    {
-        fct_clp__final(clp);
-    }
-    return ok;
+    fct_nlist__append(&(buf->chks), (void*)chk);
+    return FCT_TRUE;
 }
+#else
+#   define fct_test__is_owner(_TEST_) (FCT_TRUE)
+#   define fct_test__add_from_thread(_TEST_, _CHK_) (FCT_FALSE)
+#endif /* FCT_CHK_THREADS */
 
 
-/* Parses the command line arguments. Use fct_clp__is_error and
-fct_clp__get_error to figure out if something went awry. */
-static void
-fct_clp__parse(fct_clp_t *clp, int argc, char const *argv[])
+/* Returns the number of checks made throughout the test. */
+static size_t
+fct_test__chk_cnt(fct_test_t const *test)
 {
-    int argi =1;
+    FCT_ASSERT( test != NULL );
+    return fct_nlist__size(&(test->failed_chks)) \
+           + fct_nlist__size(&(test->passed_chks))
+           + test->num_passed
+           + test->num_dropped;
+}
+
+
+/*
+-----------------------------------------------------------
+TEST SUITE (TS)
+-----------------------------------------------------------
+*/
+
+
+/* The different types of 'modes' that a test suite can be in.
+
+While the test suite is iterating through all the tests, its "State"
+can change from "setup mode", to "test mode" to "tear down" mode.
+These help to indicate what mode are currently in. Think of it as a
+basic FSM.
+
+            if the count was 0                                 end
+           +--------->---------------------> ending_mode-----+-+
+           |                                       ^         |
+           ^                                       |         ^
+start      |                              [if no more tests] |
+  |        |                                       |         |
+  +-count_mode -> setup_mode -> test_mode -> teardown_mode->-+
+                   |  ^                           |          |
+                   |  +-----------<---------------+          |
+                   +----------->---[if fct_req fails]--------+
+
+*/
+enum ts_mode
+{
+    ts_mode_cnt,         /* To setup when done counting. */
+    ts_mode_setup,       /* To test when done setup. */
+    ts_mode_teardown,    /* To ending mode, when no more tests. */
+    ts_mode_test,        /* To tear down mode. */
+    ts_mode_ending,      /* To ... */
+    ts_mode_end,         /* .. The End. */
+    ts_mode_abort        /* Abort */
+};
+
+/* Types of states the test could be in. */
+typedef enum
+{
+    fct_test_status_SUCCESS,
+    fct_test_status_FAILURE
+} fct_test_status;
+
+
+/* What a suite knows about each of its tests before running them. */
+typedef struct _fct_ts_entry_t
+{
+    char const *name;
+    /* Unique id, see FCT_TEST_IDS. */
+    int id;
+    /* Cleared for tests that are filtered out, these are passed over
+    without running the setup or teardown. */
+    nbool_t is_selected;
+    /* Position among all the selected tests of the run, only numbered
+    when running with --jobs. */
+    int seq;
+} fct_ts_entry_t;
+
+
+struct _fct_ts_t
+{
+    /* For counting our 'current' test number, and the total number of
+    tests. */
+    int  curr_test_num;
+    int  total_test_num;
+
+    /* Keeps track of the current state of the object while it is walking
+    through its "FSM" */
+    enum ts_mode mode;
+
+    /* The name of the test suite. */
+    char const *name;
+
+    /* Backs the tests, their checks, and the name if it was not a
+    literal. All freed at once with the suite. */
+    fct_arena_t arena;
+
+    /* List of tests that where executed within the test suite. */
+    fct_nlist_t test_list;
+
+    /* Each test, indexed by test number. Collected during the count
+    pass. */
+    fct_ts_entry_t *entries;
+    int entry_num;
+    int entry_avail;
+
+    /* The entries came from the test registry instead of a count pass,
+    and are checked against the tests as the suite is walked. See
+    fct_ts__walk_end. */
+    nbool_t is_registered;
+    nbool_t is_misplaced;
+    nbool_t is_recount;
+
+    /* From FCT_FIXTURE_SUITE_BGN to FCT_FIXTURE_SUITE_END. */
+    fct_timer_t timer;
+
+    /* The fixture around the current test, handed to the test that was
+    added between them. */
+    fct_timer_t setup_timer;
+    fct_timer_t teardown_timer;
+    fct_test_t *fixture_test;
+
+    /* What its tests used, added up. */
+    fct_rusage_t rusage;
+};
+
+
+#define fct_ts__is_setup_mode(ts)     ((ts)->mode == ts_mode_setup)
+#define fct_ts__is_teardown_mode(ts)  ((ts)->mode == ts_mode_teardown)
+#define fct_ts__is_test_mode(ts)      ((ts)->mode == ts_mode_test)
+#define fct_ts__is_ending_mode(ts)    ((ts)->mode == ts_mode_ending)
+#define fct_ts__is_end(ts)            ((ts)->mode == ts_mode_end)
+#define fct_ts__is_cnt_mode(ts)       ((ts)->mode == ts_mode_cnt)
+#define fct_ts__is_abort_mode(ts)     ((ts)->mode == ts_mode_abort)
+
+/* This cndtn is set when we have iterated through all the tests, and
+there was nothing more to do. */
+#define fct_ts__ending(ts)          ((ts)->mode = ts_mode_ending)
+
+/* Flag a test suite as complete. It will no longer accept any more tests. */
+#define fct_ts__end(ts)  ((ts)->mode = ts_mode_end)
+
+#define fct_ts__name(ts)              ((ts)->name)
+#define fct_ts__arena(ts)             (&((ts)->arena))
+
+
+static void
+fct_ts__del(fct_ts_t *ts)
+{
+    if ( ts == NULL )
+    {
+        return;
+    }
+    fct_nlist__final(&(ts->test_list), (fct_nlist_on_del_t)fct_test__del);
+    if ( ts->entries != NULL )
+    {
+        fct_free(ts->entries);
+    }
+    fct_arena__final(&(ts->arena));
+    fct_free(ts);
+}
+
+/* Makes a new test suite. A NAME that IS_STATIC, like a string literal,
+is only pointed at, otherwise it is copied. */
+static fct_ts_t *
+fct_ts_new2(char const *name, nbool_t is_static)
+{
+    fct_ts_t *ts =NULL;
+    ts = (fct_ts_t*)fct_calloc(1, sizeof(fct_ts_t));
+    FCT_ASSERT( ts != NULL );
+
+    fct_arena__init(&(ts->arena));
+    ts->name = name;
+    if ( !is_static )
+    {
+        ts->name = fct_arena__strdup(&(ts->arena), name);
+        FCT_ASSERT( ts->name != NULL );
+    }
+    ts->mode = ts_mode_cnt;
+    fct_nlist__init(&(ts->test_list));
+    fct_timer__start(&(ts->timer));
+    return ts;
+}
+
+/* Makes a new test suite, with its own copy of NAME. */
+static fct_ts_t *
+fct_ts_new(char const *name)
+{
+    return fct_ts_new2(name, FCT_FALSE);
+}
+
+
+
+static nbool_t
+fct_ts__is_more_tests(fct_ts_t const *ts)
+{
+    FCT_ASSERT( ts != NULL );
+    FCT_ASSERT( !fct_ts__is_end(ts) );
+    return ts->curr_test_num < ts->total_test_num;
+}
+
+
+/* Indicates that we have started a test case. */
+static void
+fct_ts__test_begin(fct_ts_t *ts)
+{
+    FCT_ASSERT( !fct_ts__is_end(ts) );
+    ++(ts->curr_test_num);
+}
+
+
+/* Takes OWNERSHIP of a test object, and warehouses it for later stat
+generation. */
+static void
+fct_ts__add_test(fct_ts_t *ts, fct_test_t *test)
+{
+    FCT_ASSERT( ts != NULL && "invalid arg");
+    FCT_ASSERT( test != NULL && "invalid arg");
+    FCT_ASSERT( !fct_ts__is_end(ts) );
+    fct_nlist__append(&(ts->test_list), test);
+    fct_rusage__add(&(ts->rusage), &(test->rusage));
+    ts->fixture_test = test;
+}
+
+
+static void
+fct_ts__test_end(fct_ts_t *ts)
+{
+    FCT_ASSERT( ts != NULL );
+    /* After a test has completed, move to teardown mode. */
+    ts->mode = ts_mode_teardown;
+}
+
+
+/* Increments the internal count by 1. */
+static void
+fct_ts__inc_total_test_num(fct_ts_t *ts)
+{
+    FCT_ASSERT( ts != NULL );
+    FCT_ASSERT( fct_ts__is_cnt_mode(ts) );
+    FCT_ASSERT( !fct_ts__is_end(ts) );
+    ++(ts->total_test_num);
+}
+
+
+/* Records the next test, in count mode. The name is not copied, it is
+expected to be a string literal. */
+static void
+fct_ts__add_entry(fct_ts_t *ts, char const *name, int id)
+{
+    fct_ts_entry_t *entry =NULL;
+    FCT_ASSERT( ts != NULL );
+    FCT_ASSERT( fct_ts__is_cnt_mode(ts) );
+    if ( ts->entry_num == ts->entry_avail )
+    {
+        int new_avail = (ts->entry_avail == 0) ? 8 : ts->entry_avail * 2;
+        fct_ts_entry_t *new_entries = (fct_ts_entry_t*)fct_realloc(
+                                          ts->entries,
+                                          sizeof(fct_ts_entry_t)*(size_t)new_avail
+                                      );
+        FCT_ASSERT( new_entries != NULL );
+        ts->entries = new_entries;
+        ts->entry_avail = new_avail;
+    }
+    entry = &(ts->entries[ts->entry_num++]);
+    entry->name = name;
+    entry->id = id;
+    entry->is_selected = FCT_TRUE;
+    entry->seq = -1;
+}
+
+
+/* Moves the current test past any tests that where not selected. */
+static void
+fct_ts__skip_unselected(fct_ts_t *ts)
+{
+    FCT_ASSERT( ts != NULL );
+    while ( ts->curr_test_num < ts->entry_num
+            && !ts->entries[ts->curr_test_num].is_selected )
+    {
+        ++(ts->curr_test_num);
+    }
+}
+
+
+/* Returns the dispatch id of the test we are about to run, and moves the
+test number up to just before it. Returns -1 if we are not about to run
+a test (or have no ids), in which case the suite is walked as usual. */
+static int
+fct_ts__dispatch(fct_ts_t const *ts, int *test_num)
+{
+    FCT_ASSERT( ts != NULL );
+    FCT_ASSERT( test_num != NULL );
+#if defined(FCT_JUMP_DISPATCH)
+    if ( !fct_ts__is_test_mode(ts) || ts->curr_test_num >= ts->entry_num )
+    {
+        return -1;
+    }
+    *test_num = ts->curr_test_num - 1;
+    return ts->entries[ts->curr_test_num].id;
+#else
+    return -1;
+#endif /* FCT_JUMP_DISPATCH */
+}
+
+
+/* Flags the start of the setup. */
+static void
+fct_ts__setup_bgn(fct_ts_t *ts)
+{
+    FCT_ASSERT( ts != NULL );
+    ts->fixture_test = NULL;
+    fct_timer__start(&(ts->setup_timer));
+}
+
+
+/* Flags the end of the setup, which implies we are going to move into
+setup mode. You must be already in setup mode for this to work! */
+static void
+fct_ts__setup_end(fct_ts_t *ts)
+{
+    fct_timer__stop(&(ts->setup_timer));
+    if ( ts->mode != ts_mode_abort )
+    {
+        ts->mode = ts_mode_test;
+    }
+}
+
+
+/* Makes a test, out of the suite's arena, named by the literal NAME. */
+static fct_test_t *
+fct_ts__new_test(fct_ts_t *ts, char const *name)
+{
+    fct_test_t *test =NULL;
+    FCT_ASSERT( ts != NULL );
+    test = fct_test_new2(name, FCT_TRUE, fct_ts__arena(ts));
+    if ( test != NULL )
+    {
+        test->setup_timer = ts->setup_timer;
+    }
+    return test;
+}
+
+
+static fct_test_t *
+fct_ts__make_abort_test(fct_ts_t *ts)
+{
+    char setup_testname[FCT_MAX_LOG_LINE+1] = {'\0'};
+    char const *suitename = fct_ts__name(ts);
+    fct_snprintf(setup_testname, FCT_MAX_LOG_LINE, "setup_%s", suitename);
+    return fct_test_new2(setup_testname, FCT_FALSE, fct_ts__arena(ts));
+}
+
+/* Flags a pre-mature abort of a setup (like a failed fct_req). */
+static void
+fct_ts__setup_abort(fct_ts_t *ts)
+{
+    FCT_ASSERT( ts != NULL );
+    ts->mode = ts_mode_abort;
+}
+
+/* Flags the start of the teardown. */
+#define fct_ts__teardown_bgn(ts)  fct_timer__start(&((ts)->teardown_timer))
+
+
+/* Stops the teardown timer, and gives the time to the test that was
+torn down. */
+static void
+fct_ts__teardown_stop(fct_ts_t *ts)
+{
+    FCT_ASSERT( ts != NULL );
+    fct_timer__stop(&(ts->teardown_timer));
+    if ( ts->fixture_test != NULL )
+    {
+        ts->fixture_test->teardown_timer = ts->teardown_timer;
+    }
+}
+
+
+/* Drops the entries, so the suite is counted again. The tests that
+already ran came before the first one out of place, so they keep their
+numbers and are not run again. */
+static void
+fct_ts__recount(fct_ts_t *ts)
+{
+    FCT_ASSERT( ts != NULL );
+    ts->is_registered = FCT_FALSE;
+    ts->is_misplaced = FCT_FALSE;
+    ts->is_recount = FCT_FALSE;
+    ts->entry_num = 0;
+    ts->total_test_num = 0;
+    ts->mode = ts_mode_cnt;
+}
+
+
+/* Flags the end of the teardown, which implies we are going to move
+into setup mode (for the next 'iteration'). */
+static void
+fct_ts__teardown_end(fct_ts_t *ts)
+{
+    if ( ts->mode == ts_mode_abort )
+    {
+        return; /* Because we are aborting . */
+    }
+    /* We have to decide if we should keep on testing by moving into tear down
+    mode or if we have reached the real end and should be moving into the
+    ending mode. */
+    if ( ts->is_recount )
+    {
+        fct_ts__recount(ts);
+        return;
+    }
+    fct_ts__skip_unselected(ts);
+    if ( fct_ts__is_more_tests(ts) )
+    {
+        ts->mode = ts_mode_setup;
+    }
+    else if ( ts->is_registered )
+    {
+        /* Walk the suite once more, for any test left unregistered. */
+        ts->mode = ts_mode_test;
+    }
+    else
+    {
+        ts->mode = ts_mode_ending;
+    }
+}
+
+
+/* Flags the end of the counting, and proceeding to the first setup.
+Consider the special case when a test suite has NO tests in it (or none
+that where selected), in that case we can skip right to 'ending'. */
+static void
+fct_ts__cnt_end(fct_ts_t *ts)
+{
+    FCT_ASSERT( ts != NULL );
+    FCT_ASSERT( fct_ts__is_cnt_mode(ts) );
+    FCT_ASSERT( !fct_ts__is_end(ts) );
+    fct_ts__skip_unselected(ts);
+    if ( !fct_ts__is_more_tests(ts) )
+    {
+        ts->mode = ts_mode_ending;
+    }
+    else
+    {
+        ts->mode = ts_mode_setup;
+    }
+}
+
+
+static nbool_t
+fct_ts__is_test_cnt(fct_ts_t const *ts, int test_num)
+{
+    FCT_ASSERT( ts != NULL );
+    FCT_ASSERT( 0 <= test_num );
+    FCT_ASSERT( test_num < ts->total_test_num );
+    FCT_ASSERT( !fct_ts__is_end(ts) );
+
+    /* As we roll through the tests we increment the count. With this
+    count we can decide if we need to execute a test or not. */
+    return test_num == ts->curr_test_num;
+}
+
+
+/* Returns FCT_FALSE, and flags the suite, if the test with the dispatch
+ID was registered somewhere other than TEST_NUM. That is a test reached
+more than once, as one in a loop, which the registry only has once. */
+static nbool_t
+fct_ts__is_in_place(fct_ts_t *ts, int test_num, int id)
+{
+    FCT_ASSERT( ts != NULL );
+    if ( !ts->is_registered
+            || (test_num < ts->entry_num && ts->entries[test_num].id == id) )
+    {
+        return FCT_TRUE;
+    }
+    ts->is_misplaced = FCT_TRUE;
+    return FCT_FALSE;
+}
+
+
+/* Called at the bottom of each walk through the suite. A registered
+suite only gets here in test mode if its current test was not where it
+was registered, or if it has run them all and walked once more to look
+for tests out of place. Either way the suite is counted after all. */
+static void
+fct_ts__walk_end(fct_ts_t *ts)
+{
+    FCT_ASSERT( ts != NULL );
+    if ( !ts->is_registered || !fct_ts__is_test_mode(ts) )
+    {
+        return;
+    }
+    if ( ts->curr_test_num < ts->entry_num )
+    {
+        /* Its setup ran, so it is torn down first. */
+        ts->is_recount = FCT_TRUE;
+        ts->mode = ts_mode_teardown;
+    }
+    else if ( ts->is_misplaced )
+    {
+        fct_ts__recount(ts);
+    }
+    else
+    {
+        ts->mode = ts_mode_ending;
+    }
+}
+
+
+/* Returns the # of tests on the FCT TS object. This is the actual
+# of tests executed. */
+static size_t
+fct_ts__tst_cnt(fct_ts_t const *ts)
+{
+    FCT_ASSERT( ts != NULL );
+    FCT_ASSERT(
+        fct_ts__is_end(ts)
+        && "can't count number of tests executed until the test suite ends"
+    );
+    return fct_nlist__size(&(ts->test_list));
+}
+
+
+/* Returns the # of tests in the TS object that passed. */
+static size_t
+fct_ts__tst_cnt_passed(fct_ts_t const *ts)
+{
+    size_t tally =0;
+
+    FCT_ASSERT( ts != NULL );
+    FCT_ASSERT( fct_ts__is_end(ts) );
+
+    FCT_NLIST_FOREACH_BGN(fct_test_t*, test, &(ts->test_list))
+    {
+        if ( fct_test__is_pass(test) )
+        {
+            tally += 1;
+        }
+    }
+    FCT_NLIST_FOREACH_END();
+    return tally;
+}
+
+
+/* Returns the # of checks made throughout a test suite. */
+static size_t
+fct_ts__chk_cnt(fct_ts_t const *ts)
+{
+    size_t tally =0;
+
+    FCT_ASSERT( ts != NULL );
+
+    FCT_NLIST_FOREACH_BGN(fct_test_t *, test, &(ts->test_list))
+    {
+        tally += fct_test__chk_cnt(test);
+    }
+    FCT_NLIST_FOREACH_END();
+    return tally;
+}
+
+/* The wall clock time of the whole suite, fixtures and all, set as it
+ends. */
+static double
+fct_ts__duration(fct_ts_t const *ts)
+{
+    FCT_ASSERT( ts != NULL );
+    return fct_timer__duration(&(ts->timer));
+}
+
+#define fct_ts__stop_timer(ts)       fct_timer__stop(&((ts)->timer))
+#define fct_ts__cpu_duration(ts)     fct_timer__cpu_duration(&((ts)->timer))
+#define fct_ts__thread_duration(ts) \
+    fct_timer__thread_duration(&((ts)->timer))
+
+
+/*
+--------------------------------------------------------
+FCT COMMAND LINE OPTION INITIALIZATION (fctcl_init)
+--------------------------------------------------------
+
+Structure used for command line initialization. To keep it clear that we do
+not delete the char*'s present on this structure.
+*/
+
+
+typedef enum
+{
+    FCTCL_STORE_UNDEFINED,
+    FCTCL_STORE_TRUE,
+    FCTCL_STORE_VALUE
+} fctcl_store_t;
+
+
+typedef struct _fctcl_init_t
+{
+    /* What to parse for this option. --long versus -s. */
+    char const *long_opt;     /* i.e. --help */
+    char const *short_opt;    /* i.e. -h */
+
+    /* What action to take when the option is activated. */
+    fctcl_store_t action;
+
+    /* The help string for the action. */
+    char const *help;
+} fctcl_init_t;
+
+
+/* Use when defining the option list. */
+#define FCTCL_INIT_NULL  \
+    {NULL, NULL, FCTCL_STORE_UNDEFINED, NULL}
+
+
+/*
+--------------------------------------------------------
+FCT COMMAND LINE OPTION (fctcl)
+--------------------------------------------------------
+
+Specifies the command line configuration options. Use this
+to help initialize the fct_clp (command line parser).
+*/
+
+
+/* Handy strings for storing "true" and "false". We can reference
+these strings throughout the parse operation and not have to
+worry about dealing with memory. */
+#define FCTCL_TRUE_STR "1"
+
+
+typedef struct _fctcl_t
+{
+    /* What to parse for this option. --long versus -s. */
+    char *long_opt;     /* i.e. --help */
+    char *short_opt;    /* i.e. -h */
+
+    /* What action to take when the option is activated. */
+    fctcl_store_t action;
+
+    /* The help string for the action. */
+    char *help;
+
+    /* The result. */
+    char *value;
+} fctcl_t;
+
+
+#define fctcl_new()  ((fctcl_t*)fct_calloc(1, sizeof(fctcl_t)))
+
+
+static void
+fctcl__del(fctcl_t *clo)
+{
+    if ( clo == NULL )
+    {
+        return;
+    }
+    fct_free(clo->long_opt);
+    fct_free(clo->short_opt);
+    fct_free(clo->value);
+    fct_free(clo->help);
+    fct_free(clo);
+}
+
+
+static fctcl_t*
+fctcl_new2(fctcl_init_t const *clo_init)
+{
+    fctcl_t *clone = NULL;
+    int ok =0;
+    clone = fctcl_new();
+    if ( clone == NULL )
+    {
+        return NULL;
+    }
+    clone->action = clo_init->action;
+    if ( clo_init->help == NULL )
+    {
+        clone->help = NULL;
+    }
+    else
+    {
+        clone->help = fctstr_clone(clo_init->help);
+        if ( clone->help == NULL )
+        {
+            ok =0;
+            goto finally;
+        }
+    }
+    if ( clo_init->long_opt == NULL )
+    {
+        clone->long_opt = NULL;
+    }
+    else
+    {
+        clone->long_opt = fctstr_clone(clo_init->long_opt);
+        if ( clone->long_opt == NULL )
+        {
+            ok = 0;
+            goto finally;
+        }
+    }
+    if ( clo_init->short_opt == NULL )
+    {
+        clone->short_opt = NULL;
+    }
+    else
+    {
+        clone->short_opt = fctstr_clone(clo_init->short_opt);
+        if ( clone->short_opt == NULL )
+        {
+            ok =0;
+            goto finally;
+        }
+    }
+    ok = 1;
+finally:
+    if ( !ok )
+    {
+        fctcl__del(clone);
+        clone = NULL;
+    }
+    return clone;
+}
+
+
+static int
+fctcl__is_option(fctcl_t const *clo, char const *option)
+{
+    FCT_ASSERT( clo != NULL );
+    if ( option == NULL )
+    {
+        return 0;
+    }
+    return ((clo->long_opt != NULL
+             && fctstr_eq(clo->long_opt, option))
+            ||
+            (clo->short_opt != NULL
+             && fctstr_eq(clo->short_opt, option))
+           );
+}
+
+
+#define fctcl__set_value(_CLO_, _VAL_) \
+    (_CLO_)->value = fctstr_clone((_VAL_));
+
+/*
+--------------------------------------------------------
+FCT COMMAND PARSER (fct_clp)
+--------------------------------------------------------
+*/
+
+#define FCT_CLP_MAX_ERR_MSG_LEN     256
+
+typedef struct _fct_clp_t
+{
+    /* List of command line options. */
+    fct_nlist_t clo_list;
+
+    /* List of parameters (not options). */
+    fct_nlist_t param_list;
+
+    char error_msg[FCT_CLP_MAX_ERR_MSG_LEN];
+    int is_error;
+} fct_clp_t;
+
+
+static void
+fct_clp__final(fct_clp_t *clp)
+{
+    fct_nlist__final(&(clp->clo_list), (fct_nlist_on_del_t)fctcl__del);
+    fct_nlist__final(&(clp->param_list), (fct_nlist_on_del_t)fct_free_fn);
+}
+
+
+/* Add an configuration options. */
+static int
+fct_clp__add_options(fct_clp_t *clp, fctcl_init_t const *options)
+{
+    fctcl_init_t const *pclo =NULL;
+    int ok;
+    for ( pclo = options; pclo->action != FCTCL_STORE_UNDEFINED; ++pclo )
+    {
+        fctcl_t *cpy = fctcl_new2(pclo);
+        if ( cpy == NULL )
+        {
+            ok = 0;
+            goto finally;
+        }
+        fct_nlist__append(&(clp->clo_list), (void*)cpy);
+    }
+    ok =1;
+finally:
+    return ok;
+}
+
+/* Returns false if we ran out of memory. */
+static int
+fct_clp__init(fct_clp_t *clp, fctcl_init_t const *options)
+{
+    int ok =0;
+    FCT_ASSERT( clp != NULL );
+    /* It is just much saner to manage a clone of the options. Then we know
+    who is in charge of the memory. */
+    ok = fct_nlist__init(&(clp->clo_list));
+    if ( !ok )
+    {
+        goto finally;
+    }
+    if ( options != NULL )
+    {
+        ok = fct_clp__add_options(clp, options);
+        if ( !ok )
+        {
+            goto finally;
+        }
+    }
+    ok = fct_nlist__init(&(clp->param_list));
+    if ( !ok )
+    {
+        goto finally;
+    }
+    ok =1;
+finally:
+    if ( !ok )
+    {
+        fct_clp__final(clp);
+    }
+    return ok;
+}
+
+
+/* Parses the command line arguments. Use fct_clp__is_error and
+fct_clp__get_error to figure out if something went awry. */
+static void
+fct_clp__parse(fct_clp_t *clp, int argc, char const *argv[])
+{
+    int argi =1;
     int is_option =0;
     char *arg =NULL;
     char *token =NULL;
     char *next_token =NULL;
 
-    clp->error_msg[0] = '\0';
-    clp->is_error =0;
+    clp->error_msg[0] = '\0';
+    clp->is_error =0;
+
+    while ( argi < argc )
+    {
+        is_option =0;
+        token =NULL;
+        next_token = NULL;
+        arg = fctstr_clone(argv[argi]);
+
+#if defined(_MSC_VER) && _MSC_VER > 1300
+        token = strtok_s(arg, "=", &next_token);
+#else
+        token = strtok(arg, "=");
+        next_token = strtok(NULL, "=");
+#endif
+
+        FCT_NLIST_FOREACH_BGN(fctcl_t*, pclo, &(clp->clo_list))
+        {
+            /* Need to reset for each search. strtok below is destructive. */
+            if ( fctcl__is_option(pclo, token) )
+            {
+                is_option =1;
+                if ( pclo->action == FCTCL_STORE_VALUE )
+                {
+                    /* If this is --xxxx=value then the next strtok should succeed.
+                    Otherwise, we need to chew up the next argument. */
+                    if ( next_token != NULL && strlen(next_token) > 0 )
+                    {
+                        fctcl__set_value(pclo, next_token);
+                    }
+                    else
+                    {
+                        ++argi; /* Chew up the next value */
+                        if ( argi >= argc )
+                        {
+                            /* error */
+                            fct_snprintf(
+                                clp->error_msg,
+                                FCT_CLP_MAX_ERR_MSG_LEN,
+                                "missing argument for %s",
+                                token
+                            );
+                            clp->is_error =1;
+                            break;
+                        }
+                        fctcl__set_value(pclo, argv[argi]);
+                    }
+                }
+                else if (pclo->action == FCTCL_STORE_TRUE)
+                {
+                    fctcl__set_value(pclo, FCTCL_TRUE_STR);
+                }
+                else
+                {
+                    FCT_ASSERT("undefined action requested");
+                }
+                break;  /* No need to parse this argument further. */
+            }
+        }
+        FCT_NLIST_FOREACH_END();
+        /* If we have an error, exit. */
+        if ( clp->is_error )
+        {
+            break;
+        }
+        /* If we walked through all the options, and didn't find
+        anything, then we must have a parameter. Forget the fact that
+        an unknown option will be treated like a parameter... */
+        if ( !is_option )
+        {
+            fct_nlist__append(&(clp->param_list), arg);
+            arg =NULL;  /* Owned by the nlist */
+        }
+        ++argi;
+        if ( arg != NULL )
+        {
+            fct_free(arg);
+            arg =NULL;
+        }
+    }
+}
+
+
+static fctcl_t const*
+fct_clp__get_clo(fct_clp_t const *clp, char const *option)
+{
+    fctcl_t const *found =NULL;
+
+    FCT_NLIST_FOREACH_BGN(fctcl_t const*, pclo, &(clp->clo_list))
+    {
+        if ( fctcl__is_option(pclo, option) )
+        {
+            found = pclo;
+            break;
+        }
+    }
+    FCT_NLIST_FOREACH_END();
+    return found;
+}
+
+
+#define fct_clp__optval(_CLP_, _OPTION_) \
+    fct_clp__optval2((_CLP_), (_OPTION_), NULL)
+
+
+/* Returns the value parsed at the command line, and equal to OPTION.
+If the value wasn't parsed, the DEFAULT_VAL is returned instead. */
+static char const*
+fct_clp__optval2(fct_clp_t *clp, char const *option, char const *default_val)
+{
+    fctcl_t const *clo =NULL;
+    FCT_ASSERT( clp != NULL );
+    FCT_ASSERT( option != NULL );
+    clo = fct_clp__get_clo(clp, option);
+    if ( clo == NULL || clo->value == NULL)
+    {
+        return default_val;
+    }
+    return clo->value;
+}
+
+
+
+/* Mainly used for unit tests. */
+static int
+fct_clp__is_param(fct_clp_t *clp, char const *param)
+{
+    if ( clp == NULL || param == NULL )
+    {
+        return 0;
+    }
+    FCT_NLIST_FOREACH_BGN(char *, aparam, &(clp->param_list))
+    {
+        if ( fctstr_eq(aparam, param) )
+        {
+            return 1;
+        }
+    }
+    FCT_NLIST_FOREACH_END();
+    return 0;
+}
+
+
+#define fct_clp__is_error(_CLP_) ((_CLP_)->is_error)
+#define fct_clp__get_error(_CLP_) ((_CLP_)->error_msg);
+
+#define fct_clp__num_clo(_CLP_) \
+    (fct_nlist__size(&((_CLP_)->clo_list)))
+
+#define fct_clp__param_cnt(_CLP_) \
+    (fct_nlist__size(&((_CLP_)->param_list)))
+
+/* Returns a *reference* to the parameter at _IDX_. Do not modify
+its contents. */
+#define fct_clp__param_at(_CLP_, _IDX_) \
+    ((char const*)fct_nlist__at(&((_CLP_)->param_list), (_IDX_)))
+
+
+/* Returns true if the given option was on the command line.
+Use either the long or short option name to check against. */
+#define fct_clp__is(_CLP_, _OPTION_) \
+    (fct_clp__optval((_CLP_), (_OPTION_)) != NULL)
+
+
+
+/*
+--------------------------------------------------------
+TEST REGISTRY
+--------------------------------------------------------
+
+With FCT_CONF_REGISTRY each suite and test emits a static descriptor,
+and a pointer to it is placed in the "fct_tests" linker section. The
+kernel gathers these up at start up, so it knows every test before
+running anything, and a suite no longer needs a count pass. FCTMF
+suites are also registered (in "fct_mf_suites"), and any that are not
+called with FCTMF_SUITE_CALL are run at the end.
+
+A test that is reached more than once, as one in a loop, is registered
+only once. The suite notices as it is walked, and once all its tests
+have run it walks once more to be sure. A suite with such a test goes
+back to the count pass, without running any test twice. With --jobs the
+suites are always counted.
+*/
+
+typedef struct _fct_suite_desc_t
+{
+    char const *name;
+} fct_suite_desc_t;
+
+typedef struct _fct_test_desc_t
+{
+    fct_suite_desc_t const *suite;
+    char const *name;
+    /* Dispatch id, which also gives the order within the suite. */
+    int id;
+} fct_test_desc_t;
+
+typedef void (*fctmf_suite_fn)(fctkern_t *);
+typedef struct _fctmf_suite_desc_t
+{
+    char const *name;
+    fctmf_suite_fn fn;
+    int is_called;
+} fctmf_suite_desc_t;
+
+#if defined(FCT_REGISTRY)
+#   define _FCT_SECTION(_NAME_)  __attribute__((section(_NAME_), used))
+/* Provided by the linker, weak since the sections may be empty. */
+extern fct_test_desc_t const *const __start_fct_tests[]
+__attribute__((weak));
+extern fct_test_desc_t const *const __stop_fct_tests[]
+__attribute__((weak));
+extern fctmf_suite_desc_t *const __start_fct_mf_suites[]
+__attribute__((weak));
+extern fctmf_suite_desc_t *const __stop_fct_mf_suites[]
+__attribute__((weak));
+#endif /* FCT_REGISTRY */
+
+
+/*
+--------------------------------------------------------
+FCT NAMESPACE
+--------------------------------------------------------
+
+The macros below start to pollute the watch window with
+lots of "system" variables. This NAMESPACE is an
+attempt to hide all the "system" variables in one place.
+*/
+typedef struct _fct_namespace_t
+{
+    /* The currently active test suite. */
+    fct_ts_t *ts_curr;
+    int ts_is_skip_suite;
+    char const *ts_skip_cndtn;
+
+    /* Current test name. */
+    char const* curr_test_name;
+    fct_test_t *curr_test;
+    const char *test_skip_cndtn;
+    int test_is_skip;
+
+    /* Counts the number of tests in a test suite. */
+    int test_num;
+
+    /* Set at the end of the test suites. */
+    size_t num_total_failed;
+} fct_namespace_t;
+
+
+static void
+fct_namespace_init(fct_namespace_t *ns)
+{
+    FCT_ASSERT( ns != NULL && "invalid argument!");
+    memset(ns, 0, sizeof(fct_namespace_t));
+}
+
+
+/* State for running the tests in worker processes, see "PARALLEL JOBS".
+Zeroed when the tests run in this process. */
+#define FCT_MAX_JOBS 256
+
+typedef struct _fct_jobs_shm_t
+{
+    /* The next test sequence number to be claimed by a worker. */
+    int next_seq;
+    /* Set once a claim falls past the last test. */
+    int is_drained;
+    /* The test each worker is busy with, -1 once it has finished. */
+    int claims[FCT_MAX_JOBS];
+} fct_jobs_shm_t;
+
+typedef struct _fct_jobs_t
+{
+    /* Number of workers, 0 if we are not running with --jobs. */
+    int num;
+    /* The workers are forked once, see FCT_ZYGOTE_READY. */
+    nbool_t is_started;
+    /* Each test runs in a child forked just for it (--isolate). */
+    nbool_t is_isolate;
+    /* This worker, or -1 in the parent. */
+    int worker_id;
+    /* Every process numbers the selected tests in the same order. These
+    track the next number, and the numbers of the current suite. */
+    int seq_next;
+    int seq_bgn;
+    int seq_end;
+    /* Worker: the test we have claimed. */
+    int claim;
+    /* Worker: how many of the suite's tests have been written out. */
+    size_t num_streamed;
+    /* Read end of the result pipe in the parent, write end in a worker. */
+    int fd;
+    fct_jobs_shm_t *shm;
+    /* Parent: the worker process ids (0 once reaped), and the records
+    that arrived but have not been replayed yet. */
+    int *pids;
+    fct_nlist_t recs;
+} fct_jobs_t;
+
+
+/* State for running the FCTMF suites on a pool of threads, see "THREADED
+SUITES". */
+typedef struct _fct_threads_t
+{
+    /* Size of the pool, 0 if the suites run as they are called. */
+    int num;
+    /* The pool is started once, by the first FCTMF_SUITE_CALL. */
+    nbool_t is_started;
+    /* The fct_task_t's, in the order their suites where called. */
+    fct_nlist_t tasks;
+#if defined(FCT_THREADS)
+    /* Guards the tasks list, and all below. */
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    size_t next_task;
+    size_t num_done;
+    nbool_t is_closing;
+    pthread_t *pool;
+#endif /* FCT_THREADS */
+} fct_threads_t;
+
+
+/*
+--------------------------------------------------------
+FCT KERNEL
+--------------------------------------------------------
+
+The "fctkern" is a singleton that is defined throughout the
+system.
+*/
+
+/* A test from the --shard-plan file, as "suite.test", with the time it
+took and the shard it was packed into. */
+typedef struct _fct_shard_entry_t
+{
+    char *name;
+    double duration;
+    int shard;
+} fct_shard_entry_t;
+
+/* A benchmark from the --bench-baseline file, as "suite.test", with the
+samples it was measured with. */
+typedef struct _fct_bench_entry_t
+{
+    char *name;
+    fct_bench_stats_t stats;
+} fct_bench_entry_t;
+
+
+struct _fctkern_t
+{
+    /* Holds variables used throughout MACRO MAGIC. In order to reduce
+    the "noise" in the watch window during a debug trace. */
+    fct_namespace_t ns;
+
+    /* Command line parsing. */
+    fct_clp_t cl_parser;
+
+    /* Hold onto the command line arguments. */
+    int cl_argc;
+    char const **cl_argv;
+    /* Track user options. */
+    fctcl_init_t const *cl_user_opts;
+
+    /* Tracks the delay parsing. */
+    int cl_is_parsed;
+
+    /* This is an list of loggers that can be used in the fct system. */
+    fct_nlist_t logger_list;
+
+    /* Array of custom types, you have built-in system ones and you
+    have optionally supplied user ones.. */
+    fct_logger_types_t *lt_usr;
+    fct_logger_types_t *lt_sys;
+
+    /* This is a list of prefix's that can be used to determine if a
+    test is should be run or not. */
+    fct_nlist_t prefix_list;
+
+    /* The suites named with --run-suite, when empty every suite can run. */
+    fct_nlist_t suite_list;
+
+    /* Set by --shard-index and --shard-count, a count of 0 runs all. */
+    int shard_index;
+    int shard_count;
+
+    /* Read from --shard-plan, sorted by name. */
+    fct_shard_entry_t *shard_plan;
+    size_t shard_plan_num;
+
+    /* This is a list of test suites that where generated throughout the
+    testing process. Left empty with --stream. */
+    fct_nlist_t ts_list;
+
+    /* Set by --stream, each suite is freed once it is reported. */
+    nbool_t is_stream;
+
+    /* Set by --max-failures, 0 keeps every failure. */
+    size_t max_failures;
+
+    /* Set by --bench, and --bench-time in seconds. */
+    nbool_t is_bench;
+    double bench_time;
+
+    /* Opened for --bench-out, and written as each suite is added. */
+    FILE *bench_file;
+
+    /* Read from --bench-baseline, sorted by name, and how many percent
+    slower a benchmark may be, from --bench-threshold. */
+    fct_bench_entry_t *bench_baseline;
+    size_t bench_baseline_num;
+    double bench_threshold;
+
+    /* Set by --rusage. */
+    nbool_t is_rusage;
+
+    /* Running totals over the suites added so far. */
+    size_t num_tests;
+    size_t num_tests_passed;
+    size_t num_chks;
+
+    /* Opened for --timings-out, and written as each suite is added. */
+    FILE *timings_file;
+
+    /* Records what we expect to fail. */
+    size_t num_expected_failures;
+
+    /* The registered tests, sorted by suite and then by id. Empty unless
+    built with the registry. */
+    fct_test_desc_t const **reg_tests;
+    size_t reg_test_cnt;
+
+    /* Set up by --jobs. */
+    fct_jobs_t jobs;
+
+    /* Set up by --threads. */
+    fct_threads_t threads;
+};
+
+
+#define FCT_OPT_VERSION       "--version"
+#define FCT_OPT_VERSION_SHORT "-v"
+#define FCT_OPT_HELP          "--help"
+#define FCT_OPT_HELP_SHORT    "-h"
+#define FCT_OPT_LOGGER        "--logger"
+#define FCT_OPT_LOGGER_SHORT  "-l"
+#define FCT_OPT_LIST          "--list"
+#define FCT_OPT_RUN_SUITE     "--run-suite"
+#define FCT_OPT_JOBS          "--jobs"
+#define FCT_OPT_JOBS_SHORT    "-j"
+#define FCT_OPT_ISOLATE       "--isolate"
+#define FCT_OPT_THREADS       "--threads"
+#define FCT_OPT_SHARD_INDEX   "--shard-index"
+#define FCT_OPT_SHARD_COUNT   "--shard-count"
+#define FCT_OPT_SHARD_PLAN    "--shard-plan"
+#define FCT_OPT_TIMINGS_OUT   "--timings-out"
+#define FCT_OPT_STREAM        "--stream"
+#define FCT_OPT_MAX_FAILURES  "--max-failures"
+#define FCT_OPT_BENCH         "--bench"
+#define FCT_OPT_BENCH_TIME    "--bench-time"
+#define FCT_OPT_BENCH_OUT     "--bench-out"
+#define FCT_OPT_BENCH_BASELINE "--bench-baseline"
+#define FCT_OPT_BENCH_THRESHOLD "--bench-threshold"
+#define FCT_OPT_RUSAGE        "--rusage"
+static fctcl_init_t FCT_CLP_OPTIONS[] =
+{
+    /* Totally unsafe, since we are assuming we can clean out this data,
+    what I need to do is have an "initialization" object, full of
+    const objects. But for now, this should work. */
+    {
+        FCT_OPT_VERSION,
+        FCT_OPT_VERSION_SHORT,
+        FCTCL_STORE_TRUE,
+        "Displays the FCTX version number and exits."
+    },
+    {
+        FCT_OPT_HELP,
+        FCT_OPT_HELP_SHORT,
+        FCTCL_STORE_TRUE,
+        "Shows this help."
+    },
+    {
+        FCT_OPT_LOGGER,
+        FCT_OPT_LOGGER_SHORT,
+        FCTCL_STORE_VALUE,
+        NULL
+    },
+    {
+        FCT_OPT_RUN_SUITE,
+        NULL,
+        FCTCL_STORE_VALUE,
+        "Only runs the test suites with these names (comma separated)."
+    },
+    {
+        FCT_OPT_JOBS,
+        FCT_OPT_JOBS_SHORT,
+        FCTCL_STORE_VALUE,
+        "Runs the tests in this many worker processes."
+    },
+    {
+        FCT_OPT_ISOLATE,
+        NULL,
+        FCTCL_STORE_TRUE,
+        "Runs each test in a fresh process, forked from FCT_ZYGOTE_READY."
+    },
+    {
+        FCT_OPT_SHARD_INDEX,
+        NULL,
+        FCTCL_STORE_VALUE,
+        "Runs only this shard of the tests, from 0 to --shard-count less 1."
+    },
+    {
+        FCT_OPT_SHARD_COUNT,
+        NULL,
+        FCTCL_STORE_VALUE,
+        "Splits the tests into this many shards, by a hash of their names."
+    },
+    {
+        FCT_OPT_SHARD_PLAN,
+        NULL,
+        FCTCL_STORE_VALUE,
+        "Splits the shards by the test times in this --timings-out file."
+    },
+    {
+        FCT_OPT_TIMINGS_OUT,
+        NULL,
+        FCTCL_STORE_VALUE,
+        "Writes the time each test took to this file."
+    },
+    {
+        FCT_OPT_STREAM,
+        NULL,
+        FCTCL_STORE_TRUE,
+        "Frees each test suite once it is reported, to run in flat memory."
+    },
+    {
+        FCT_OPT_MAX_FAILURES,
+        NULL,
+        FCTCL_STORE_VALUE,
+        "Keeps this many failures for each test, the rest are only counted."
+    },
+    {
+        FCT_OPT_BENCH,
+        NULL,
+        FCTCL_STORE_TRUE,
+        "Measures the benchmarks, otherwise they run once as a test."
+    },
+    {
+        FCT_OPT_BENCH_TIME,
+        NULL,
+        FCTCL_STORE_VALUE,
+        "Measures each benchmark for about this many seconds."
+    },
+    {
+        FCT_OPT_BENCH_OUT,
+        NULL,
+        FCTCL_STORE_VALUE,
+        "Writes the samples of each benchmark to this file."
+    },
+    {
+        FCT_OPT_BENCH_BASELINE,
+        NULL,
+        FCTCL_STORE_VALUE,
+        "Fails the benchmarks that are slower than in this --bench-out file."
+    },
+    {
+        FCT_OPT_BENCH_THRESHOLD,
+        NULL,
+        FCTCL_STORE_VALUE,
+        "How many percent slower than its baseline a benchmark may be."
+    },
+    {
+        FCT_OPT_RUSAGE,
+        NULL,
+        FCTCL_STORE_TRUE,
+        "Shows the CPU time, memory, page faults and context switches "
+        "of each test and suite."
+    },
+#if defined(FCT_THREADS)
+    {
+        FCT_OPT_THREADS,
+        NULL,
+        FCTCL_STORE_VALUE,
+        "Runs the FCTMF suites on this many threads."
+    },
+#endif /* FCT_THREADS */
+#if defined(FCT_REGISTRY)
+    {
+        FCT_OPT_LIST,
+        NULL,
+        FCTCL_STORE_TRUE,
+        "Lists the tests that pass the filters, as suite.test, and exits."
+    },
+#endif /* FCT_REGISTRY */
+    FCTCL_INIT_NULL /* Sentinel */
+};
+
+typedef fct_logger_i* (*fct_logger_new_fn)(void);
+struct _fct_logger_types_t
+{
+    char const *name;
+    fct_logger_new_fn logger_new_fn;
+    char const *desc;
+};
+
+static fct_logger_types_t FCT_LOGGER_TYPES[] =
+{
+    {
+        "standard",
+        (fct_logger_new_fn)fct_standard_logger_new,
+        "the basic fctx logger"
+    },
+    {
+        "minimal",
+        (fct_logger_new_fn)fct_minimal_logger_new,
+        "the least amount of logging information."
+    },
+    {
+        "junit",
+        (fct_logger_new_fn)fct_junit_logger_new,
+        "junit compatible xml"
+    },
+    {NULL, (fct_logger_new_fn)NULL, NULL} /* Sentinel */
+};
+
+
+/* Returns the number of filters defined for the fct kernel. */
+#define fctkern__filter_cnt(_NK_) (fct_nlist__size(&((_NK_)->prefix_list)))
+
+/* True once the test holds as many failures as --max-failures keeps. */
+#define fctkern__is_test_full(_NK_, _TEST_) \
+    ((_NK_)->max_failures > 0 \
+     && fct_nlist__size(&((_TEST_)->failed_chks)) >= (_NK_)->max_failures)
+
+
+static void
+fctkern__add_logger(fctkern_t *nk, fct_logger_i *logger_owns)
+{
+    FCT_ASSERT(nk != NULL && "invalid arg");
+    FCT_ASSERT(logger_owns != NULL && "invalid arg");
+    fct_nlist__append(&(nk->logger_list), logger_owns);
+}
+
+
+static void
+fctkern__write_help(fctkern_t *nk, FILE *out)
+{
+    fct_clp_t *clp = &(nk->cl_parser);
+    fprintf(out, "test.exe [options] [suite.]prefix_filter ...\n\n");
+    FCT_NLIST_FOREACH_BGN(fctcl_t*, clo, &(clp->clo_list))
+    {
+        if ( clo->short_opt != NULL )
+        {
+            fprintf(out, "%s, %s\n", clo->short_opt, clo->long_opt);
+        }
+        else
+        {
+            fprintf(out, "%s\n", clo->long_opt);
+        }
+        if ( !fctstr_ieq(clo->long_opt, FCT_OPT_LOGGER) )
+        {
+            /* For now lets not get to fancy with the text wrapping. */
+            fprintf(out, "  %s\n", clo->help);
+        }
+        else
+        {
+            fct_logger_types_t *types[2];
+            int type_i;
+            fct_logger_types_t *itr;
+            types[0] = nk->lt_sys;
+            types[1] = nk->lt_usr;
+            fputs("  Sets the logger. The types of loggers currently "
+                  "available are,\n", out);
+            for (type_i =0; type_i != 2; ++type_i )
+            {
+                for ( itr=types[type_i]; itr && itr->name != NULL; ++itr )
+                {
+                    fprintf(out, "   =%s : %s\n", itr->name, itr->desc);
+                }
+            }
+            fprintf(out, "  default is '%s'.\n", FCT_DEFAULT_LOGGER);
+        }
+    }
+    FCT_NLIST_FOREACH_END();
+    fputs("\n", out);
+}
+
+
+/* Appends a prefix filter that is used to determine if a test can
+be executed or not. If the test starts with the same characters as
+the prefix, then it should be "runnable". The prefix filter must be
+a non-NULL, non-Blank string. */
+static void
+fctkern__add_prefix_filter(fctkern_t *nk, char const *prefix_filter)
+{
+    char *filter =NULL;
+    size_t filter_len =0;
+    FCT_ASSERT( nk != NULL && "invalid arg" );
+    FCT_ASSERT( prefix_filter != NULL && "invalid arg" );
+    FCT_ASSERT( strlen(prefix_filter) > 0 && "invalid arg" );
+    /* First we make a copy of the prefix, then we store it away
+    in our little list. */
+    filter_len = strlen(prefix_filter);
+    filter = (char*)fct_malloc(sizeof(char)*(filter_len+1));
+    fctstr_safe_cpy(filter, prefix_filter, filter_len+1);
+    fct_nlist__append(&(nk->prefix_list), (void*)filter);
+}
+
+
+/* Adds the suites named in the comma separated SUITE_NAMES to the list
+of suites that can run. */
+static void
+fctkern__add_suite_filter(fctkern_t *nk, char const *suite_names)
+{
+    char const *name_bgn =NULL;
+    char const *name_end =NULL;
+    FCT_ASSERT( nk != NULL && "invalid arg" );
+    FCT_ASSERT( suite_names != NULL && "invalid arg" );
+    for ( name_bgn = suite_names; *name_bgn != '\0'; name_bgn = name_end )
+    {
+        size_t name_len =0;
+        char *name =NULL;
+        name_end = strchr(name_bgn, ',');
+        if ( name_end == NULL )
+        {
+            name_end = name_bgn + strlen(name_bgn);
+        }
+        name_len = (size_t)(name_end - name_bgn);
+        if ( name_len > 0 )
+        {
+            name = (char*)fct_malloc(sizeof(char)*(name_len+1));
+            FCT_ASSERT( name != NULL );
+            memcpy(name, name_bgn, name_len);
+            name[name_len] = '\0';
+            fct_nlist__append(&(nk->suite_list), (void*)name);
+        }
+        if ( *name_end == ',' )
+        {
+            ++name_end;
+        }
+    }
+}
+
+
+static nbool_t
+fctkern__pass_suite_filter(fctkern_t *nk, char const *suite_name);
+
+static nbool_t
+fctkern__pass_filter2(fctkern_t *nk,
+                      char const *suite_name,
+                      char const *test_name);
+
+static void
+fctkern__jobs_select(fctkern_t *nk, fct_ts_t *ts);
+
+static nbool_t
+fctkern__pass_shard(fctkern_t const *nk,
+                    char const *suite_name,
+                    char const *test_name);
+
+static nbool_t
+fctkern__load_shard_plan(fctkern_t *nk, char const *path);
+
+static nbool_t
+fctkern__load_bench_baseline(fctkern_t *nk, char const *path);
+
+
+/* Writes out every registered test that passes the filters. */
+static void
+fctkern__write_list(fctkern_t *nk, FILE *out)
+{
+    size_t test_i =0;
+    FCT_ASSERT( nk != NULL );
+    for ( test_i =0; test_i != nk->reg_test_cnt; ++test_i )
+    {
+        fct_test_desc_t const *desc = nk->reg_tests[test_i];
+        if ( fctkern__pass_suite_filter(nk, desc->suite->name)
+                && fctkern__pass_filter2(nk, desc->suite->name, desc->name)
+                && fctkern__pass_shard(nk, desc->suite->name, desc->name) )
+        {
+            fprintf(out, "%s.%s\n", desc->suite->name, desc->name);
+        }
+    }
+}
+
+
+/* Cleans up the contents of a fctkern. NULL does nothing. */
+static void
+fctkern__final(fctkern_t *nk)
+{
+    if ( nk == NULL )
+    {
+        return;
+    }
+    fct_clp__final(&(nk->cl_parser));
+    fct_nlist__final(&(nk->logger_list), (fct_nlist_on_del_t)fct_logger__del);
+    /* The prefix list is a list of malloc'd strings. */
+    fct_nlist__final(&(nk->prefix_list), (fct_nlist_on_del_t)fct_free_fn);
+    fct_nlist__final(&(nk->suite_list), (fct_nlist_on_del_t)fct_free_fn);
+    fct_nlist__final(&(nk->ts_list), (fct_nlist_on_del_t)fct_ts__del);
+    fct_nlist__final(&(nk->jobs.recs), (fct_nlist_on_del_t)fct_free_fn);
+    fct_nlist__final(&(nk->threads.tasks), NULL);
+    if ( nk->shard_plan != NULL )
+    {
+        size_t plan_i =0;
+        for ( plan_i =0; plan_i != nk->shard_plan_num; ++plan_i )
+        {
+            fct_free(nk->shard_plan[plan_i].name);
+        }
+        fct_free(nk->shard_plan);
+        nk->shard_plan = NULL;
+        nk->shard_plan_num = 0;
+    }
+    if ( nk->bench_baseline != NULL )
+    {
+        size_t entry_i =0;
+        for ( entry_i =0; entry_i != nk->bench_baseline_num; ++entry_i )
+        {
+            fct_free(nk->bench_baseline[entry_i].name);
+        }
+        fct_free(nk->bench_baseline);
+        nk->bench_baseline = NULL;
+        nk->bench_baseline_num = 0;
+    }
+    if ( nk->reg_tests != NULL )
+    {
+        fct_free((void*)nk->reg_tests);
+        nk->reg_tests = NULL;
+    }
+}
+
+
+#define fctkern__cl_is_parsed(_NK_) ((_NK_)->cl_is_parsed)
+
+
+static int
+fctkern__cl_is(fctkern_t *nk, char const *opt_str)
+{
+    FCT_ASSERT( opt_str != NULL );
+    return opt_str[0] != '\0'
+           && fct_clp__is(&(nk->cl_parser), opt_str);
+}
+
+
+/* Returns the command line value given by OPT_STR. If OPT_STR was not defined
+at the command line, DEF_STR is returned (you can use NULL for the DEF_STR).
+The result returned should not be modified, and MAY even be the same pointer
+to DEF_STR. */
+static char const *
+fctkern__cl_val2(fctkern_t *nk, char const *opt_str, char const *def_str)
+{
+    FCT_ASSERT( opt_str != NULL );
+    if ( nk == NULL )
+    {
+        return NULL;
+    }
+    return fct_clp__optval2(&(nk->cl_parser), opt_str, def_str);
+}
+
+
+/* Selects a logger from the list based on the selection name.
+May return NULL if the name doesn't exist in the list. */
+static fct_logger_i*
+fckern_sel_log(fct_logger_types_t *search, char const *sel_logger)
+{
+    fct_logger_types_t *iter;
+    FCT_ASSERT(search != NULL);
+    FCT_ASSERT(sel_logger != NULL);
+    FCT_ASSERT(strlen(sel_logger) > 0);
+    for ( iter = search; iter->name != NULL; ++iter)
+    {
+        if ( fctstr_ieq(iter->name, sel_logger) )
+        {
+            return iter->logger_new_fn();
+        }
+    }
+    return NULL;
+}
+
+static int
+fctkern__cl_parse_config_logger(fctkern_t *nk)
+{
+    fct_logger_i *logger =NULL;
+    char const *sel_logger =NULL;
+    char const *def_logger =FCT_DEFAULT_LOGGER;
+    sel_logger = fctkern__cl_val2(nk, FCT_OPT_LOGGER, def_logger);
+    FCT_ASSERT(sel_logger != NULL && "should never be NULL");
+    /* First search the user selected types, then search the
+    built-in types. */
+    if ( nk->lt_usr != NULL )
+    {
+        logger = fckern_sel_log(nk->lt_usr, sel_logger);
+    }
+    if ( nk->lt_sys != NULL && logger == NULL )
+    {
+        logger = fckern_sel_log(nk->lt_sys, sel_logger);
+    }
+    if ( logger == NULL )
+    {
+        /* No logger configured, you must have supplied an invalid selection. */
+        fprintf(stderr, "error: unknown logger selected - '%s'", sel_logger);
+        return 0;
+    }
+    fctkern__add_logger(nk, logger);
+    logger = NULL;  /* owned by nk. */
+    return 1;
+}
+
+
+
+/* Call this if you want to (re)parse the command line options with a new
+set of options. Returns -1 if you are to abort with EXIT_SUCCESS, returns
+0 if you are to abort with EXIT_FAILURE and returns 1 if you are to continue. */
+static int
+fctkern__cl_parse(fctkern_t *nk)
+{
+    int status =0;
+    size_t num_params =0;
+    size_t param_i =0;
+    if ( nk == NULL )
+    {
+        return 0;
+    }
+    if ( nk->cl_user_opts != NULL )
+    {
+        if ( !fct_clp__add_options(&(nk->cl_parser), nk->cl_user_opts) )
+        {
+            status =0;
+            goto finally;
+        }
+    }
+    /* You want to add the "house options" after the user defined ones. The
+    options are stored as a list so it means that any option listed after
+    the above ones won't get parsed. */
+    if ( !fct_clp__add_options(&(nk->cl_parser), FCT_CLP_OPTIONS) )
+    {
+        status =0;
+        goto finally;
+    }
+    fct_clp__parse(&(nk->cl_parser), nk->cl_argc, nk->cl_argv);
+    if ( fct_clp__is_error(&(nk->cl_parser)) )
+    {
+        char *err = fct_clp__get_error(&(nk->cl_parser));
+        fprintf(stderr, "error: %s", err);
+        status =0;
+        goto finally;
+    }
+    num_params = fct_clp__param_cnt(&(nk->cl_parser));
+    for ( param_i =0; param_i != num_params; ++param_i )
+    {
+        char const *param = fct_clp__param_at(&(nk->cl_parser), param_i);
+        fctkern__add_prefix_filter(nk, param);
+    }
+    if ( fctkern__cl_is(nk, FCT_OPT_RUN_SUITE) )
+    {
+        fctkern__add_suite_filter(nk, fctkern__cl_val2(nk, FCT_OPT_RUN_SUITE, ""));
+    }
+    if ( fctkern__cl_is(nk, FCT_OPT_SHARD_COUNT)
+            || fctkern__cl_is(nk, FCT_OPT_SHARD_INDEX) )
+    {
+        nk->shard_count = atoi(fctkern__cl_val2(nk, FCT_OPT_SHARD_COUNT, "0"));
+        nk->shard_index = atoi(fctkern__cl_val2(nk, FCT_OPT_SHARD_INDEX, "0"));
+        if ( nk->shard_count < 1
+                || nk->shard_index < 0
+                || nk->shard_index >= nk->shard_count )
+        {
+            fprintf(stderr,
+                    "error: %s must be from 0 to %s less 1.\n",
+                    FCT_OPT_SHARD_INDEX,
+                    FCT_OPT_SHARD_COUNT);
+            status =0;
+            goto finally;
+        }
+        if ( fctkern__cl_is(nk, FCT_OPT_SHARD_PLAN)
+                && !fctkern__load_shard_plan(
+                    nk, fctkern__cl_val2(nk, FCT_OPT_SHARD_PLAN, "")
+                ) )
+        {
+            status =0;
+            goto finally;
+        }
+    }
+    else if ( fctkern__cl_is(nk, FCT_OPT_SHARD_PLAN) )
+    {
+        fprintf(stderr,
+                "error: %s needs %s and %s.\n",
+                FCT_OPT_SHARD_PLAN,
+                FCT_OPT_SHARD_COUNT,
+                FCT_OPT_SHARD_INDEX);
+        status =0;
+        goto finally;
+    }
+    if ( fctkern__cl_is(nk, FCT_OPT_VERSION) )
+    {
+        (void)printf("Built using FCTX version %s.\n", FCT_VERSION_STR);
+        status = -1;
+        goto finally;
+    }
+    if ( fctkern__cl_is(nk, FCT_OPT_HELP) )
+    {
+        fctkern__write_help(nk, stdout);
+        status = -1;
+        goto finally;
+    }
+    if ( fctkern__cl_is(nk, FCT_OPT_LIST) )
+    {
+        fctkern__write_list(nk, stdout);
+        status = -1;
+        goto finally;
+    }
+    if ( !fctkern__cl_parse_config_logger(nk) )
+    {
+        status = -1;
+        goto finally;
+    }
+    nk->is_stream = fctkern__cl_is(nk, FCT_OPT_STREAM);
+    if ( fctkern__cl_is(nk, FCT_OPT_MAX_FAILURES) )
+    {
+        int max_failures =
+            atoi(fctkern__cl_val2(nk, FCT_OPT_MAX_FAILURES, "-1"));
+        if ( max_failures < 0 )
+        {
+            fprintf(stderr, "error: %s must be 0 or more.\n",
+                    FCT_OPT_MAX_FAILURES);
+            status =0;
+            goto finally;
+        }
+        nk->max_failures = (size_t)max_failures;
+    }
+    nk->is_bench = fctkern__cl_is(nk, FCT_OPT_BENCH);
+    nk->is_rusage = fctkern__cl_is(nk, FCT_OPT_RUSAGE);
+    if ( fctkern__cl_is(nk, FCT_OPT_BENCH_TIME) )
+    {
+        nk->bench_time = atof(fctkern__cl_val2(nk, FCT_OPT_BENCH_TIME, "0"));
+        if ( nk->bench_time <= 0.0 )
+        {
+            fprintf(stderr, "error: %s must be more than 0.\n",
+                    FCT_OPT_BENCH_TIME);
+            status =0;
+            goto finally;
+        }
+    }
+    if ( fctkern__cl_is(nk, FCT_OPT_BENCH_THRESHOLD) )
+    {
+        nk->bench_threshold =
+            atof(fctkern__cl_val2(nk, FCT_OPT_BENCH_THRESHOLD, "-1"));
+        if ( nk->bench_threshold < 0.0 )
+        {
+            fprintf(stderr, "error: %s must be 0 or more.\n",
+                    FCT_OPT_BENCH_THRESHOLD);
+            status =0;
+            goto finally;
+        }
+    }
+    if ( fctkern__cl_is(nk, FCT_OPT_BENCH_BASELINE)
+            && !fctkern__load_bench_baseline(
+                nk, fctkern__cl_val2(nk, FCT_OPT_BENCH_BASELINE, "")
+            ) )
+    {
+        status =0;
+        goto finally;
+    }
+    if ( fctkern__cl_is(nk, FCT_OPT_BENCH_OUT) )
+    {
+        char const *path = fctkern__cl_val2(nk, FCT_OPT_BENCH_OUT, "");
+        nk->bench_file = fopen(path, "w");
+        if ( nk->bench_file == NULL )
+        {
+            fprintf(stderr, "error: unable to write %s '%s'.\n",
+                    FCT_OPT_BENCH_OUT, path);
+            status =0;
+            goto finally;
+        }
+    }
+    if ( fctkern__cl_is(nk, FCT_OPT_TIMINGS_OUT) )
+    {
+        char const *path = fctkern__cl_val2(nk, FCT_OPT_TIMINGS_OUT, "");
+        nk->timings_file = fopen(path, "w");
+        if ( nk->timings_file == NULL )
+        {
+            fprintf(stderr, "error: unable to write %s '%s'.\n",
+                    FCT_OPT_TIMINGS_OUT, path);
+            status =0;
+            goto finally;
+        }
+    }
+    status =1;
+    nk->cl_is_parsed =1;
+finally:
+    return status;
+}
+
+
+
+#if defined(FCT_REGISTRY)
+/* Orders registered tests by suite, then by their order in the suite. */
+static int
+fct_test_desc__cmp(void const *a, void const *b)
+{
+    fct_test_desc_t const *da = *(fct_test_desc_t const * const *)a;
+    fct_test_desc_t const *db = *(fct_test_desc_t const * const *)b;
+    if ( da->suite != db->suite )
+    {
+        return ((size_t)da->suite < (size_t)db->suite) ? -1 : 1;
+    }
+    return (da->id < db->id) ? -1 : (da->id > db->id);
+}
+#endif /* FCT_REGISTRY */
+
+
+/* Collects the test descriptors out of the linker section, and sorts
+them so a suite can find its tests with a binary search. */
+static void
+fctkern__registry_init(fctkern_t *nk)
+{
+    FCT_ASSERT( nk != NULL );
+    nk->reg_tests = NULL;
+    nk->reg_test_cnt = 0;
+#if defined(FCT_REGISTRY)
+    {
+        fct_test_desc_t const *const *bgn = __start_fct_tests;
+        fct_test_desc_t const *const *end = __stop_fct_tests;
+        fct_test_desc_t const *const *itr =NULL;
+        if ( bgn == NULL || bgn == end )
+        {
+            return;
+        }
+        nk->reg_tests = (fct_test_desc_t const **)fct_malloc(
+                            sizeof(fct_test_desc_t const*) * (size_t)(end - bgn)
+                        );
+        FCT_ASSERT( nk->reg_tests != NULL );
+        for ( itr = bgn; itr != end; ++itr )
+        {
+            /* The linker can leave gaps, or zero padding. */
+            if ( *itr != NULL )
+            {
+                nk->reg_tests[nk->reg_test_cnt++] = *itr;
+            }
+        }
+        qsort((void*)nk->reg_tests,
+              nk->reg_test_cnt,
+              sizeof(fct_test_desc_t const*),
+              fct_test_desc__cmp);
+    }
+#endif /* FCT_REGISTRY */
+}
+
+
+/* Parses the command line and sets up the framework. The argc and argv
+should be directly from the program's main. */
+static int
+fctkern__init(fctkern_t *nk, int argc, const char *argv[])
+{
+    if ( argc == 0 && argv == NULL )
+    {
+        return 0;
+    }
+    memset(nk, 0, sizeof(fctkern_t));
+    fct_clp__init(&(nk->cl_parser), NULL);
+    fct_nlist__init(&(nk->logger_list));
+    nk->lt_usr = NULL;  /* Supplied via 'install' mechanics. */
+    nk->lt_sys = FCT_LOGGER_TYPES;
+    fct_nlist__init2(&(nk->prefix_list), 0);
+    fct_nlist__init2(&(nk->suite_list), 0);
+    fct_nlist__init2(&(nk->ts_list), 0);
+    nk->cl_is_parsed =0;
+    nk->max_failures = FCT_MAX_FAILURES;
+    nk->bench_time = FCT_BENCH_TIME;
+    nk->bench_threshold = FCT_BENCH_THRESHOLD;
+    nk->jobs.worker_id = -1;
+    nk->jobs.fd = -1;
+    fct_nlist__init2(&(nk->jobs.recs), 0);
+    fct_nlist__init2(&(nk->threads.tasks), 0);
+    /* Save a copy of the arguments. We do a delay parse of the command
+    line arguments in order to allow the client code to optionally configure
+    the command line parser.*/
+    nk->cl_argc = argc;
+    nk->cl_argv = argv;
+    fct_namespace_init(&(nk->ns));
+    fctkern__registry_init(nk);
+    return 1;
+}
+
+
+/* Takes OWNERSHIP of the test suite after we have finished executing
+and reporting its contents. Its tests are added to the running totals,
+and their times to the --timings-out file. The suite is kept for the
+summaries at the end of a run, or freed here with --stream. */
+static void
+fctkern__add_ts(fctkern_t *nk, fct_ts_t *ts)
+{
+    FCT_ASSERT( nk != NULL );
+    FCT_ASSERT( ts != NULL );
+    nk->num_tests += fct_ts__tst_cnt(ts);
+    nk->num_tests_passed += fct_ts__tst_cnt_passed(ts);
+    nk->num_chks += fct_ts__chk_cnt(ts);
+    /* Only the parent writes the times, a worker's are sent to it. */
+    if ( nk->timings_file != NULL && nk->jobs.worker_id < 0 )
+    {
+        FCT_NLIST_FOREACH_BGN(fct_test_t*, test, &(ts->test_list))
+        {
+            /* The fixture is part of what a test costs a shard. */
+            fprintf(nk->timings_file, "%s.%s %f\n",
+                    fct_ts__name(ts),
+                    fct_test__name(test),
+                    fct_test__setup_duration(test)
+                    + fct_test__duration(test)
+                    + fct_test__teardown_duration(test));
+        }
+        FCT_NLIST_FOREACH_END();
+    }
+    if ( nk->bench_file != NULL && nk->jobs.worker_id < 0 )
+    {
+        FCT_NLIST_FOREACH_BGN(fct_test_t*, test, &(ts->test_list))
+        {
+            if ( test->bench != NULL )
+            {
+                fprintf(nk->bench_file, "%s.%s ",
+                        fct_ts__name(ts), fct_test__name(test));
+                fct_bench_stats__write(test->bench, nk->bench_file);
+            }
+        }
+        FCT_NLIST_FOREACH_END();
+    }
+    if ( nk->is_stream )
+    {
+        fct_ts__del(ts);
+        return;
+    }
+    fct_nlist__append(&(nk->ts_list), ts);
+}
+
+
+/* Decides which tests in the suite will be run, once the suite knows
+all its tests. This is done up front so tests that are filtered out
+never cost a setup and teardown. */
+static void
+fctkern__select_tests(fctkern_t *nk, fct_ts_t *ts)
+{
+    int entry_i =0;
+    FCT_ASSERT( nk != NULL );
+    FCT_ASSERT( ts != NULL );
+    if ( fctkern__filter_cnt(nk) > 0 || nk->shard_count > 0 )
+    {
+        for ( entry_i =0; entry_i != ts->entry_num; ++entry_i )
+        {
+            fct_ts_entry_t *entry = &(ts->entries[entry_i]);
+            entry->is_selected = fctkern__pass_filter2(
+                                     nk, fct_ts__name(ts), entry->name
+                                 )
+                                 && fctkern__pass_shard(
+                                     nk, fct_ts__name(ts), entry->name
+                                 );
+        }
+    }
+    if ( nk->jobs.num > 0 )
+    {
+        fctkern__jobs_select(nk, ts);
+    }
+}
+
+
+/* Takes the tests for SUITE from the registry, in place of a count
+pass. The suite moves on as if it had just finished counting. */
+static void
+fctkern__registry_prime(fctkern_t *nk,
+                        fct_ts_t *ts,
+                        fct_suite_desc_t const *suite)
+{
+    size_t lo =0;
+    size_t hi =0;
+    FCT_ASSERT( nk != NULL );
+    FCT_ASSERT( ts != NULL );
+    FCT_ASSERT( fct_ts__is_cnt_mode(ts) );
+    /* The parent of the --jobs never walks the suite, so it would not
+    notice a test out of place. */
+    if ( nk->jobs.num > 0 )
+    {
+        return;
+    }
+    hi = nk->reg_test_cnt;
+    /* Find the first test belonging to this suite. */
+    while ( lo < hi )
+    {
+        size_t mid = lo + (hi - lo)/2;
+        if ( (size_t)nk->reg_tests[mid]->suite < (size_t)suite )
+        {
+            lo = mid+1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    for ( ; lo < nk->reg_test_cnt && nk->reg_tests[lo]->suite == suite; ++lo )
+    {
+        fct_ts__inc_total_test_num(ts);
+        fct_ts__add_entry(ts, nk->reg_tests[lo]->name, nk->reg_tests[lo]->id);
+    }
+    ts->is_registered = FCT_TRUE;
+    fctkern__select_tests(nk, ts);
+    fct_ts__cnt_end(ts);
+}
+
+
+/* Runs any registered FCTMF suites that where never called with
+FCTMF_SUITE_CALL. */
+static void
+fctkern__registry_call_mf(fctkern_t *nk)
+{
+#if defined(FCT_REGISTRY)
+    fctmf_suite_desc_t *const *bgn = __start_fct_mf_suites;
+    fctmf_suite_desc_t *const *end = __stop_fct_mf_suites;
+    fctmf_suite_desc_t *const *itr =NULL;
+    if ( bgn == NULL )
+    {
+        return;
+    }
+    for ( itr = bgn; itr != end; ++itr )
+    {
+        if ( *itr != NULL && !(*itr)->is_called
+                && fctkern__pass_suite_filter(nk, (*itr)->name) )
+        {
+            (*itr)->fn(nk);
+        }
+    }
+#else
+    fct_unused(nk);
+#endif /* FCT_REGISTRY */
+}
+
+
+/* Returns FCT_TRUE if a suite called SUITE_NAME could have tests to run:
+it must be named by --run-suite (if given), and a plain prefix filter
+or a filter qualified with this suite must exist (if any filters are
+given). This is cheap, and done before the suite does anything. */
+static nbool_t
+fctkern__pass_suite_filter(fctkern_t *nk, char const *suite_name)
+{
+    size_t prefix_list_size =0;
+    FCT_ASSERT( nk != NULL && "invalid arg");
+    FCT_ASSERT( suite_name != NULL );
+    if ( fct_nlist__size(&(nk->suite_list)) > 0 )
+    {
+        nbool_t is_named = FCT_FALSE;
+        FCT_NLIST_FOREACH_BGN(char const*, name, &(nk->suite_list))
+        {
+            if ( fctstr_eq(name, suite_name) )
+            {
+                is_named = FCT_TRUE;
+                break;
+            }
+        }
+        FCT_NLIST_FOREACH_END();
+        if ( !is_named )
+        {
+            return FCT_FALSE;
+        }
+    }
+    prefix_list_size = fctkern__filter_cnt(nk);
+    if ( prefix_list_size == 0 )
+    {
+        return FCT_TRUE;
+    }
+    FCT_NLIST_FOREACH_BGN(char const*, prefix, &(nk->prefix_list))
+    {
+        size_t suite_len = fct_filter_suite_len(prefix);
+        if ( suite_len == 0
+                || fct_filter_is_suite(prefix, suite_len, suite_name) )
+        {
+            return FCT_TRUE;
+        }
+    }
+    FCT_NLIST_FOREACH_END();
+    return FCT_FALSE;
+}
+
+
+/* Returns FCT_TRUE if the supplied test_name, within the suite called
+suite_name, passes the filters. If there are no filters, we return
+FCT_TRUE always. The suite_name can be NULL, then only the plain prefix
+filters are used. */
+static nbool_t
+fctkern__pass_filter2(fctkern_t *nk,
+                      char const *suite_name,
+                      char const *test_name)
+{
+    size_t prefix_i =0;
+    size_t prefix_list_size =0;
+    FCT_ASSERT( nk != NULL && "invalid arg");
+    FCT_ASSERT( test_name != NULL );
+    FCT_ASSERT( strlen(test_name) > 0 );
+    prefix_list_size = fctkern__filter_cnt(nk);
+    /* If there is no filter list, then we return FCT_TRUE always. */
+    if ( prefix_list_size == 0 )
+    {
+        return FCT_TRUE;
+    }
+    /* Iterate through the prefix filter list, and see if we have
+    anything that does not pass. All we require is ONE item that
+    passes the test in order for us to succeed here. */
+    for ( prefix_i = 0; prefix_i != prefix_list_size; ++prefix_i )
+    {
+        char const *prefix = (char const*)fct_nlist__at(
+                                 &(nk->prefix_list), prefix_i
+                             );
+        nbool_t pass = fct_filter_pass2(prefix, suite_name, test_name);
+        if ( pass )
+        {
+            return FCT_TRUE;
+        }
+    }
+    /* Otherwise, we never managed to find a prefix that satisfied the
+    supplied test name. Therefore we have failed to pass to the filter
+    list test. */
+    return FCT_FALSE;
+}
+
+
+/* Returns FCT_TRUE if the supplied test_name passes the plain prefix
+filters. */
+static nbool_t
+fctkern__pass_filter(fctkern_t *nk, char const *test_name)
+{
+    return fctkern__pass_filter2(nk, NULL, test_name);
+}
+
+
+/* A 32 bit FNV-1a hash of "suite.test". It only depends on the names,
+so every machine splits the tests the same way. */
+static unsigned long
+fct_shard_hash(char const *suite_name, char const *test_name)
+{
+    unsigned long hash =2166136261UL;
+    char const *itr =NULL;
+    for ( itr = suite_name; *itr != '\0'; ++itr )
+    {
+        hash = ((hash ^ (unsigned char)*itr) * 16777619UL) & 0xffffffffUL;
+    }
+    hash = ((hash ^ (unsigned char)'.') * 16777619UL) & 0xffffffffUL;
+    for ( itr = test_name; *itr != '\0'; ++itr )
+    {
+        hash = ((hash ^ (unsigned char)*itr) * 16777619UL) & 0xffffffffUL;
+    }
+    /* The low bits of FNV-1a only depend on the low bits of the name,
+    so mix every bit into every other, with the finalizer of
+    MurmurHash3. */
+    hash ^= hash >> 16;
+    hash = (hash * 0x85ebca6bUL) & 0xffffffffUL;
+    hash ^= hash >> 13;
+    hash = (hash * 0xc2b2ae35UL) & 0xffffffffUL;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+
+/* Compares NAME to "suite.test", as strcmp would, without having to
+build the second string. */
+static int
+fct_shard_name_cmp(char const *name,
+                   char const *suite_name,
+                   char const *test_name)
+{
+    size_t suite_len = strlen(suite_name);
+    int cmp = strncmp(name, suite_name, suite_len);
+    if ( cmp != 0 )
+    {
+        return cmp;
+    }
+    if ( name[suite_len] != '.' )
+    {
+        return (int)(unsigned char)name[suite_len] - (int)'.';
+    }
+    return strcmp(name + suite_len + 1, test_name);
+}
+
+
+static int
+fct_shard_entry__cmp_name(void const *a, void const *b)
+{
+    return strcmp(((fct_shard_entry_t const*)a)->name,
+                  ((fct_shard_entry_t const*)b)->name);
+}
+
+
+/* Longest first, and by name when the times are the same, so every
+machine packs the tests the same way. */
+static int
+fct_shard_entry__cmp_duration(void const *a, void const *b)
+{
+    fct_shard_entry_t const *ea = (fct_shard_entry_t const*)a;
+    fct_shard_entry_t const *eb = (fct_shard_entry_t const*)b;
+    if ( ea->duration > eb->duration )
+    {
+        return -1;
+    }
+    if ( ea->duration < eb->duration )
+    {
+        return 1;
+    }
+    return strcmp(ea->name, eb->name);
+}
+
+
+/* Reads the "suite.test seconds" lines written by --timings-out. The
+files from several shards can simply be joined, a test that shows up
+more than once keeps its longest time. Then packs the tests into the
+shards, longest first, each into the shard with the least time so far.
+Returns FCT_FALSE if the file can not be read. */
+static nbool_t
+fctkern__load_shard_plan(fctkern_t *nk, char const *path)
+{
+    FILE *file =NULL;
+    char line[2*FCT_MAX_NAME + 32];
+    fct_shard_entry_t *plan =NULL;
+    size_t plan_num =0;
+    size_t plan_avail =0;
+    size_t plan_i =0;
+    double *loads =NULL;
+    nbool_t is_ok =FCT_FALSE;
+    FCT_ASSERT( nk != NULL );
+    FCT_ASSERT( path != NULL );
+    file = fopen(path, "r");
+    if ( file == NULL )
+    {
+        fprintf(stderr, "error: unable to read %s '%s'.\n",
+                FCT_OPT_SHARD_PLAN, path);
+        goto finally;
+    }
+    while ( fgets(line, sizeof(line), file) != NULL )
+    {
+        char *sep =NULL;
+        if ( strchr(line, '\n') == NULL && !feof(file) )
+        {
+            /* Too long to be one of ours, its tail is not a line. */
+            int ch =0;
+            while ( (ch = fgetc(file)) != EOF && ch != '\n' )
+            {
+                fct_pass();
+            }
+            continue;
+        }
+        sep = strrchr(line, ' ');
+        if ( sep == NULL || sep == line )
+        {
+            continue;
+        }
+        *sep = '\0';
+        if ( plan_num == plan_avail )
+        {
+            plan_avail = plan_avail*2 + 64;
+            plan = (fct_shard_entry_t*)fct_realloc(
+                       plan, sizeof(fct_shard_entry_t)*plan_avail
+                   );
+            FCT_ASSERT( plan != NULL && "memory check" );
+        }
+        plan[plan_num].name = fctstr_clone(line);
+        plan[plan_num].duration = strtod(sep+1, NULL);
+        plan[plan_num].shard = 0;
+        ++plan_num;
+    }
+    /* Collapse the repeats. */
+    if ( plan_num > 0 )
+    {
+        size_t keep_i =0;
+        qsort(plan, plan_num, sizeof(fct_shard_entry_t),
+              fct_shard_entry__cmp_name);
+        for ( plan_i =1; plan_i != plan_num; ++plan_i )
+        {
+            if ( fctstr_eq(plan[plan_i].name, plan[keep_i].name) )
+            {
+                if ( plan[plan_i].duration > plan[keep_i].duration )
+                {
+                    plan[keep_i].duration = plan[plan_i].duration;
+                }
+                fct_free(plan[plan_i].name);
+            }
+            else
+            {
+                plan[++keep_i] = plan[plan_i];
+            }
+        }
+        plan_num = keep_i+1;
+    }
+    loads = (double*)fct_calloc((size_t)nk->shard_count, sizeof(double));
+    FCT_ASSERT( loads != NULL && "memory check" );
+    qsort(plan, plan_num, sizeof(fct_shard_entry_t),
+          fct_shard_entry__cmp_duration);
+    for ( plan_i =0; plan_i != plan_num; ++plan_i )
+    {
+        int shard_i =0;
+        int least_i =0;
+        for ( shard_i =1; shard_i != nk->shard_count; ++shard_i )
+        {
+            if ( loads[shard_i] < loads[least_i] )
+            {
+                least_i = shard_i;
+            }
+        }
+        plan[plan_i].shard = least_i;
+        loads[least_i] += plan[plan_i].duration;
+    }
+    qsort(plan, plan_num, sizeof(fct_shard_entry_t),
+          fct_shard_entry__cmp_name);
+    nk->shard_plan = plan;
+    nk->shard_plan_num = plan_num;
+    plan = NULL;
+    is_ok =FCT_TRUE;
+finally:
+    if ( file != NULL )
+    {
+        fclose(file);
+    }
+    if ( loads != NULL )
+    {
+        fct_free(loads);
+    }
+    if ( plan != NULL )
+    {
+        for ( plan_i =0; plan_i != plan_num; ++plan_i )
+        {
+            fct_free(plan[plan_i].name);
+        }
+        fct_free(plan);
+    }
+    return is_ok;
+}
+
+
+static int
+fct_bench_entry__cmp_name(void const *a, void const *b)
+{
+    return strcmp(((fct_bench_entry_t const*)a)->name,
+                  ((fct_bench_entry_t const*)b)->name);
+}
+
+
+/* Reads the "suite.test batch samples..." lines written by --bench-out.
+Returns FCT_FALSE if the file can not be read. */
+static nbool_t
+fctkern__load_bench_baseline(fctkern_t *nk, char const *path)
+{
+    FILE *file =NULL;
+    char line[2*FCT_MAX_NAME + 32*FCT_BENCH_SAMPLES];
+    fct_bench_entry_t *entries =NULL;
+    size_t entry_num =0;
+    size_t entry_avail =0;
+    FCT_ASSERT( nk != NULL );
+    FCT_ASSERT( path != NULL );
+    file = fopen(path, "r");
+    if ( file == NULL )
+    {
+        fprintf(stderr, "error: unable to read %s '%s'.\n",
+                FCT_OPT_BENCH_BASELINE, path);
+        return FCT_FALSE;
+    }
+    while ( fgets(line, sizeof(line), file) != NULL )
+    {
+        fct_bench_entry_t *entry =NULL;
+        char *end =NULL;
+        char *sep = strchr(line, ' ');
+        if ( sep == NULL || sep == line )
+        {
+            continue;
+        }
+        *sep = '\0';
+        if ( entry_num == entry_avail )
+        {
+            entry_avail = entry_avail*2 + 16;
+            entries = (fct_bench_entry_t*)fct_realloc(
+                          entries, sizeof(fct_bench_entry_t)*entry_avail
+                      );
+            FCT_ASSERT( entries != NULL && "memory check" );
+        }
+        entry = &(entries[entry_num]);
+        memset(entry, 0, sizeof(fct_bench_entry_t));
+        entry->stats.batch = (size_t)strtoul(sep+1, &end, 10);
+        fct_bench_stats__read_samples(&(entry->stats), end+1);
+        if ( entry->stats.num_samples == 0 )
+        {
+            continue;
+        }
+        entry->name = fctstr_clone(line);
+        FCT_ASSERT( entry->name != NULL && "memory check" );
+        ++entry_num;
+    }
+    fclose(file);
+    qsort(entries, entry_num, sizeof(fct_bench_entry_t),
+          fct_bench_entry__cmp_name);
+    nk->bench_baseline = entries;
+    nk->bench_baseline_num = entry_num;
+    return FCT_TRUE;
+}
+
+
+/* Returns the --bench-baseline entry for the test, or NULL. */
+static fct_bench_entry_t const *
+fctkern__find_bench_baseline(fctkern_t const *nk,
+                             char const *suite_name,
+                             char const *test_name)
+{
+    size_t lo =0;
+    size_t hi =0;
+    FCT_ASSERT( nk != NULL );
+    hi = nk->bench_baseline_num;
+    while ( lo < hi )
+    {
+        size_t mid = lo + (hi - lo)/2;
+        fct_bench_entry_t const *entry = &(nk->bench_baseline[mid]);
+        int cmp = fct_shard_name_cmp(entry->name, suite_name, test_name);
+        if ( cmp == 0 )
+        {
+            return entry;
+        }
+        if ( cmp < 0 )
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return NULL;
+}
+
+
+/* Returns FCT_TRUE if the test falls in our shard. Each test falls in
+exactly one shard, so the shards never overlap and together cover all
+the tests. A test in the --shard-plan goes where it was packed, any
+other by the hash of its name. Without --shard-count every test
+passes. */
+static nbool_t
+fctkern__pass_shard(fctkern_t const *nk,
+                    char const *suite_name,
+                    char const *test_name)
+{
+    FCT_ASSERT( nk != NULL );
+    FCT_ASSERT( suite_name != NULL && test_name != NULL );
+    if ( nk->shard_count <= 1 )
+    {
+        return FCT_TRUE;
+    }
+    if ( nk->shard_plan_num > 0 )
+    {
+        size_t lo =0;
+        size_t hi =nk->shard_plan_num;
+        while ( lo < hi )
+        {
+            size_t mid = lo + (hi - lo)/2;
+            fct_shard_entry_t const *entry = &(nk->shard_plan[mid]);
+            int cmp = fct_shard_name_cmp(entry->name, suite_name, test_name);
+            if ( cmp == 0 )
+            {
+                return entry->shard == nk->shard_index;
+            }
+            if ( cmp < 0 )
+            {
+                lo = mid+1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+    }
+    /* Scales the hash to the count, rather than taking it modulo the
+    count, so the shard comes from the high bits. Done in a double,
+    which holds the product exactly, for want of 64 bit integers. */
+    return (int)((double)fct_shard_hash(suite_name, test_name)
+                 * (double)nk->shard_count / 4294967296.0)
+           == nk->shard_index;
+}
+
+
+/* Returns the number of tests that were performed. */
+static size_t
+fctkern__tst_cnt(fctkern_t const *nk)
+{
+    FCT_ASSERT( nk != NULL );
+    return nk->num_tests;
+}
+
+
+/* Returns the number of tests that passed. */
+static size_t
+fctkern__tst_cnt_passed(fctkern_t const *nk)
+{
+    FCT_ASSERT( nk != NULL );
+    return nk->num_tests_passed;
+}
+
 
-    while ( argi < argc )
+/* Returns the number of tests that failed. */
+#define fctkern__tst_cnt_failed(nk) \
+    (fctkern__tst_cnt(nk) - fctkern__tst_cnt_passed(nk))
+
+
+/* Returns the number of checks made throughout the entire test. */
+#if defined(FCT_USE_TEST_COUNT)
+static size_t
+fctkern__chk_cnt(fctkern_t const *nk)
+{
+    FCT_ASSERT( nk != NULL );
+    return nk->num_chks;
+}
+#endif /* FCT_USE_TEST_COUNT */
+
+
+/* Indicates the very end of all the tests. Closes the --timings-out
+file, which holds a "suite.test seconds" line for every test, and the
+--bench-out file. */
+static void
+fctkern__end(fctkern_t *nk)
+{
+    FCT_ASSERT( nk != NULL );
+    if ( nk->timings_file != NULL )
     {
-        is_option =0;
-        token =NULL;
-        next_token = NULL;
-        arg = fctstr_clone(argv[argi]);
+        fclose(nk->timings_file);
+        nk->timings_file = NULL;
+    }
+    if ( nk->bench_file != NULL )
+    {
+        fclose(nk->bench_file);
+        nk->bench_file = NULL;
+    }
+}
 
-#if defined(_MSC_VER) && _MSC_VER > 1300
-        token = strtok_s(arg, "=", &next_token);
-#else
-        token = strtok(arg, "=");
-        next_token = strtok(NULL, "=");
-#endif
 
-        FCT_NLIST_FOREACH_BGN(fctcl_t*, pclo, &(clp->clo_list))
+static void
+fctkern__log_suite_start(fctkern_t *nk, fct_ts_t const *ts)
+{
+    FCT_ASSERT( nk != NULL );
+    FCT_ASSERT( ts != NULL );
+    FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, &(nk->logger_list))
+    {
+        fct_logger__on_test_suite_start(logger, ts);
+    }
+    FCT_NLIST_FOREACH_END();
+}
+
+
+static void
+fctkern__log_suite_end(fctkern_t *nk, fct_ts_t const *ts)
+{
+    FCT_ASSERT( nk != NULL );
+    FCT_ASSERT( ts != NULL );
+    FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, &(nk->logger_list))
+    {
+        fct_logger__on_test_suite_end(logger, ts);
+    }
+    FCT_NLIST_FOREACH_END();
+}
+
+
+static void
+fctkern__log_suite_skip(fctkern_t *nk, char const *condition, char const *name)
+{
+    if ( nk == NULL )
+    {
+        return;
+    }
+    FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, &(nk->logger_list))
+    {
+        fct_logger__on_test_suite_skip(logger, condition, name);
+    }
+    FCT_NLIST_FOREACH_END();
+}
+
+
+static void
+fctkern__log_test_skip(fctkern_t *nk, char const *condition, char const *name)
+{
+    FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, &(nk->logger_list))
+    {
+        fct_logger__on_test_skip(logger, condition, name);
+    }
+    FCT_NLIST_FOREACH_END();
+}
+
+
+/* Use this for displaying information about a "Check" (i.e.
+a condition). */
+static void
+fctkern__log_chk(fctkern_t *nk, fctchk_t const *chk)
+{
+    FCT_ASSERT( nk != NULL );
+    FCT_ASSERT( chk != NULL );
+    FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, &(nk->logger_list))
+    {
+        fct_logger__on_chk(logger, chk);
+    }
+    FCT_NLIST_FOREACH_END();
+}
+
+
+/* Adds the checks that other threads made during the test, and logs
+them, a thread at a time. Call from the thread that owns the test, once
+the other threads are done with it. */
+static void
+fctkern__merge_chk_bufs(fctkern_t *nk, fct_test_t *test)
+{
+#if defined(FCT_CHK_THREADS)
+    fct_chk_buf_t *buf =NULL;
+    fct_chk_buf_t *next =NULL;
+    FCT_ASSERT( nk != NULL );
+    if ( test == NULL )
+    {
+        return;
+    }
+    for ( buf = fct_test__take_chk_bufs(test); buf != NULL; buf = next )
+    {
+        next = buf->next;
+        FCT_NLIST_FOREACH_BGN(fctchk_t*, chk, &(buf->chks))
         {
-            /* Need to reset for each search. strtok below is destructive. */
-            if ( fctcl__is_option(pclo, token) )
+            if ( !fctchk__is_pass(chk) && fctkern__is_test_full(nk, test) )
             {
-                is_option =1;
-                if ( pclo->action == FCTCL_STORE_VALUE )
-                {
-                    /* If this is --xxxx=value then the next strtok should succeed.
-                    Otherwise, we need to chew up the next argument. */
-                    if ( next_token != NULL && strlen(next_token) > 0 )
-                    {
-                        fctcl__set_value(pclo, next_token);
-                    }
-                    else
-                    {
-                        ++argi; /* Chew up the next value */
-                        if ( argi >= argc )
-                        {
-                            /* error */
-                            fct_snprintf(
-                                clp->error_msg,
-                                FCT_CLP_MAX_ERR_MSG_LEN,
-                                "missing argument for %s",
-                                token
-                            );
-                            clp->is_error =1;
-                            break;
-                        }
-                        fctcl__set_value(pclo, argv[argi]);
-                    }
-                }
-                else if (pclo->action == FCTCL_STORE_TRUE)
-                {
-                    fctcl__set_value(pclo, FCTCL_TRUE_STR);
-                }
-                else
-                {
-                    FCT_ASSERT("undefined action requested");
-                }
-                break;  /* No need to parse this argument further. */
+                ++(test->num_dropped);
+                fctchk__del(chk);
+                continue;
             }
+            fctkern__log_chk(nk, chk);
+            fct_test__add(test, chk);
         }
         FCT_NLIST_FOREACH_END();
-        /* If we have an error, exit. */
-        if ( clp->is_error )
+        /* The checks now belong to the test. */
+        fct_nlist__final(&(buf->chks), NULL);
+        fct_free(buf);
+    }
+#else
+    fct_unused(nk);
+    fct_unused(test);
+#endif /* FCT_CHK_THREADS */
+}
+
+
+/* Use this for displaying warning messages. */
+static void
+fctkern__log_warn(fctkern_t *nk, char const *warn)
+{
+    FCT_ASSERT( nk != NULL );
+    FCT_ASSERT( warn != NULL );
+    FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, &(nk->logger_list))
+    {
+        fct_logger__on_warn(logger, warn);
+    }
+    FCT_NLIST_FOREACH_END();
+}
+
+
+/* Called after the test end of a benchmark that was measured. */
+static void
+fctkern__log_bench(fctkern_t *nk, fct_test_t const *test)
+{
+    FCT_ASSERT( nk != NULL );
+    FCT_ASSERT( test != NULL );
+    FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, &(nk->logger_list))
+    {
+        fct_logger__on_bench(logger, test);
+    }
+    FCT_NLIST_FOREACH_END();
+}
+
+
+/* Called whenever a test is started. */
+static void
+fctkern__log_test_start(fctkern_t *nk, fct_test_t const *test)
+{
+    FCT_ASSERT( nk != NULL );
+    FCT_ASSERT( test != NULL );
+    FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, &(nk->logger_list))
+    {
+        fct_logger__on_test_start(logger, test);
+    }
+    FCT_NLIST_FOREACH_END();
+}
+
+
+static void
+fctkern__log_test_end(fctkern_t *nk, fct_test_t *test)
+{
+    FCT_ASSERT( nk != NULL );
+    FCT_ASSERT( test != NULL );
+    FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, &(nk->logger_list))
+    {
+        fct_logger__on_test_end(logger, test);
+    }
+    FCT_NLIST_FOREACH_END();
+    if ( test->bench != NULL )
+    {
+        fctkern__log_bench(nk, test);
+    }
+    /* A worker leaves it to the parent. */
+    if ( test->num_dropped > 0 && nk->jobs.worker_id < 0 )
+    {
+        char msg[FCT_MAX_LOG_LINE];
+        fct_snprintf(msg,
+                     sizeof(msg),
+                     "%s: %lu more failures were only counted (%s %lu)",
+                     fct_test__name(test),
+                     (unsigned long)test->num_dropped,
+                     FCT_OPT_MAX_FAILURES,
+                     (unsigned long)nk->max_failures);
+        fctkern__log_warn(nk, msg);
+    }
+}
+
+
+#define fctkern__log_start(_NK_) \
+   {\
+       FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, &((_NK_)->logger_list))\
+       {\
+          fct_logger__on_fctx_start(logger, (_NK_));\
+       }\
+       FCT_NLIST_FOREACH_END();\
+   }
+
+
+#define fctkern__log_end(_NK_) \
+    {\
+       FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, &((_NK_)->logger_list))\
+       {\
+          fct_logger__on_fctx_end(logger, (_NK_));\
+       }\
+       FCT_NLIST_FOREACH_END();\
+    }
+
+
+/*
+-----------------------------------------------------------
+BENCHMARK
+-----------------------------------------------------------
+A benchmark is a test whose body is run over and over, in batches. It
+runs once, like any other test, unless --bench is given. Then the batch
+is grown until it takes long enough to time well, while warming up for
+a tenth of --bench-time. Then up to FCT_BENCH_SAMPLES batches are
+timed, or fewer once --bench-time is used up. A benchmark that fails a
+check stops there and is not reported.
+
+With --bench-baseline a benchmark fails a check if its median is more
+than --bench-threshold percent slower than the baseline's, and a
+one sided Mann-Whitney U test of the two sets of samples finds it slower
+at the 5% level. Both are needed, so a small but steady slow down, or a
+large but noisy one, does not break the build.
+*/
+
+enum
+{
+    FCT_BENCH_START =0,
+    FCT_BENCH_ONCE,
+    FCT_BENCH_WARMUP,
+    FCT_BENCH_MEASURE,
+    FCT_BENCH_DONE
+};
+
+/* The fewest batches timed before --bench-time cuts it short. */
+#define FCT_BENCH_MIN_SAMPLES  10
+
+/* A batch this size is long enough, even if the compiler threw the
+body away. */
+#define FCT_BENCH_MAX_BATCH    ((size_t)1000000000)
+
+typedef struct _fct_bench_t fct_bench_t;
+struct _fct_bench_t
+{
+    fctkern_t const *kern;
+    fct_test_t *test;
+    int phase;
+    /* The iterations to run in the next batch. */
+    size_t batch;
+    /* When the phase, and the batch, began. */
+    fct_tick_t phase_start;
+    fct_tick_t batch_start;
+    fct_bench_stats_t stats;
+    /* Why it failed against its --bench-baseline. */
+    char msg[FCT_MAX_LOG_LINE];
+};
+
+
+static void
+fct_bench__init(fct_bench_t *bench, fctkern_t const *nk, fct_test_t *test)
+{
+    FCT_ASSERT( bench != NULL );
+    FCT_ASSERT( nk != NULL );
+    memset(bench, 0, sizeof(fct_bench_t));
+    bench->kern = nk;
+    bench->test = test;
+    bench->phase = FCT_BENCH_START;
+    bench->batch = 1;
+}
+
+
+/* Returns the size of the next warm up batch, for one of BATCH that took
+SECS when we want it to take TARGET. Grows by at most 10 times. */
+static size_t
+fct_bench__grow(size_t batch, double secs, double target)
+{
+    double next =0.0;
+    if ( secs <= 0.0 || target / secs > 10.0 )
+    {
+        return batch * 10;
+    }
+    next = (double)batch * (target / secs) * 1.1;
+    if ( next < (double)(batch + 1) )
+    {
+        return batch + 1;
+    }
+    return (size_t)next;
+}
+
+
+/* Ends the batch that was running, if any. Returns true while the body
+should run another batch of BENCH->batch iterations. */
+static nbool_t
+fct_bench__next(fct_bench_t *bench)
+{
+    fct_tick_t now;
+    double secs =0.0;
+    double bench_time =0.0;
+    FCT_ASSERT( bench != NULL );
+    fct_tick__wall(&now);
+    if ( bench->phase == FCT_BENCH_MEASURE )
+    {
+        fct_perf__stop(&(bench->stats.perf));
+    }
+    secs = fct_tick__diff(&now, &(bench->batch_start));
+    bench_time = bench->kern->bench_time;
+    switch ( bench->phase )
+    {
+    case FCT_BENCH_START:
+        bench->phase = (bench->kern->is_bench) ?
+                       FCT_BENCH_WARMUP : FCT_BENCH_ONCE;
+        bench->phase_start = now;
+        break;
+    case FCT_BENCH_WARMUP:
+        bench->stats.num_warmup_iters += bench->batch;
+        if ( secs < bench_time / FCT_BENCH_SAMPLES
+                && bench->batch < FCT_BENCH_MAX_BATCH )
         {
-            break;
+            bench->batch = fct_bench__grow(bench->batch,
+                                           secs,
+                                           bench_time / FCT_BENCH_SAMPLES);
         }
-        /* If we walked through all the options, and didn't find
-        anything, then we must have a parameter. Forget the fact that
-        an unknown option will be treated like a parameter... */
-        if ( !is_option )
+        else if ( fct_tick__diff(&now, &(bench->phase_start))
+                  >= bench_time / 10.0 )
         {
-            fct_nlist__append(&(clp->param_list), arg);
-            arg =NULL;  /* Owned by the nlist */
+            bench->phase = FCT_BENCH_MEASURE;
+            bench->phase_start = now;
         }
-        ++argi;
-        if ( arg != NULL )
+        break;
+    case FCT_BENCH_MEASURE:
+        bench->stats.samples[bench->stats.num_samples++] =
+            secs * 1000000000.0 / (double)bench->batch;
+        if ( bench->stats.num_samples == FCT_BENCH_SAMPLES
+                || (bench->stats.num_samples >= FCT_BENCH_MIN_SAMPLES
+                    && fct_tick__diff(&now, &(bench->phase_start))
+                    >= bench_time) )
         {
-            free(arg);
-            arg =NULL;
+            bench->phase = FCT_BENCH_DONE;
         }
+        break;
+    default:
+        bench->phase = FCT_BENCH_DONE;
+        break;
+    }
+    if ( bench->test == NULL || !fct_test__is_pass(bench->test) )
+    {
+        bench->phase = FCT_BENCH_DONE;
+    }
+    if ( bench->phase == FCT_BENCH_DONE )
+    {
+        return FCT_FALSE;
     }
+    if ( bench->phase == FCT_BENCH_MEASURE )
+    {
+        fct_perf__start(&(bench->stats.perf));
+    }
+    fct_tick__wall(&(bench->batch_start));
+    return FCT_TRUE;
 }
 
 
-static fctcl_t const*
-fct_clp__get_clo(fct_clp_t const *clp, char const *option)
-{
-    fctcl_t const *found =NULL;
-
-    FCT_NLIST_FOREACH_BGN(fctcl_t const*, pclo, &(clp->clo_list))
+/* Returns the z score of a Mann-Whitney U test that the NEW samples
+are greater than the OLD ones. Ties share the average of their ranks. */
+static double
+fct_bench__mann_whitney_z(fct_bench_stats_t const *new_stats,
+                          fct_bench_stats_t const *old_stats)
+{
+    double n1 = (double)new_stats->num_samples;
+    double n2 = (double)old_stats->num_samples;
+    double u =0.0;
+    double sd =0.0;
+    size_t new_i =0;
+    size_t old_i =0;
+    /* U counts the pairs where the new sample is the greater. */
+    for ( new_i =0; new_i != new_stats->num_samples; ++new_i )
     {
-        if ( fctcl__is_option(pclo, option) )
+        for ( old_i =0; old_i != old_stats->num_samples; ++old_i )
         {
-            found = pclo;
-            break;
+            double x = new_stats->samples[new_i];
+            double y = old_stats->samples[old_i];
+            u += (x > y) ? 1.0 : ((x < y) ? 0.0 : 0.5);
         }
     }
-    FCT_NLIST_FOREACH_END();
-    return found;
+    sd = fct_bench__sqrt(n1 * n2 * (n1 + n2 + 1.0) / 12.0);
+    if ( sd <= 0.0 )
+    {
+        return 0.0;
+    }
+    return (u - n1 * n2 / 2.0) / sd;
 }
 
 
-#define fct_clp__optval(_CLP_, _OPTION_) \
-    fct_clp__optval2((_CLP_), (_OPTION_), NULL)
-
-
-/* Returns the value parsed at the command line, and equal to OPTION.
-If the value wasn't parsed, the DEFAULT_VAL is returned instead. */
-static char const*
-fct_clp__optval2(fct_clp_t *clp, char const *option, char const *default_val)
-{
-    fctcl_t const *clo =NULL;
-    FCT_ASSERT( clp != NULL );
-    FCT_ASSERT( option != NULL );
-    clo = fct_clp__get_clo(clp, option);
-    if ( clo == NULL || clo->value == NULL)
+/* Compares the benchmark with its --bench-baseline. Returns -1 if there
+is nothing to compare, or else FCT_TRUE if it is no slower. If it is
+slower, BENCH->msg says by how much. */
+static int
+fct_bench__chk_baseline(fct_bench_t *bench)
+{
+    fct_bench_entry_t const *entry =NULL;
+    fct_bench_stats_t const *stats =NULL;
+    double limit =0.0;
+    double z =0.0;
+    FCT_ASSERT( bench != NULL );
+    if ( bench->test == NULL
+            || bench->test->bench == NULL
+            || bench->kern->bench_baseline_num == 0 )
     {
-        return default_val;
+        return -1;
     }
-    return clo->value;
+    entry = fctkern__find_bench_baseline(bench->kern,
+                                         fct_ts__name(bench->kern->ns.ts_curr),
+                                         fct_test__name(bench->test));
+    if ( entry == NULL )
+    {
+        return -1;
+    }
+    stats = bench->test->bench;
+    limit = entry->stats.median * (1.0 + bench->kern->bench_threshold / 100.0);
+    z = fct_bench__mann_whitney_z(stats, &(entry->stats));
+    /* 1.645 is the one sided 5% point of the normal distribution. */
+    if ( stats->median <= limit || z < 1.645 )
+    {
+        return FCT_TRUE;
+    }
+    fct_snprintf(bench->msg,
+                 sizeof(bench->msg),
+                 "%s: median %.2f ns/op is %.1f%% slower than the baseline "
+                 "%.2f ns/op (%s %.1f%%, z %.2f)",
+                 entry->name,
+                 stats->median,
+                 (stats->median / entry->stats.median - 1.0) * 100.0,
+                 entry->stats.median,
+                 FCT_OPT_BENCH_THRESHOLD,
+                 bench->kern->bench_threshold,
+                 z);
+    return FCT_FALSE;
 }
 
 
-
-/* Mainly used for unit tests. */
-static int
-fct_clp__is_param(fct_clp_t *clp, char const *param)
+/* Hands what was measured to the test, if the benchmark ran to the
+end. */
+static void
+fct_bench__end(fct_bench_t *bench)
 {
-    if ( clp == NULL || param == NULL )
+    fct_bench_stats_t *stats =NULL;
+    FCT_ASSERT( bench != NULL );
+    if ( bench->stats.num_samples == 0
+            || bench->test == NULL
+            || !fct_test__is_pass(bench->test) )
     {
-        return 0;
+        return;
     }
-    FCT_NLIST_FOREACH_BGN(char *, aparam, &(clp->param_list))
+    bench->stats.batch = bench->batch;
+    fct_bench_stats__update(&(bench->stats));
+    if ( bench->test->arena != NULL )
     {
-        if ( fctstr_eq(aparam, param) )
-        {
-            return 1;
-        }
+        stats = (fct_bench_stats_t*)fct_arena__alloc(
+                    bench->test->arena, sizeof(fct_bench_stats_t)
+                );
     }
-    FCT_NLIST_FOREACH_END();
-    return 0;
+    else
+    {
+        stats = (fct_bench_stats_t*)fct_malloc(sizeof(fct_bench_stats_t));
+    }
+    if ( stats == NULL )
+    {
+        return;
+    }
+    memcpy(stats, &(bench->stats), sizeof(fct_bench_stats_t));
+    bench->test->bench = stats;
 }
 
 
-#define fct_clp__is_error(_CLP_) ((_CLP_)->is_error)
-#define fct_clp__get_error(_CLP_) ((_CLP_)->error_msg);
 
-#define fct_clp__num_clo(_CLP_) \
-    (fct_nlist__size(&((_CLP_)->clo_list)))
 
-#define fct_clp__param_cnt(_CLP_) \
-    (fct_nlist__size(&((_CLP_)->param_list)))
+/*
+-----------------------------------------------------------
+LOGGER INTERFACE
 
-/* Returns a *reference* to the parameter at _IDX_. Do not modify
-its contents. */
-#define fct_clp__param_at(_CLP_, _IDX_) \
-    ((char const*)fct_nlist__at(&((_CLP_)->param_list), (_IDX_)))
+Defines an interface to a logging system. A logger
+must define the following functions in order to hook
+into the logging system.
 
+See the "Standard Logger" and "Minimal Logger" as examples
+of the implementation.
+-----------------------------------------------------------
+*/
 
-/* Returns true if the given option was on the command line.
-Use either the long or short option name to check against. */
-#define fct_clp__is(_CLP_, _OPTION_) \
-    (fct_clp__optval((_CLP_), (_OPTION_)) != NULL)
+/* Common event argument. The values of the each event may or may not be
+defined depending on the event in question. */
+struct _fct_logger_evt_t
+{
+    fctkern_t const *kern;
+    fctchk_t const *chk;
+    fct_test_t const *test;
+    fct_ts_t const *ts;
+    char const *msg;
+    char const *cndtn;
+    char const *name;
+};
+
+
+typedef struct _fct_logger_i_vtable_t
+{
+    /* 1
+     * Fired when an "fct_chk*" (check) function is completed. The event
+     * will contain a reference to the "chk" object created.
+     * */
+    void (*on_chk)(fct_logger_i *logger, fct_logger_evt_t const *e);
+
+    /* 2
+     * Fired when a test starts and before any checks are made. The
+     * event will have its "test" object set. */
+    void (*on_test_start)(
+        fct_logger_i *logger,
+        fct_logger_evt_t const *e
+    );
+    /* 3 */
+    void (*on_test_end)(
+        fct_logger_i *logger,
+        fct_logger_evt_t const *e
+    );
+    /* 4 */
+    void (*on_test_suite_start)(
+        fct_logger_i *logger,
+        fct_logger_evt_t const *e
+    );
+    /* 5 */
+    void (*on_test_suite_end)(
+        fct_logger_i *logger,
+        fct_logger_evt_t const *e
+    );
+    /* 6 */
+    void (*on_fctx_start)(
+        fct_logger_i *logger,
+        fct_logger_evt_t const *e
+    );
+    /* 7 */
+    void (*on_fctx_end)(
+        fct_logger_i *logger,
+        fct_logger_evt_t const *e
+    );
+    /* 8
+    Called when the logger object must "clean up". */
+    void (*on_delete)(
+        fct_logger_i *logger,
+        fct_logger_evt_t const *e
+    );
+    /* 9 */
+    void (*on_warn)(
+        fct_logger_i *logger,
+        fct_logger_evt_t const *e
+    );
+    /* -- new in 1.2 -- */
+    /* 10 */
+    void (*on_test_suite_skip)(
+        fct_logger_i *logger,
+        fct_logger_evt_t const *e
+    );
+    /* 11 */
+    void (*on_test_skip)(
+        fct_logger_i *logger,
+        fct_logger_evt_t const *e
+    );
+    /* -- new in 1.7 -- */
+    /* 12
+     * Fired after the test end of a benchmark run with --bench. The
+     * event "test" has what was measured in its "bench". */
+    void (*on_bench)(
+        fct_logger_i *logger,
+        fct_logger_evt_t const *e
+    );
+} fct_logger_i_vtable_t;
+
+#define _fct_logger_head \
+    fct_logger_i_vtable_t vtable; \
+    fct_logger_evt_t evt
+
+struct _fct_logger_i
+{
+    _fct_logger_head;
+};
+
+
+static void
+fct_logger__stub(fct_logger_i *l, fct_logger_evt_t const *e)
+{
+    fct_unused(l);
+    fct_unused(e);
+}
+
+
+static fct_logger_i_vtable_t fct_logger_default_vtable =
+{
+    fct_logger__stub,   /* 1.  on_chk */
+    fct_logger__stub,   /* 2.  on_test_start */
+    fct_logger__stub,   /* 3.  on_test_end */
+    fct_logger__stub,   /* 4.  on_test_suite_start */
+    fct_logger__stub,   /* 5.  on_test_suite_end */
+    fct_logger__stub,   /* 6.  on_fctx_start */
+    fct_logger__stub,   /* 7.  on_fctx_end */
+    fct_logger__stub,   /* 8.  on_delete */
+    fct_logger__stub,   /* 9.  on_warn */
+    fct_logger__stub,   /* 10. on_test_suite_skip */
+    fct_logger__stub,   /* 11. on_test_skip */
+    fct_logger__stub,   /* 12. on_bench */
+};
+
+
+/* Initializes the elements of a logger interface so they are at their
+standard values. */
+static void
+fct_logger__init(fct_logger_i *logger)
+{
+    FCT_ASSERT( logger != NULL );
+    memcpy(
+        &(logger->vtable),
+        &fct_logger_default_vtable,
+        sizeof(fct_logger_i_vtable_t)
+    );
+    memset(&(logger->evt),0, sizeof(fct_logger_evt_t));
+}
+
+static void
+fct_logger__del(fct_logger_i *logger)
+{
+    if ( logger )
+    {
+        logger->vtable.on_delete(logger, &(logger->evt));
+    }
+}
+
+
+static void
+fct_logger__on_test_start(fct_logger_i *logger, fct_test_t const *test)
+{
+    logger->evt.test = test;
+    logger->vtable.on_test_start(logger, &(logger->evt));
+}
 
 
+static void
+fct_logger__on_test_end(fct_logger_i *logger, fct_test_t *test)
+{
+    logger->evt.test = test;
+    logger->vtable.on_test_end(logger, &(logger->evt));
+}
 
-/*
---------------------------------------------------------
-FCT NAMESPACE
---------------------------------------------------------
 
-The macros below start to pollute the watch window with
-lots of "system" variables. This NAMESPACE is an
-attempt to hide all the "system" variables in one place.
-*/
-typedef struct _fct_namespace_t
+static void
+fct_logger__on_test_suite_start(fct_logger_i *logger, fct_ts_t const *ts)
 {
-    /* The currently active test suite. */
-    fct_ts_t *ts_curr;
-    int ts_is_skip_suite;
-    char const *ts_skip_cndtn;
-
-    /* Current test name. */
-    char const* curr_test_name;
-    fct_test_t *curr_test;
-    const char *test_skip_cndtn;
-    int test_is_skip;
+    logger->evt.ts = ts;
+    logger->vtable.on_test_suite_start(logger, &(logger->evt));
+}
 
-    /* Counts the number of tests in a test suite. */
-    int test_num;
 
-    /* Set at the end of the test suites. */
-    size_t num_total_failed;
-} fct_namespace_t;
+static void
+fct_logger__on_test_suite_end(fct_logger_i *logger, fct_ts_t const *ts)
+{
+    logger->evt.ts = ts;
+    logger->vtable.on_test_suite_end(logger, &(logger->evt));
+}
 
 
 static void
-fct_namespace_init(fct_namespace_t *ns)
+fct_logger__on_test_suite_skip(
+    fct_logger_i *logger,
+    char const *condition,
+    char const *name
+)
 {
-    FCT_ASSERT( ns != NULL && "invalid argument!");
-    memset(ns, 0, sizeof(fct_namespace_t));
+    logger->evt.cndtn = condition;
+    logger->evt.name = name;
+    logger->vtable.on_test_suite_skip(logger, &(logger->evt));
 }
 
 
-/*
---------------------------------------------------------
-FCT KERNEL
---------------------------------------------------------
+static void
+fct_logger__on_test_skip(
+    fct_logger_i *logger,
+    char const *condition,
+    char const *name
+)
+{
+    logger->evt.cndtn = condition;
+    logger->evt.name = name;
+    logger->vtable.on_test_skip(logger, &(logger->evt));
+}
 
-The "fctkern" is a singleton that is defined throughout the
-system.
-*/
 
-struct _fctkern_t
+static void
+fct_logger__on_bench(fct_logger_i *logger, fct_test_t const *test)
 {
-    /* Holds variables used throughout MACRO MAGIC. In order to reduce
-    the "noise" in the watch window during a debug trace. */
-    fct_namespace_t ns;
+    logger->evt.test = test;
+    logger->vtable.on_bench(logger, &(logger->evt));
+}
 
-    /* Command line parsing. */
-    fct_clp_t cl_parser;
 
-    /* Hold onto the command line arguments. */
-    int cl_argc;
-    char const **cl_argv;
-    /* Track user options. */
-    fctcl_init_t const *cl_user_opts;
+static void
+fct_logger__on_chk(fct_logger_i *logger, fctchk_t const *chk)
+{
+    logger->evt.chk = chk;
+    logger->vtable.on_chk(logger, &(logger->evt));
+}
 
-    /* Tracks the delay parsing. */
-    int cl_is_parsed;
+/* When we start all our tests. */
+#define fct_logger__on_fctx_start(LOGGER, KERN) \
+   (LOGGER)->evt.kern = (KERN);\
+   (LOGGER)->vtable.on_fctx_start((LOGGER), &((LOGGER)->evt));
 
-    /* This is an list of loggers that can be used in the fct system. */
-    fct_nlist_t logger_list;
 
-    /* Array of custom types, you have built-in system ones and you
-    have optionally supplied user ones.. */
-    fct_logger_types_t *lt_usr;
-    fct_logger_types_t *lt_sys;
+/* When we have reached the end of ALL of our testing. */
+#define fct_logger__on_fctx_end(LOGGER, KERN) \
+    (LOGGER)->evt.kern = (KERN);\
+    (LOGGER)->vtable.on_fctx_end((LOGGER), &((LOGGER)->evt));
 
-    /* This is a list of prefix's that can be used to determine if a
-    test is should be run or not. */
-    fct_nlist_t prefix_list;
 
-    /* This is a list of test suites that where generated throughout the
-    testing process. */
-    fct_nlist_t ts_list;
+static void
+fct_logger__on_warn(fct_logger_i *logger, char const *msg)
+{
+    logger->evt.msg = msg;
+    logger->vtable.on_warn(logger, &(logger->evt));
+}
 
-    /* Records what we expect to fail. */
-    size_t num_expected_failures;
-};
 
+/* The most messages that are kept for one place in the code, the
+rest of its failures are only counted. */
+#define FCT_FAIL_SITE_MAX_MSGS 3
 
-#define FCT_OPT_VERSION       "--version"
-#define FCT_OPT_VERSION_SHORT "-v"
-#define FCT_OPT_HELP          "--help"
-#define FCT_OPT_HELP_SHORT    "-h"
-#define FCT_OPT_LOGGER        "--logger"
-#define FCT_OPT_LOGGER_SHORT  "-l"
-static fctcl_init_t FCT_CLP_OPTIONS[] =
+/* The failures from one place in the code. */
+typedef struct _fct_fail_site_t fct_fail_site_t;
+struct _fct_fail_site_t
 {
-    /* Totally unsafe, since we are assuming we can clean out this data,
-    what I need to do is have an "initialization" object, full of
-    const objects. But for now, this should work. */
-    {
-        FCT_OPT_VERSION,
-        FCT_OPT_VERSION_SHORT,
-        FCTCL_STORE_TRUE,
-        "Displays the FCTX version number and exits."
-    },
-    {
-        FCT_OPT_HELP,
-        FCT_OPT_HELP_SHORT,
-        FCTCL_STORE_TRUE,
-        "Shows this help."
-    },
-    {
-        FCT_OPT_LOGGER,
-        FCT_OPT_LOGGER_SHORT,
-        FCTCL_STORE_VALUE,
-        NULL
-    },
-    FCTCL_INIT_NULL /* Sentinel */
+    char const *file;
+    int lineno;
+    size_t num_fails;
+    /* The first few different messages. */
+    char const *msgs[FCT_FAIL_SITE_MAX_MSGS];
+    size_t num_msgs;
 };
 
-typedef fct_logger_i* (*fct_logger_new_fn)(void);
-struct _fct_logger_types_t
-{
-    char const *name;
-    fct_logger_new_fn logger_new_fn;
-    char const *desc;
+/* The failures a logger lists at the end, one site for each file and
+line that failed, in the order they first failed. Everything is taken
+from the arena, and goes when the list is finished. */
+typedef struct _fct_fail_list_t fct_fail_list_t;
+struct _fct_fail_list_t
+{
+    fct_nlist_t sites;
+    /* Open addressed, by file and line. Kept under half full. */
+    fct_fail_site_t **index;
+    size_t index_avail;
+    fct_arena_t arena;
 };
 
-static fct_logger_types_t FCT_LOGGER_TYPES[] =
+#define fct_fail_list__size(_LIST_) (fct_nlist__size(&((_LIST_)->sites)))
+
+
+static void
+fct_fail_list__init(fct_fail_list_t *list)
 {
+    FCT_ASSERT( list != NULL );
+    fct_nlist__init2(&(list->sites), 0);
+    list->index = NULL;
+    list->index_avail = 0;
+    fct_arena__init(&(list->arena));
+}
+
+
+static void
+fct_fail_list__final(fct_fail_list_t *list)
+{
+    FCT_ASSERT( list != NULL );
+    fct_nlist__final(&(list->sites), NULL);
+    if ( list->index != NULL )
     {
-        "standard",
-        (fct_logger_new_fn)fct_standard_logger_new,
-        "the basic fctx logger"
-    },
-    {
-        "minimal",
-        (fct_logger_new_fn)fct_minimal_logger_new,
-        "the least amount of logging information."
-    },
+        fct_free(list->index);
+    }
+    fct_arena__final(&(list->arena));
+}
+
+
+static size_t
+fct_fail_site__hash(char const *file, int lineno)
+{
+    size_t hash = (size_t)lineno;
+    for ( ; *file != '\0'; ++file )
     {
-        "junit",
-        (fct_logger_new_fn)fct_junit_logger_new,
-        "junit compatible xml"
-    },
-    {NULL, (fct_logger_new_fn)NULL, NULL} /* Sentinel */
-};
+        hash = hash*31 + (unsigned char)*file;
+    }
+    return hash;
+}
 
 
-/* Returns the number of filters defined for the fct kernel. */
-#define fctkern__filter_cnt(_NK_) (fct_nlist__size(&((_NK_)->prefix_list)))
+/* Returns the slot in the index for FILE and LINENO, it holds NULL if
+the site is not there yet. */
+static fct_fail_site_t **
+fct_fail_list__slot(fct_fail_list_t *list, char const *file, int lineno)
+{
+    size_t mask = list->index_avail - 1;
+    size_t slot_i = fct_fail_site__hash(file, lineno) & mask;
+    for ( ;; slot_i = (slot_i + 1) & mask )
+    {
+        fct_fail_site_t *site = list->index[slot_i];
+        if ( site == NULL
+                || (site->lineno == lineno && fctstr_eq(site->file, file)) )
+        {
+            return &(list->index[slot_i]);
+        }
+    }
+}
 
 
+/* Doubles the index, or makes the first one. */
 static void
-fctkern__add_logger(fctkern_t *nk, fct_logger_i *logger_owns)
+fct_fail_list__grow(fct_fail_list_t *list)
 {
-    FCT_ASSERT(nk != NULL && "invalid arg");
-    FCT_ASSERT(logger_owns != NULL && "invalid arg");
-    fct_nlist__append(&(nk->logger_list), logger_owns);
+    size_t site_i =0;
+    list->index_avail = (list->index_avail == 0) ? 16 : list->index_avail*2;
+    if ( list->index != NULL )
+    {
+        fct_free(list->index);
+    }
+    list->index = (fct_fail_site_t**)fct_calloc(
+                      list->index_avail, sizeof(fct_fail_site_t*)
+                  );
+    FCT_ASSERT( list->index != NULL );
+    for ( site_i =0; site_i != fct_fail_list__size(list); ++site_i )
+    {
+        fct_fail_site_t *site =
+            (fct_fail_site_t*)fct_nlist__at(&(list->sites), site_i);
+        *fct_fail_list__slot(list, site->file, site->lineno) = site;
+    }
 }
 
 
+/* Common routine to record failures. The chk should be a failure before
+we call this. A failure from a file and line that already failed is
+only counted, and its message kept if it is one of the first few
+different ones. */
 static void
-fctkern__write_help(fctkern_t *nk, FILE *out)
+fct_fail_list__add(fct_fail_list_t *list, fctchk_t const *chk)
 {
-    fct_clp_t *clp = &(nk->cl_parser);
-    fprintf(out, "test.exe [options] prefix_filter ...\n\n");
-    FCT_NLIST_FOREACH_BGN(fctcl_t*, clo, &(clp->clo_list))
+    fct_fail_site_t **slot =NULL;
+    fct_fail_site_t *site =NULL;
+    size_t msg_i =0;
+    FCT_ASSERT( list != NULL );
+    FCT_ASSERT( chk != NULL );
+    if ( (fct_fail_list__size(list)+1)*2 > list->index_avail )
     {
-        if ( clo->short_opt != NULL )
-        {
-            fprintf(out, "%s, %s\n", clo->short_opt, clo->long_opt);
-        }
-        else
+        fct_fail_list__grow(list);
+    }
+    slot = fct_fail_list__slot(list, fctchk__file(chk), fctchk__lineno(chk));
+    site = *slot;
+    if ( site == NULL )
+    {
+        site = (fct_fail_site_t*)fct_arena__alloc(
+                   &(list->arena), sizeof(fct_fail_site_t)
+               );
+        FCT_ASSERT( site != NULL );
+        memset(site, 0, sizeof(fct_fail_site_t));
+        site->file = fct_arena__strdup(&(list->arena), fctchk__file(chk));
+        FCT_ASSERT( site->file != NULL );
+        site->lineno = fctchk__lineno(chk);
+        *slot = site;
+        fct_nlist__append(&(list->sites), site);
+    }
+    ++(site->num_fails);
+    if ( site->num_msgs == FCT_FAIL_SITE_MAX_MSGS )
+    {
+        return;
+    }
+    for ( msg_i =0; msg_i != site->num_msgs; ++msg_i )
+    {
+        if ( fctstr_eq(site->msgs[msg_i], fctchk__msg(chk)) )
         {
-            fprintf(out, "%s\n", clo->long_opt);
+            return;
         }
-        if ( !fctstr_ieq(clo->long_opt, FCT_OPT_LOGGER) )
+    }
+    site->msgs[site->num_msgs] =
+        fct_arena__strdup(&(list->arena), fctchk__msg(chk));
+    FCT_ASSERT( site->msgs[site->num_msgs] != NULL );
+    ++(site->num_msgs);
+}
+
+
+/* Another common routine, to print the failures at the end of a run. */
+static void
+fct_fail_list__print(fct_fail_list_t const *list)
+{
+    puts(
+        "\n----------------------------------------------------------------------------\n"
+    );
+    puts("FAILED TESTS\n\n");
+    FCT_NLIST_FOREACH_BGN(fct_fail_site_t const*, site, &(list->sites))
+    {
+        size_t msg_i =0;
+        if ( site->num_fails == 1 )
         {
-            /* For now lets not get to fancy with the text wrapping. */
-            fprintf(out, "  %s\n", clo->help);
+            printf("%s(%d):\n", site->file, site->lineno);
         }
         else
         {
-            fct_logger_types_t *types[2];
-            int type_i;
-            fct_logger_types_t *itr;
-            types[0] = nk->lt_sys;
-            types[1] = nk->lt_usr;
-            fputs("  Sets the logger. The types of loggers currently "
-                  "available are,\n", out);
-            for (type_i =0; type_i != 2; ++type_i )
-            {
-                for ( itr=types[type_i]; itr && itr->name != NULL; ++itr )
-                {
-                    fprintf(out, "   =%s : %s\n", itr->name, itr->desc);
-                }
-            }
-            fprintf(out, "  default is '%s'.\n", FCT_DEFAULT_LOGGER);
+            printf("%s(%d): failed %lu times\n",
+                   site->file,
+                   site->lineno,
+                   (unsigned long)site->num_fails);
+        }
+        for ( msg_i =0; msg_i != site->num_msgs; ++msg_i )
+        {
+            printf("    %s\n", site->msgs[msg_i]);
         }
     }
     FCT_NLIST_FOREACH_END();
-    fputs("\n", out);
+
+    puts("\n");
 }
 
 
-/* Appends a prefix filter that is used to determine if a test can
-be executed or not. If the test starts with the same characters as
-the prefix, then it should be "runnable". The prefix filter must be
-a non-NULL, non-Blank string. */
-static void
-fctkern__add_prefix_filter(fctkern_t *nk, char const *prefix_filter)
+
+
+/*
+-----------------------------------------------------------
+MINIMAL LOGGER
+-----------------------------------------------------------
+
+At the moment the MINIMAL LOGGER is currently disabled. Hope
+to bring it back online soon. The only reason it is
+disabled is that we don't currently have the ability to specify
+loggers.
+*/
+
+
+/* Minimal logger, reports the minimum amount of information needed
+to determine "something is happening". */
+struct _fct_minimal_logger_t
 {
-    char *filter =NULL;
-    size_t filter_len =0;
-    FCT_ASSERT( nk != NULL && "invalid arg" );
-    FCT_ASSERT( prefix_filter != NULL && "invalid arg" );
-    FCT_ASSERT( strlen(prefix_filter) > 0 && "invalid arg" );
-    /* First we make a copy of the prefix, then we store it away
-    in our little list. */
-    filter_len = strlen(prefix_filter);
-    filter = (char*)malloc(sizeof(char)*(filter_len+1));
-    fctstr_safe_cpy(filter, prefix_filter, filter_len+1);
-    fct_nlist__append(&(nk->prefix_list), (void*)filter);
-}
+    _fct_logger_head;
+    /* The failures to list at the end. */
+    fct_fail_list_t failures;
+};
 
 
-/* Cleans up the contents of a fctkern. NULL does nothing. */
 static void
-fctkern__final(fctkern_t *nk)
+fct_minimal_logger__on_chk(
+    fct_logger_i *self_,
+    fct_logger_evt_t const *e
+)
 {
-    if ( nk == NULL )
+    fct_minimal_logger_t *self = (fct_minimal_logger_t*)self_;
+    if ( fctchk__is_pass(e->chk) )
     {
-        return;
+        fputs(".", stdout);
     }
-    fct_clp__final(&(nk->cl_parser));
-    fct_nlist__final(&(nk->logger_list), (fct_nlist_on_del_t)fct_logger__del);
-    /* The prefix list is a list of malloc'd strings. */
-    fct_nlist__final(&(nk->prefix_list), (fct_nlist_on_del_t)free);
-    fct_nlist__final(&(nk->ts_list), (fct_nlist_on_del_t)fct_ts__del);
-}
+    else
+    {
+        fputs("x", stdout);
+        fct_fail_list__add(&(self->failures), e->chk);
 
+    }
+}
 
-#define fctkern__cl_is_parsed(_NK_) ((_NK_)->cl_is_parsed)
+static void
+fct_minimal_logger__on_fctx_end(
+    fct_logger_i *self_,
+    fct_logger_evt_t const *e
+)
+{
+    fct_minimal_logger_t *self = (fct_minimal_logger_t*)self_;
+    fct_unused(e);
+    if ( fct_fail_list__size(&(self->failures)) >0 )
+    {
+        fct_fail_list__print(&(self->failures));
+    }
+}
 
 
-static int
-fctkern__cl_is(fctkern_t *nk, char const *opt_str)
+static void
+fct_minimal_logger__on_delete(
+    fct_logger_i *self_,
+    fct_logger_evt_t const *e
+)
 {
-    FCT_ASSERT( opt_str != NULL );
-    return opt_str[0] != '\0'
-           && fct_clp__is(&(nk->cl_parser), opt_str);
+    fct_minimal_logger_t *self = (fct_minimal_logger_t*)self_;
+    fct_unused(e);
+    fct_fail_list__final(&(self->failures));
+    fct_free(self);
+
 }
 
 
-/* Returns the command line value given by OPT_STR. If OPT_STR was not defined
-at the command line, DEF_STR is returned (you can use NULL for the DEF_STR).
-The result returned should not be modified, and MAY even be the same pointer
-to DEF_STR. */
-static char const *
-fctkern__cl_val2(fctkern_t *nk, char const *opt_str, char const *def_str)
+fct_logger_i*
+fct_minimal_logger_new(void)
 {
-    FCT_ASSERT( opt_str != NULL );
-    if ( nk == NULL )
+    fct_minimal_logger_t *self = (fct_minimal_logger_t*)\
+                                 fct_calloc(1,sizeof(fct_minimal_logger_t));
+    if ( self == NULL )
     {
         return NULL;
     }
-    return fct_clp__optval2(&(nk->cl_parser), opt_str, def_str);
+    fct_logger__init((fct_logger_i*)self);
+    self->vtable.on_chk = fct_minimal_logger__on_chk;
+    self->vtable.on_fctx_end = fct_minimal_logger__on_fctx_end;
+    self->vtable.on_delete = fct_minimal_logger__on_delete;
+    fct_fail_list__init(&(self->failures));
+    return (fct_logger_i*)self;
 }
 
 
-/* Selects a logger from the list based on the selection name.
-May return NULL if the name doesn't exist in the list. */
-static fct_logger_i*
-fckern_sel_log(fct_logger_types_t *search, char const *sel_logger)
+/*
+-----------------------------------------------------------
+STANDARD LOGGER
+-----------------------------------------------------------
+*/
+
+struct _fct_standard_logger_t
 {
-    fct_logger_types_t *iter;
-    FCT_ASSERT(search != NULL);
-    FCT_ASSERT(sel_logger != NULL);
-    FCT_ASSERT(strlen(sel_logger) > 0);
-    for ( iter = search; iter->name != NULL; ++iter)
+    _fct_logger_head;
+
+    /* Times the whole run. */
+    fct_timer_t timer;
+
+    /* The failures to list at the end. */
+    fct_fail_list_t failures;
+};
+
+
+#define FCT_STANDARD_LOGGER_MAX_LINE 68
+
+
+/* When a failure occurs, we will record the details so we can display
+them when the log "finishes" up. */
+static void
+fct_standard_logger__on_chk(
+    fct_logger_i *logger_,
+    fct_logger_evt_t const *e
+)
+{
+    fct_standard_logger_t *logger = (fct_standard_logger_t*)logger_;
+    /* Only record failures. */
+    if ( !fctchk__is_pass(e->chk) )
     {
-        if ( fctstr_ieq(iter->name, sel_logger) )
-        {
-            return iter->logger_new_fn();
-        }
+        fct_fail_list__add(&(logger->failures), e->chk);
     }
-    return NULL;
 }
 
-static int
-fctkern__cl_parse_config_logger(fctkern_t *nk)
+
+static void
+fct_standard_logger__on_test_skip(
+    fct_logger_i* logger_,
+    fct_logger_evt_t const *e
+)
 {
-    fct_logger_i *logger =NULL;
-    char const *sel_logger =NULL;
-    char const *def_logger =FCT_DEFAULT_LOGGER;
-    sel_logger = fctkern__cl_val2(nk, FCT_OPT_LOGGER, def_logger);
-    FCT_ASSERT(sel_logger != NULL && "should never be NULL");
-    /* First search the user selected types, then search the
-    built-in types. */
-    if ( nk->lt_usr != NULL )
-    {
-        logger = fckern_sel_log(nk->lt_usr, sel_logger);
-    }
-    if ( nk->lt_sys != NULL && logger == NULL )
-    {
-        logger = fckern_sel_log(nk->lt_sys, sel_logger);
-    }
-    if ( logger == NULL )
-    {
-        /* No logger configured, you must have supplied an invalid selection. */
-        fprintf(stderr, "error: unknown logger selected - '%s'", sel_logger);
-        return 0;
-    }
-    fctkern__add_logger(nk, logger);
-    logger = NULL;  /* owned by nk. */
-    return 1;
+    char const *condition = e->cndtn;
+    char const *name = e->name;
+    char msg[256] = {'\0'};
+    fct_unused(logger_);
+    fct_unused(condition);
+    fct_snprintf(msg, sizeof(msg), "%s (%s)", name, condition);
+    msg[sizeof(msg)-1] = '\0';
+    fct_dotted_line_start(FCT_STANDARD_LOGGER_MAX_LINE, msg);
+    fct_dotted_line_end("- SKIP -");
 }
 
 
+static void
+fct_standard_logger__on_test_start(
+    fct_logger_i *logger_,
+    fct_logger_evt_t const *e
+)
+{
+    fct_unused(logger_);
+    fct_dotted_line_start(
+        FCT_STANDARD_LOGGER_MAX_LINE,
+        fct_test__name(e->test)
+    );
+}
+
 
-/* Call this if you want to (re)parse the command line options with a new
-set of options. Returns -1 if you are to abort with EXIT_SUCCESS, returns
-0 if you are to abort with EXIT_FAILURE and returns 1 if you are to continue. */
-static int
-fctkern__cl_parse(fctkern_t *nk)
+/* Prints the perf counters that were read, each divided by PER, and
+ends the line. */
+static void
+fct_standard_logger__print_perf(fct_perf_t const *perf, double per)
 {
-    int status =0;
-    size_t num_params =0;
-    size_t param_i =0;
-    if ( nk == NULL )
-    {
-        return 0;
-    }
-    if ( nk->cl_user_opts != NULL )
+    char const *sep = "";
+    int cntr_i =0;
+    for ( cntr_i =0; cntr_i != FCT_PERF_NUM; ++cntr_i )
     {
-        if ( !fct_clp__add_options(&(nk->cl_parser), nk->cl_user_opts) )
+        if ( fct_perf__is_read(perf, cntr_i) )
         {
-            status =0;
-            goto finally;
+            printf("%s%s %.*f",
+                   sep,
+                   fct_perf_names[cntr_i],
+                   (per > 1.0) ? 2 : 0,
+                   perf->counts[cntr_i] / per);
+            sep = ", ";
         }
     }
-    /* You want to add the "house options" after the user defined ones. The
-    options are stored as a list so it means that any option listed after
-    the above ones won't get parsed. */
-    if ( !fct_clp__add_options(&(nk->cl_parser), FCT_CLP_OPTIONS) )
-    {
-        status =0;
-        goto finally;
-    }
-    fct_clp__parse(&(nk->cl_parser), nk->cl_argc, nk->cl_argv);
-    if ( fct_clp__is_error(&(nk->cl_parser)) )
-    {
-        char *err = fct_clp__get_error(&(nk->cl_parser));
-        fprintf(stderr, "error: %s", err);
-        status =0;
-        goto finally;
-    }
-    num_params = fct_clp__param_cnt(&(nk->cl_parser));
-    for ( param_i =0; param_i != num_params; ++param_i )
-    {
-        char const *param = fct_clp__param_at(&(nk->cl_parser), param_i);
-        fctkern__add_prefix_filter(nk, param);
-    }
-    if ( fctkern__cl_is(nk, FCT_OPT_VERSION) )
-    {
-        (void)printf("Built using FCTX version %s.\n", FCT_VERSION_STR);
-        status = -1;
-        goto finally;
-    }
-    if ( fctkern__cl_is(nk, FCT_OPT_HELP) )
+    printf("\n");
+}
+
+
+/* Prints what a test or suite used, and ends the line. */
+static void
+fct_standard_logger__print_rusage(fct_rusage_t const *rusage)
+{
+    printf("user %.6fs, sys %.6fs, maxrss +%ld KB, %ld minor faults, "
+           "%ld major faults, %ld voluntary and %ld involuntary switches\n",
+           rusage->user_time,
+           rusage->sys_time,
+           rusage->maxrss_growth,
+           rusage->minor_faults,
+           rusage->major_faults,
+           rusage->vol_switches,
+           rusage->invol_switches);
+}
+
+
+static void
+fct_standard_logger__on_test_end(
+    fct_logger_i *logger_,
+    fct_logger_evt_t const *e
+)
+{
+    nbool_t is_pass;
+    fct_unused(logger_);
+    is_pass = fct_test__is_pass(e->test);
+    fct_dotted_line_end((is_pass) ? "PASS" : "FAIL ***" );
+    if ( e->test->perf.mask != 0 )
     {
-        fctkern__write_help(nk, stdout);
-        status = -1;
-        goto finally;
+        printf("PERF: %s ", fct_test__name(e->test));
+        fct_standard_logger__print_perf(&(e->test->perf), 1.0);
     }
-    if ( !fctkern__cl_parse_config_logger(nk) )
+#if defined(FCT_ALLOC)
+    printf("ALLOC: %s %lu allocs, %lu bytes, %lu peak bytes\n",
+           fct_test__name(e->test),
+           (unsigned long)e->test->alloc.num_allocs,
+           (unsigned long)e->test->alloc.num_bytes,
+           (unsigned long)e->test->alloc.peak_bytes);
+#endif /* FCT_ALLOC */
+    if ( e->kern != NULL && e->kern->is_rusage )
     {
-        status = -1;
-        goto finally;
+        printf("RUSAGE: %s ", fct_test__name(e->test));
+        fct_standard_logger__print_rusage(&(e->test->rusage));
     }
-    status =1;
-    nk->cl_is_parsed =1;
-finally:
-    return status;
 }
 
 
-
-/* Parses the command line and sets up the framework. The argc and argv
-should be directly from the program's main. */
-static int
-fctkern__init(fctkern_t *nk, int argc, const char *argv[])
+/* With --rusage, sums up what the suite's tests used. */
+static void
+fct_standard_logger__on_test_suite_end(
+    fct_logger_i *logger_,
+    fct_logger_evt_t const *e
+)
 {
-    if ( argc == 0 && argv == NULL )
+    fct_unused(logger_);
+    if ( e->kern != NULL && e->kern->is_rusage )
     {
-        return 0;
+        printf("RUSAGE: suite %s ", fct_ts__name(e->ts));
+        fct_standard_logger__print_rusage(&(e->ts->rusage));
     }
-    memset(nk, 0, sizeof(fctkern_t));
-    fct_clp__init(&(nk->cl_parser), NULL);
-    fct_nlist__init(&(nk->logger_list));
-    nk->lt_usr = NULL;  /* Supplied via 'install' mechanics. */
-    nk->lt_sys = FCT_LOGGER_TYPES;
-    fct_nlist__init2(&(nk->prefix_list), 0);
-    fct_nlist__init2(&(nk->ts_list), 0);
-    nk->cl_is_parsed =0;
-    /* Save a copy of the arguments. We do a delay parse of the command
-    line arguments in order to allow the client code to optionally configure
-    the command line parser.*/
-    nk->cl_argc = argc;
-    nk->cl_argv = argv;
-    fct_namespace_init(&(nk->ns));
-    return 1;
 }
 
 
-/* Takes OWNERSHIP of the test suite after we have finished executing
-its contents. This way we can build up all kinds of summaries at the end
-of a run. */
 static void
-fctkern__add_ts(fctkern_t *nk, fct_ts_t *ts)
+fct_standard_logger__on_fctx_start(
+    fct_logger_i *logger_,
+    fct_logger_evt_t const *e
+)
 {
-    FCT_ASSERT( nk != NULL );
-    FCT_ASSERT( ts != NULL );
-    fct_nlist__append(&(nk->ts_list), ts);
+    fct_standard_logger_t *logger = (fct_standard_logger_t*)logger_;
+    fct_unused(e);
+    fct_timer__start(&(logger->timer));
 }
 
 
-/* Returns FCT_TRUE if the supplied test_name passes the filters set on
-this test suite. If there are no filters, we return FCT_TRUE always. */
-static nbool_t
-fctkern__pass_filter(fctkern_t *nk, char const *test_name)
+static void
+fct_standard_logger__on_fctx_end(
+    fct_logger_i *logger_,
+    fct_logger_evt_t const *e
+)
 {
-    size_t prefix_i =0;
-    size_t prefix_list_size =0;
-    FCT_ASSERT( nk != NULL && "invalid arg");
-    FCT_ASSERT( test_name != NULL );
-    FCT_ASSERT( strlen(test_name) > 0 );
-    prefix_list_size = fctkern__filter_cnt(nk);
-    /* If there is no filter list, then we return FCT_TRUE always. */
-    if ( prefix_list_size == 0 )
+    fct_standard_logger_t *logger = (fct_standard_logger_t*)logger_;
+    nbool_t is_success =1;
+    double elasped_time =0;
+    size_t num_tests =0;
+    size_t num_passed =0;
+
+    fct_timer__stop(&(logger->timer));
+
+    is_success = fct_fail_list__size(&(logger->failures)) ==0;
+
+    if (  !is_success )
     {
-        return FCT_TRUE;
+        fct_fail_list__print(&(logger->failures));
     }
-    /* Iterate through the prefix filter list, and see if we have
-    anything that does not pass. All we require is ONE item that
-    passes the test in order for us to succeed here. */
-    for ( prefix_i = 0; prefix_i != prefix_list_size; ++prefix_i )
+    puts(
+        "\n----------------------------------------------------------------------------\n"
+    );
+    num_tests = fctkern__tst_cnt(e->kern);
+    num_passed = fctkern__tst_cnt_passed(e->kern);
+    printf(
+        "%s (%lu/%lu tests",
+        (is_success) ? "PASSED" : "FAILED",
+        (unsigned long) num_passed,
+        (unsigned long) num_tests
+    );
+    elasped_time = fct_timer__duration(&(logger->timer));
+    if ( elasped_time > 0.0000001 )
     {
-        char const *prefix = (char const*)fct_nlist__at(
-                                 &(nk->prefix_list), prefix_i
-                             );
-        nbool_t pass = fct_filter_pass(prefix, test_name);
-        if ( pass )
-        {
-            return FCT_TRUE;
-        }
+        printf(" in %.6fs, %.6fs cpu)\n",
+               elasped_time,
+               fct_timer__cpu_duration(&(logger->timer)));
+    }
+    else
+    {
+        /* Don't bother displaying the time to execute. */
+        puts(")\n");
     }
-    /* Otherwise, we never managed to find a prefix that satisfied the
-    supplied test name. Therefore we have failed to pass to the filter
-    list test. */
-    return FCT_FALSE;
 }
 
 
-/* Returns the number of tests that were performed. */
-static size_t
-fctkern__tst_cnt(fctkern_t const *nk)
+static void
+fct_standard_logger__on_delete(
+    fct_logger_i *logger_,
+    fct_logger_evt_t const *e
+)
 {
-    size_t tally =0;
-    FCT_ASSERT( nk != NULL );
-    FCT_NLIST_FOREACH_BGN(fct_ts_t *, ts, &(nk->ts_list))
-    {
-        tally += fct_ts__tst_cnt(ts);
-    }
-    FCT_NLIST_FOREACH_END();
-    return tally;
+    fct_standard_logger_t *logger = (fct_standard_logger_t*)logger_;
+    fct_unused(e);
+    fct_fail_list__final(&(logger->failures));
+    fct_free(logger);
+    logger_ =NULL;
 }
 
 
-/* Returns the number of tests that passed. */
-static size_t
-fctkern__tst_cnt_passed(fctkern_t const *nk)
+static void
+fct_standard_logger__on_warn(
+    fct_logger_i* logger_,
+    fct_logger_evt_t const *e
+)
 {
-    size_t tally =0;
-    FCT_ASSERT( nk != NULL );
+    fct_unused(logger_);
+    (void)printf("WARNING: %s\n", e->msg);
+}
+
 
-    FCT_NLIST_FOREACH_BGN(fct_ts_t*, ts, &(nk->ts_list))
+static void
+fct_standard_logger__on_bench(
+    fct_logger_i* logger_,
+    fct_logger_evt_t const *e
+)
+{
+    fct_bench_stats_t const *stats = e->test->bench;
+    fct_unused(logger_);
+    (void)printf("BENCH: %s median %.2f ns/op, 95%% ci %.2f-%.2f, "
+                 "mad %.2f\n",
+                 fct_test__name(e->test),
+                 stats->median,
+                 stats->ci_low,
+                 stats->ci_high,
+                 stats->mad);
+    (void)printf("       min %.2f, p90 %.2f, p99 %.2f, mean %.2f, "
+                 "%lu/%lu outliers, %lu iterations\n",
+                 stats->min,
+                 stats->p90,
+                 stats->p99,
+                 stats->ns_per_op,
+                 (unsigned long)stats->num_outliers,
+                 (unsigned long)stats->num_samples,
+                 (unsigned long)fct_bench_stats__num_iters(stats));
+    if ( stats->perf.mask != 0 )
     {
-        tally += fct_ts__tst_cnt_passed(ts);
+        printf("       per op: ");
+        fct_standard_logger__print_perf(
+            &(stats->perf), (double)fct_bench_stats__num_iters(stats)
+        );
     }
-    FCT_NLIST_FOREACH_END();
+}
 
-    return tally;
+
+fct_logger_i*
+fct_standard_logger_new(void)
+{
+    fct_standard_logger_t *logger = (fct_standard_logger_t *)fct_calloc(
+                                        1, sizeof(fct_standard_logger_t)
+                                    );
+    if ( logger == NULL )
+    {
+        return NULL;
+    }
+    fct_logger__init((fct_logger_i*)logger);
+    logger->vtable.on_chk = fct_standard_logger__on_chk;
+    logger->vtable.on_test_start = fct_standard_logger__on_test_start;
+    logger->vtable.on_test_end = fct_standard_logger__on_test_end;
+    logger->vtable.on_test_suite_end = fct_standard_logger__on_test_suite_end;
+    logger->vtable.on_fctx_start = fct_standard_logger__on_fctx_start;
+    logger->vtable.on_fctx_end = fct_standard_logger__on_fctx_end;
+    logger->vtable.on_delete = fct_standard_logger__on_delete;
+    logger->vtable.on_warn = fct_standard_logger__on_warn;
+    logger->vtable.on_test_skip = fct_standard_logger__on_test_skip;
+    logger->vtable.on_bench = fct_standard_logger__on_bench;
+    fct_fail_list__init(&(logger->failures));
+    fct_timer__init(&(logger->timer));
+    return (fct_logger_i*)logger;
 }
 
 
-/* Returns the number of tests that failed. */
-#define fctkern__tst_cnt_failed(nk) \
-    (fctkern__tst_cnt(nk) - fctkern__tst_cnt_passed(nk))
+/*
+-----------------------------------------------------------
+JUNIT LOGGER
+-----------------------------------------------------------
+*/
 
 
-/* Returns the number of checks made throughout the entire test. */
-#if defined(FCT_USE_TEST_COUNT)
-static size_t
-fctkern__chk_cnt(fctkern_t const *nk)
+/* JUnit logger */
+struct _fct_junit_logger_t
 {
-    size_t tally =0;
-    FCT_ASSERT( nk != NULL );
+    _fct_logger_head;
+};
+
+
+/* The times other than the wall clock "time" go in as properties. */
+static void
+fct_junit_logger__print_time(char const *indent,
+                             char const *name,
+                             double value)
+{
+    printf("%s\t<property name=\"%s\" value=\"%.6f\" />\n",
+           indent, name, value);
+}
+
 
-    FCT_NLIST_FOREACH_BGN(fct_ts_t *, ts, &(nk->ts_list))
+/* With --rusage, what a test or suite used goes in as properties. */
+static void
+fct_junit_logger__print_rusage(char const *indent,
+                               fct_rusage_t const *rusage)
+{
+    fct_junit_logger__print_time(indent, "user_time", rusage->user_time);
+    fct_junit_logger__print_time(indent, "sys_time", rusage->sys_time);
+    printf("%s\t<property name=\"maxrss_growth_kb\" value=\"%ld\" />\n"
+           "%s\t<property name=\"minor_faults\" value=\"%ld\" />\n"
+           "%s\t<property name=\"major_faults\" value=\"%ld\" />\n"
+           "%s\t<property name=\"voluntary_switches\" value=\"%ld\" />\n"
+           "%s\t<property name=\"involuntary_switches\" value=\"%ld\" />\n",
+           indent, rusage->maxrss_growth,
+           indent, rusage->minor_faults,
+           indent, rusage->major_faults,
+           indent, rusage->vol_switches,
+           indent, rusage->invol_switches);
+}
+
+
+/* The perf counters that were read go in as properties, each divided by
+PER and named with SUFFIX. */
+static void
+fct_junit_logger__print_perf(fct_perf_t const *perf,
+                             double per,
+                             char const *suffix)
+{
+    int cntr_i =0;
+    for ( cntr_i =0; cntr_i != FCT_PERF_NUM; ++cntr_i )
     {
-        tally += fct_ts__chk_cnt(ts);
+        if ( fct_perf__is_read(perf, cntr_i) )
+        {
+            printf("\t\t\t\t<property name=\"%s%s\" value=\"%.*f\" />\n",
+                   fct_perf_names[cntr_i],
+                   suffix,
+                   (per > 1.0) ? 2 : 0,
+                   perf->counts[cntr_i] / per);
+        }
     }
-    FCT_NLIST_FOREACH_END();
-    return tally;
 }
-#endif /* FCT_USE_TEST_COUNT */
 
 
-/* Indicates the very end of all the tests. */
-#define fctkern__end(nk) /* unused */
+/* A benchmark's figures go in as properties of its test case, in
+nanoseconds an iteration. */
+static void
+fct_junit_logger__print_ns(char const *name, double value)
+{
+    printf("\t\t\t\t<property name=\"%s\" value=\"%.2f\" />\n",
+           name, value);
+}
 
 
 static void
-fctkern__log_suite_start(fctkern_t *nk, fct_ts_t const *ts)
+fct_junit_logger__print_bench(fct_bench_stats_t const *stats)
+{
+    fct_junit_logger__print_ns("ns_per_op", stats->ns_per_op);
+    fct_junit_logger__print_ns("median", stats->median);
+    fct_junit_logger__print_ns("min", stats->min);
+    fct_junit_logger__print_ns("p90", stats->p90);
+    fct_junit_logger__print_ns("p99", stats->p99);
+    fct_junit_logger__print_ns("mad", stats->mad);
+    fct_junit_logger__print_ns("ci_low", stats->ci_low);
+    fct_junit_logger__print_ns("ci_high", stats->ci_high);
+    printf("\t\t\t\t<property name=\"outliers\" value=\"%lu\" />\n",
+           (unsigned long)stats->num_outliers);
+    printf("\t\t\t\t<property name=\"samples\" value=\"%lu\" />\n",
+           (unsigned long)stats->num_samples);
+    printf("\t\t\t\t<property name=\"iterations\" value=\"%lu\" />\n",
+           (unsigned long)fct_bench_stats__num_iters(stats));
+    fct_junit_logger__print_perf(&(stats->perf),
+                                 (double)fct_bench_stats__num_iters(stats),
+                                 "_per_op");
+}
+
+
+static void
+fct_junit_logger__on_test_suite_start(
+    fct_logger_i *l,
+    fct_logger_evt_t const *e
+)
 {
-    FCT_ASSERT( nk != NULL );
-    FCT_ASSERT( ts != NULL );
-    FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, &(nk->logger_list))
+    fct_unused(l);
+    fct_unused(e);
+    FCT_SWITCH_STDOUT_TO_BUFFER();
+    FCT_SWITCH_STDERR_TO_BUFFER();
+}
+
+
+static void
+fct_junit_logger__on_test_suite_end(
+    fct_logger_i *logger_,
+    fct_logger_evt_t const *e
+)
+{
+    fct_ts_t const *ts = e->ts; /* Test Suite */
+    double elasped_time = 0;
+    char std_buffer[1024];
+    int read_length;
+    int first_out_line;
+
+    fct_unused(logger_);
+
+    elasped_time = fct_ts__duration(ts);
+
+    FCT_SWITCH_STDOUT_TO_STDOUT();
+    FCT_SWITCH_STDERR_TO_STDERR();
+
+    /* opening testsuite tag */
+    printf("\t<testsuite errors=\"%lu\" failures=\"0\" tests=\"%lu\" "
+           "name=\"%s\" time=\"%.6f\">\n",
+           (unsigned long)   fct_ts__tst_cnt(ts)
+           - fct_ts__tst_cnt_passed(ts),
+           (unsigned long) fct_ts__tst_cnt(ts),
+           fct_ts__name(ts),
+           elasped_time);
+    printf("\t\t<properties>\n");
+    fct_junit_logger__print_time("\t\t", "cpu_time",
+                                 fct_ts__cpu_duration(ts));
+    fct_junit_logger__print_time("\t\t", "thread_time",
+                                 fct_ts__thread_duration(ts));
+    if ( e->kern != NULL && e->kern->is_rusage )
     {
-        fct_logger__on_test_suite_start(logger, ts);
+        fct_junit_logger__print_rusage("\t\t", &(ts->rusage));
     }
-    FCT_NLIST_FOREACH_END();
-}
+    printf("\t\t</properties>\n");
 
-
-static void
-fctkern__log_suite_end(fctkern_t *nk, fct_ts_t const *ts)
-{
-    FCT_ASSERT( nk != NULL );
-    FCT_ASSERT( ts != NULL );
-    FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, &(nk->logger_list))
+    FCT_NLIST_FOREACH_BGN(fct_test_t*, test, &(ts->test_list))
     {
-        fct_logger__on_test_suite_end(logger, ts);
-    }
-    FCT_NLIST_FOREACH_END();
-}
+        /* opening testcase tag, the times follow as properties. */
+        printf("\t\t<testcase name=\"%s\" time=\"%.6f\">\n",
+               fct_test__name(test),
+               fct_test__duration(test)
+              );
+        printf("\t\t\t<properties>\n");
+        fct_junit_logger__print_time("\t\t\t", "cpu_time",
+                                     fct_test__cpu_duration(test));
+        fct_junit_logger__print_time("\t\t\t", "thread_time",
+                                     fct_test__thread_duration(test));
+        fct_junit_logger__print_time("\t\t\t", "setup_time",
+                                     fct_test__setup_duration(test));
+        fct_junit_logger__print_time("\t\t\t", "teardown_time",
+                                     fct_test__teardown_duration(test));
+        fct_junit_logger__print_perf(&(test->perf), 1.0, "");
+#if defined(FCT_ALLOC)
+        printf("\t\t\t\t<property name=\"allocs\" value=\"%lu\" />\n"
+               "\t\t\t\t<property name=\"alloc_bytes\" value=\"%lu\" />\n"
+               "\t\t\t\t<property name=\"peak_alloc_bytes\" value=\"%lu\" />\n",
+               (unsigned long)test->alloc.num_allocs,
+               (unsigned long)test->alloc.num_bytes,
+               (unsigned long)test->alloc.peak_bytes);
+#endif /* FCT_ALLOC */
+        if ( e->kern != NULL && e->kern->is_rusage )
+        {
+            fct_junit_logger__print_rusage("\t\t\t", &(test->rusage));
+        }
+        if ( test->bench != NULL )
+        {
+            fct_junit_logger__print_bench(test->bench);
+        }
+        printf("\t\t\t</properties>\n");
 
+        FCT_NLIST_FOREACH_BGN(fctchk_t*, chk, &(test->failed_chks))
+        {
+            /* error tag */
+            printf("\t\t\t<error message=\"%s\" "
+                   "type=\"fctx\">", chk->msg);
+            printf("file:%s, line:%d", chk->file, chk->lineno);
+            printf("</error>\n");
+        }
+        FCT_NLIST_FOREACH_END();
 
-static void
-fctkern__log_suite_skip(fctkern_t *nk, char const *condition, char const *name)
-{
-    if ( nk == NULL )
-    {
-        return;
-    }
-    FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, &(nk->logger_list))
-    {
-        fct_logger__on_test_suite_skip(logger, condition, name);
+        /* closing testcase tag */
+        printf("\t\t</testcase>\n");
     }
     FCT_NLIST_FOREACH_END();
-}
 
+    /* print the std streams */
+    first_out_line = 1;
+    printf("\t\t<system-out>\n\t\t\t<![CDATA[");
+    while ( (read_length = _fct_read(fct_stdout_pipe[0], std_buffer, 1024)) > 0)
+    {
+        if (first_out_line)
+        {
+            printf("\n");
+            first_out_line = 0;
+        }
+        printf("%.*s", read_length, std_buffer);
+    }
+    printf("]]>\n\t\t</system-out>\n");
 
-static void
-fctkern__log_test_skip(fctkern_t *nk, char const *condition, char const *name)
-{
-    FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, &(nk->logger_list))
+    first_out_line = 1;
+    printf("\t\t<system-err>\n\t\t\t<![CDATA[");
+    while ((read_length = _fct_read(fct_stderr_pipe[0], std_buffer, 1024)) > 0)
     {
-        fct_logger__on_test_skip(logger, condition, name);
+        if (first_out_line)
+        {
+            printf("\n");
+            first_out_line = 0;
+        }
+        printf("%.*s", read_length, std_buffer);
     }
-    FCT_NLIST_FOREACH_END();
-}
+    printf("]]>\n\t\t</system-err>\n");
 
+    /* closing testsuite tag */
+    printf("\t</testsuite>\n");
+}
 
-/* Use this for displaying information about a "Check" (i.e.
-a condition). */
 static void
-fctkern__log_chk(fctkern_t *nk, fctchk_t const *chk)
+fct_junit_logger__on_fct_start(
+    fct_logger_i *logger_,
+    fct_logger_evt_t const *e
+)
 {
-    FCT_ASSERT( nk != NULL );
-    FCT_ASSERT( chk != NULL );
-    FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, &(nk->logger_list))
-    {
-        fct_logger__on_chk(logger, chk);
-    }
-    FCT_NLIST_FOREACH_END();
+    fct_unused(logger_);
+    fct_unused(e);
+    printf("<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n");
+    printf("<testsuites>\n");
 }
 
-
-/* Use this for displaying warning messages. */
 static void
-fctkern__log_warn(fctkern_t *nk, char const *warn)
+fct_junit_logger__on_fctx_end(
+    fct_logger_i *logger_,
+    fct_logger_evt_t const *e
+)
 {
-    FCT_ASSERT( nk != NULL );
-    FCT_ASSERT( warn != NULL );
-    FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, &(nk->logger_list))
-    {
-        fct_logger__on_warn(logger, warn);
-    }
-    FCT_NLIST_FOREACH_END();
+    fct_unused(logger_);
+    fct_unused(e);
+    printf("</testsuites>\n");
 }
 
-
-/* Called whenever a test is started. */
 static void
-fctkern__log_test_start(fctkern_t *nk, fct_test_t const *test)
+fct_junit_logger__on_delete(
+    fct_logger_i *logger_,
+    fct_logger_evt_t const *e
+)
 {
-    FCT_ASSERT( nk != NULL );
-    FCT_ASSERT( test != NULL );
-    FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, &(nk->logger_list))
-    {
-        fct_logger__on_test_start(logger, test);
-    }
-    FCT_NLIST_FOREACH_END();
+    fct_junit_logger_t *logger = (fct_junit_logger_t*)logger_;
+    fct_unused(e);
+    fct_free(logger);
+    logger_ =NULL;
 }
 
 
-static void
-fctkern__log_test_end(fctkern_t *nk, fct_test_t *test)
+fct_junit_logger_t *
+fct_junit_logger_new(void)
 {
-    FCT_ASSERT( nk != NULL );
-    FCT_ASSERT( test != NULL );
-    FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, &(nk->logger_list))
+    fct_junit_logger_t *logger =
+        (fct_junit_logger_t *)fct_calloc(1, sizeof(fct_junit_logger_t));
+    if ( logger == NULL )
     {
-        fct_logger__on_test_end(logger, test);
+        return NULL;
     }
-    FCT_NLIST_FOREACH_END();
+    fct_logger__init((fct_logger_i*)logger);
+    logger->vtable.on_test_suite_start = fct_junit_logger__on_test_suite_start;
+    logger->vtable.on_test_suite_end = fct_junit_logger__on_test_suite_end;
+    logger->vtable.on_fctx_start = fct_junit_logger__on_fct_start;
+    logger->vtable.on_fctx_end = fct_junit_logger__on_fctx_end;
+    logger->vtable.on_delete = fct_junit_logger__on_delete;
+    return logger;
 }
 
 
-#define fctkern__log_start(_NK_) \
-   {\
-       FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, &((_NK_)->logger_list))\
-       {\
-          fct_logger__on_fctx_start(logger, (_NK_));\
-       }\
-       FCT_NLIST_FOREACH_END();\
-   }
-
-
-#define fctkern__log_end(_NK_) \
-    {\
-       FCT_NLIST_FOREACH_BGN(fct_logger_i*, logger, &((_NK_)->logger_list))\
-       {\
-          fct_logger__on_fctx_end(logger, (_NK_));\
-       }\
-       FCT_NLIST_FOREACH_END();\
-    }
-
-
-
-
 /*
 -----------------------------------------------------------
-LOGGER INTERFACE
-
-Defines an interface to a logging system. A logger
-must define the following functions in order to hook
-into the logging system.
-
-See the "Standard Logger" and "Minimal Logger" as examples
-of the implementation.
+PARALLEL JOBS
 -----------------------------------------------------------
-*/
-
-/* Common event argument. The values of the each event may or may not be
-defined depending on the event in question. */
-struct _fct_logger_evt_t
-{
-    fctkern_t const *kern;
-    fctchk_t const *chk;
-    fct_test_t const *test;
-    fct_ts_t const *ts;
-    char const *msg;
-    char const *cndtn;
-    char const *name;
-};
-
 
-typedef struct _fct_logger_i_vtable_t
-{
-    /* 1
-     * Fired when an "fct_chk*" (check) function is completed. The event
-     * will contain a reference to the "chk" object created.
-     * */
-    void (*on_chk)(fct_logger_i *logger, fct_logger_evt_t const *e);
-
-    /* 2
-     * Fired when a test starts and before any checks are made. The
-     * event will have its "test" object set. */
-    void (*on_test_start)(
-        fct_logger_i *logger,
-        fct_logger_evt_t const *e
-    );
-    /* 3 */
-    void (*on_test_end)(
-        fct_logger_i *logger,
-        fct_logger_evt_t const *e
-    );
-    /* 4 */
-    void (*on_test_suite_start)(
-        fct_logger_i *logger,
-        fct_logger_evt_t const *e
-    );
-    /* 5 */
-    void (*on_test_suite_end)(
-        fct_logger_i *logger,
-        fct_logger_evt_t const *e
-    );
-    /* 6 */
-    void (*on_fctx_start)(
-        fct_logger_i *logger,
-        fct_logger_evt_t const *e
-    );
-    /* 7 */
-    void (*on_fctx_end)(
-        fct_logger_i *logger,
-        fct_logger_evt_t const *e
-    );
-    /* 8
-    Called when the logger object must "clean up". */
-    void (*on_delete)(
-        fct_logger_i *logger,
-        fct_logger_evt_t const *e
-    );
-    /* 9 */
-    void (*on_warn)(
-        fct_logger_i *logger,
-        fct_logger_evt_t const *e
-    );
-    /* -- new in 1.2 -- */
-    /* 10 */
-    void (*on_test_suite_skip)(
-        fct_logger_i *logger,
-        fct_logger_evt_t const *e
-    );
-    /* 11 */
-    void (*on_test_skip)(
-        fct_logger_i *logger,
-        fct_logger_evt_t const *e
-    );
-} fct_logger_i_vtable_t;
+With --jobs N the parent process forks N workers as soon as the
+command line is parsed. Every process then walks the same suites,
+and numbers the selected tests the same way. A worker claims the
+next number from a counter in shared memory, runs only that test,
+and then claims another. Its loggers are swapped for a "stream"
+logger that writes each event down a pipe, tagged with the number
+of the test. The parent never runs a setup or a test. When it
+reaches a test it waits for the test's records and replays them
+into its own loggers, so the output is in the same order as a
+serial run. A worker that dies turns its test into a failure.
+
+With --isolate a worker does not run the tests itself. It stays at the
+point it was forked, a "zygote", and forks a child for each test it
+claims. The child runs the one test and exits, so no test sees what
+another test did to the process. Put FCT_ZYGOTE_READY after any
+expensive start up, so it is done once and shared copy-on-write.
+
+The tests need to be independent of each other for this to work.
+*/
 
-#define _fct_logger_head \
-    fct_logger_i_vtable_t vtable; \
-    fct_logger_evt_t evt
+#if defined(FCT_JOBS)
+#   if defined(PIPE_BUF)
+#       define FCT_JOBS_REC_MAX PIPE_BUF
+#   else
+#       define FCT_JOBS_REC_MAX 512
+#   endif
+
+enum
+{
+    FCT_JOBS_REC_TEST_START =1,
+    FCT_JOBS_REC_CHK,
+    /* The ival[0] holds its count of passed checks, which are not sent
+    as CHK records, and the ival[1] the failures past --max-failures.
+    The texts are its perf counts, allocation counts and resource
+    usage. */
+    FCT_JOBS_REC_TEST_END,
+    FCT_JOBS_REC_SKIP,
+    FCT_JOBS_REC_WARN,
+    /* Sent before the TEST_END of a benchmark, see
+    fct_jobs__write_bench. */
+    FCT_JOBS_REC_BENCH,
+    /* The worker is finished with the test. */
+    FCT_JOBS_REC_DONE,
+    /* Made up by the parent, for a worker that died. */
+    FCT_JOBS_REC_CRASH
+};
 
-struct _fct_logger_i
+/* The ival[0] of a CRASH when there was no worker to run the test. */
+#define FCT_JOBS_NO_JOB ((size_t)-1)
+
+/* The header of a record, the text follows it as a series of '\0'
+terminated strings. */
+typedef struct _fct_jobs_rec_t
 {
-    _fct_logger_head;
-};
+    int type;
+    int seq;
+    /* Wide enough for the exact counts of a TEST_END. */
+    size_t ival[2];
+    /* The setup times of a TEST_START, the test's of a TEST_END, and
+    the teardown's of a DONE. */
+    fct_timer_t timer;
+    size_t len;
+} fct_jobs_rec_t;
+
+#define fct_jobs_rec__text(_REC_) ((char*)((_REC_)+1))
+
+/* Returns the string after STR within the record text. */
+static char const *
+fct_jobs_rec__next_str(char const *str)
+{
+    return str + strlen(str) + 1;
+}
 
 
+/* Sends a single record, with up to three strings and the TIMER if it
+is not NULL. A record is written
+with one call no larger than PIPE_BUF, so the records from different
+workers never interleave. Long strings are cut short to fit. */
 static void
-fct_logger__stub(fct_logger_i *l, fct_logger_evt_t const *e)
+fct_jobs__write(fct_jobs_t *jobs,
+                int type,
+                int seq,
+                size_t ival0,
+                size_t ival1,
+                fct_timer_t const *timer,
+                char const *s0,
+                char const *s1,
+                char const *s2)
+{
+    char buf[FCT_JOBS_REC_MAX];
+    char const *strs[3];
+    fct_jobs_rec_t rec;
+    size_t max_len = (sizeof(buf) - sizeof(rec)) / 3;
+    size_t str_i =0;
+    char *itr = buf + sizeof(rec);
+    FCT_ASSERT( jobs != NULL );
+    strs[0] = s0;
+    strs[1] = s1;
+    strs[2] = s2;
+    for ( str_i =0; str_i != 3 && strs[str_i] != NULL; ++str_i )
+    {
+        size_t len = strlen(strs[str_i]);
+        if ( len >= max_len )
+        {
+            len = max_len - 1;
+        }
+        memcpy(itr, strs[str_i], len);
+        itr[len] = '\0';
+        itr += len + 1;
+    }
+    memset(&rec, 0, sizeof(rec));
+    rec.type = type;
+    rec.seq = seq;
+    rec.ival[0] = ival0;
+    rec.ival[1] = ival1;
+    if ( timer != NULL )
+    {
+        rec.timer = *timer;
+    }
+    rec.len = (size_t)(itr - (buf + sizeof(rec)));
+    memcpy(buf, &rec, sizeof(rec));
+    while ( write(jobs->fd, buf, sizeof(rec) + rec.len) < 0
+            && errno == EINTR )
+    {
+        fct_pass();
+    }
+}
+
+
+/* Reads exactly LEN bytes, returns FCT_FALSE at the end of the pipe. */
+static nbool_t
+fct_jobs__read_all(int fd, char *buf, size_t len)
 {
-    fct_unused(l);
-    fct_unused(e);
+    while ( len > 0 )
+    {
+        ssize_t got = read(fd, buf, len);
+        if ( got < 0 && errno == EINTR )
+        {
+            continue;
+        }
+        if ( got <= 0 )
+        {
+            return FCT_FALSE;
+        }
+        buf += got;
+        len -= (size_t)got;
+    }
+    return FCT_TRUE;
 }
 
 
-static fct_logger_i_vtable_t fct_logger_default_vtable =
+/* Reads the next record off the pipe, returns NULL once every worker
+has closed its end. */
+static fct_jobs_rec_t *
+fct_jobs__read(int fd)
 {
-    fct_logger__stub,   /* 1.  on_chk */
-    fct_logger__stub,   /* 2.  on_test_start */
-    fct_logger__stub,   /* 3.  on_test_end */
-    fct_logger__stub,   /* 4.  on_test_suite_start */
-    fct_logger__stub,   /* 5.  on_test_suite_end */
-    fct_logger__stub,   /* 6.  on_fctx_start */
-    fct_logger__stub,   /* 7.  on_fctx_end */
-    fct_logger__stub,   /* 8.  on_delete */
-    fct_logger__stub,   /* 9.  on_warn */
-    fct_logger__stub,   /* 10. on_test_suite_skip */
-    fct_logger__stub,   /* 11. on_test_skip */
-};
+    fct_jobs_rec_t hdr;
+    fct_jobs_rec_t *rec =NULL;
+    if ( !fct_jobs__read_all(fd, (char*)&hdr, sizeof(hdr)) )
+    {
+        return NULL;
+    }
+    rec = (fct_jobs_rec_t*)fct_malloc(sizeof(hdr) + hdr.len);
+    FCT_ASSERT( rec != NULL );
+    *rec = hdr;
+    if ( !fct_jobs__read_all(fd, fct_jobs_rec__text(rec), hdr.len) )
+    {
+        fct_free(rec);
+        return NULL;
+    }
+    return rec;
+}
 
 
-/* Initializes the elements of a logger interface so they are at their
-standard values. */
+/* Collects the workers that have exited. A worker that goes before
+saying it is finished takes its test with it, so we leave a CRASH
+record in its place. Waits for them to exit if IS_HANG is set. */
 static void
-fct_logger__init(fct_logger_i *logger)
+fct_jobs__reap(fct_jobs_t *jobs, nbool_t is_hang)
 {
-    FCT_ASSERT( logger != NULL );
-    memcpy(
-        &(logger->vtable),
-        &fct_logger_default_vtable,
-        sizeof(fct_logger_i_vtable_t)
-    );
-    memset(&(logger->evt),0, sizeof(fct_logger_evt_t));
+    int worker_i =0;
+    for ( worker_i =0; worker_i != jobs->num; ++worker_i )
+    {
+        int status =0;
+        pid_t pid = (pid_t)jobs->pids[worker_i];
+        int claim =0;
+        fct_jobs_rec_t *rec =NULL;
+        if ( pid <= 0 )
+        {
+            continue;
+        }
+        if ( waitpid(pid, &status, (is_hang) ? 0 : WNOHANG) != pid )
+        {
+            continue;
+        }
+        jobs->pids[worker_i] = 0;
+        claim = jobs->shm->claims[worker_i];
+        if ( claim < 0 )
+        {
+            continue;
+        }
+        rec = (fct_jobs_rec_t*)fct_calloc(1, sizeof(fct_jobs_rec_t));
+        FCT_ASSERT( rec != NULL );
+        rec->type = FCT_JOBS_REC_CRASH;
+        rec->seq = claim;
+        rec->ival[0] = (size_t)WIFSIGNALED(status);
+        rec->ival[1] = (size_t)((WIFSIGNALED(status)) ?
+                                WTERMSIG(status) : WEXITSTATUS(status));
+        fct_nlist__append(&(jobs->recs), rec);
+    }
 }
 
+
+/* Waits a short while for the next record from the workers, checking
+on the workers if nothing shows up. */
 static void
-fct_logger__del(fct_logger_i *logger)
-{
-    if ( logger )
+fct_jobs__pump(fct_jobs_t *jobs)
+{
+    struct pollfd pfd;
+    fct_jobs_rec_t *rec =NULL;
+    pfd.fd = jobs->fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if ( poll(&pfd, 1, 100) <= 0 )
     {
-        logger->vtable.on_delete(logger, &(logger->evt));
+        fct_jobs__reap(jobs, FCT_FALSE);
+        return;
+    }
+    rec = fct_jobs__read(jobs->fd);
+    if ( rec != NULL )
+    {
+        fct_nlist__append(&(jobs->recs), rec);
+        return;
     }
+    /* Every worker has gone. */
+    (void)close(jobs->fd);
+    jobs->fd = -1;
+    fct_jobs__reap(jobs, FCT_TRUE);
 }
 
 
+/* Takes the next test number from the shared counter. */
 static void
-fct_logger__on_test_start(fct_logger_i *logger, fct_test_t const *test)
+fct_jobs__claim(fct_jobs_t *jobs)
 {
-    logger->evt.test = test;
-    logger->vtable.on_test_start(logger, &(logger->evt));
+    jobs->claim = __sync_fetch_and_add(&(jobs->shm->next_seq), 1);
+    jobs->shm->claims[jobs->worker_id] = jobs->claim;
 }
 
 
+/* The worker of an isolated run. Claims a test, forks a child to run
+it and waits for it, until the tests run out. Only returns in a child.
+The child that died is reported here, as the parent only sees us. */
 static void
-fct_logger__on_test_end(fct_logger_i *logger, fct_test_t *test)
+fct_jobs__zygote(fct_jobs_t *jobs)
 {
-    logger->evt.test = test;
-    logger->vtable.on_test_end(logger, &(logger->evt));
+    while ( !jobs->shm->is_drained )
+    {
+        int status =0;
+        pid_t pid =0;
+        fct_jobs__claim(jobs);
+        pid = fork();
+        if ( pid == 0 )
+        {
+            return;
+        }
+        if ( pid < 0 )
+        {
+            fct_jobs__write(jobs, FCT_JOBS_REC_CRASH, jobs->claim,
+                            FCT_JOBS_NO_JOB, 0, NULL, NULL, NULL, NULL);
+            break;
+        }
+        while ( waitpid(pid, &status, 0) < 0 && errno == EINTR )
+        {
+            fct_pass();
+        }
+        if ( !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS )
+        {
+            fct_jobs__write(jobs,
+                            FCT_JOBS_REC_CRASH,
+                            jobs->claim,
+                            (size_t)WIFSIGNALED(status),
+                            (size_t)((WIFSIGNALED(status)) ?
+                                     WTERMSIG(status) : WEXITSTATUS(status)),
+                            NULL,
+                            NULL,
+                            NULL,
+                            NULL);
+        }
+    }
+    jobs->shm->claims[jobs->worker_id] = -1;
+    (void)close(jobs->fd);
+    _exit(EXIT_SUCCESS);
 }
 
 
+/* Sends what a benchmark measured as text, the batch size and warm up
+iterations, the samples and the perf counts. Each sample ends in a
+space, so one cut short to fit the record is left off. */
 static void
-fct_logger__on_test_suite_start(fct_logger_i *logger, fct_ts_t const *ts)
+fct_jobs__write_bench(fct_jobs_t *jobs, fct_bench_stats_t const *stats)
 {
-    logger->evt.ts = ts;
-    logger->vtable.on_test_suite_start(logger, &(logger->evt));
+    char counts[64];
+    char samples[FCT_JOBS_REC_MAX];
+    char perf[FCT_MAX_LOG_LINE];
+    size_t len =0;
+    size_t sample_i =0;
+    fct_snprintf(counts,
+                 sizeof(counts),
+                 "%lu %lu",
+                 (unsigned long)stats->batch,
+                 (unsigned long)stats->num_warmup_iters);
+    samples[0] = '\0';
+    for ( sample_i =0; sample_i != stats->num_samples; ++sample_i )
+    {
+        int n = fct_snprintf(samples + len,
+                             sizeof(samples) - len,
+                             "%.9g ",
+                             stats->samples[sample_i]);
+        if ( n < 0 || (size_t)n >= sizeof(samples) - len )
+        {
+            break;
+        }
+        len += (size_t)n;
+    }
+    samples[len] = '\0';
+    fct_perf__to_str(&(stats->perf), perf, sizeof(perf));
+    fct_jobs__write(jobs, FCT_JOBS_REC_BENCH, jobs->claim, 0, 0, NULL,
+                    perf, counts, samples);
 }
 
 
-static void
-fct_logger__on_test_suite_end(fct_logger_i *logger, fct_ts_t const *ts)
+/* Reads back what fct_jobs__write_bench sent, from the ARENA. */
+static fct_bench_stats_t *
+fct_jobs__bench_new(fct_arena_t *arena,
+                    char const *perf,
+                    char const *counts,
+                    char const *samples)
 {
-    logger->evt.ts = ts;
-    logger->vtable.on_test_suite_end(logger, &(logger->evt));
+    fct_bench_stats_t *stats =NULL;
+    char *end =NULL;
+    stats = (fct_bench_stats_t*)fct_arena__alloc(arena,
+            sizeof(fct_bench_stats_t));
+    if ( stats == NULL )
+    {
+        return NULL;
+    }
+    memset(stats, 0, sizeof(fct_bench_stats_t));
+    stats->batch = (size_t)strtoul(counts, &end, 10);
+    stats->num_warmup_iters = (size_t)strtoul(end, NULL, 10);
+    fct_bench_stats__read_samples(stats, samples);
+    fct_perf__from_str(&(stats->perf), perf);
+    return stats;
 }
 
 
+/* Worker side, writes its events down the pipe. */
+typedef struct _fct_stream_logger_t
+{
+    _fct_logger_head;
+    fct_jobs_t *jobs;
+} fct_stream_logger_t;
+
+
 static void
-fct_logger__on_test_suite_skip(
-    fct_logger_i *logger,
-    char const *condition,
-    char const *name
-)
+fct_stream_logger__on_chk(fct_logger_i *self_, fct_logger_evt_t const *e)
 {
-    logger->evt.cndtn = condition;
-    logger->evt.name = name;
-    logger->vtable.on_test_suite_skip(logger, &(logger->evt));
+    fct_jobs_t *jobs = ((fct_stream_logger_t*)self_)->jobs;
+#if !defined(FCT_CONF_KEEP_PASSED_CHKS)
+    /* A pass is only counted, and the count goes with the end of the
+    test. */
+    if ( fctchk__is_pass(e->chk) )
+    {
+        return;
+    }
+#endif /* FCT_CONF_KEEP_PASSED_CHKS */
+    fct_jobs__write(jobs,
+                    FCT_JOBS_REC_CHK,
+                    jobs->claim,
+                    (size_t)fctchk__is_pass(e->chk),
+                    (size_t)fctchk__lineno(e->chk),
+                    NULL,
+                    fctchk__cndtn(e->chk),
+                    fctchk__file(e->chk),
+                    fctchk__msg(e->chk));
 }
 
 
 static void
-fct_logger__on_test_skip(
-    fct_logger_i *logger,
-    char const *condition,
-    char const *name
-)
+fct_stream_logger__on_test_start(fct_logger_i *self_,
+                                 fct_logger_evt_t const *e)
 {
-    logger->evt.cndtn = condition;
-    logger->evt.name = name;
-    logger->vtable.on_test_skip(logger, &(logger->evt));
+    fct_jobs_t *jobs = ((fct_stream_logger_t*)self_)->jobs;
+    fct_jobs__write(jobs, FCT_JOBS_REC_TEST_START, jobs->claim, 0, 0,
+                    &(e->test->setup_timer), fct_test__name(e->test), NULL,
+                    NULL);
 }
 
 
 static void
-fct_logger__on_chk(fct_logger_i *logger, fctchk_t const *chk)
+fct_stream_logger__on_test_end(fct_logger_i *self_, fct_logger_evt_t const *e)
 {
-    logger->evt.chk = chk;
-    logger->vtable.on_chk(logger, &(logger->evt));
+    fct_jobs_t *jobs = ((fct_stream_logger_t*)self_)->jobs;
+    char perf[FCT_MAX_LOG_LINE];
+    char alloc[FCT_MAX_LOG_LINE];
+    char rusage[FCT_MAX_LOG_LINE];
+    if ( e->test->bench != NULL )
+    {
+        fct_jobs__write_bench(jobs, e->test->bench);
+    }
+    fct_perf__to_str(&(e->test->perf), perf, sizeof(perf));
+    fct_alloc__to_str(&(e->test->alloc), alloc, sizeof(alloc));
+    fct_rusage__to_str(&(e->test->rusage), rusage, sizeof(rusage));
+    fct_jobs__write(jobs, FCT_JOBS_REC_TEST_END, jobs->claim,
+                    e->test->num_passed, e->test->num_dropped,
+                    &(e->test->timer), perf, alloc, rusage);
+    ++(jobs->num_streamed);
 }
 
-/* When we start all our tests. */
-#define fct_logger__on_fctx_start(LOGGER, KERN) \
-   (LOGGER)->evt.kern = (KERN);\
-   (LOGGER)->vtable.on_fctx_start((LOGGER), &((LOGGER)->evt));
 
-
-/* When we have reached the end of ALL of our testing. */
-#define fct_logger__on_fctx_end(LOGGER, KERN) \
-    (LOGGER)->evt.kern = (KERN);\
-    (LOGGER)->vtable.on_fctx_end((LOGGER), &((LOGGER)->evt));
+static void
+fct_stream_logger__on_test_skip(fct_logger_i *self_,
+                                fct_logger_evt_t const *e)
+{
+    fct_jobs_t *jobs = ((fct_stream_logger_t*)self_)->jobs;
+    fct_jobs__write(jobs, FCT_JOBS_REC_SKIP, jobs->claim, 0, 0, NULL,
+                    e->cndtn, e->name, NULL);
+}
 
 
 static void
-fct_logger__on_warn(fct_logger_i *logger, char const *msg)
+fct_stream_logger__on_warn(fct_logger_i *self_, fct_logger_evt_t const *e)
 {
-    logger->evt.msg = msg;
-    logger->vtable.on_warn(logger, &(logger->evt));
+    fct_jobs_t *jobs = ((fct_stream_logger_t*)self_)->jobs;
+    fct_jobs__write(jobs, FCT_JOBS_REC_WARN, jobs->claim, 0, 0, NULL,
+                    e->msg, NULL, NULL);
 }
 
 
-/* Common routine to record strings representing failures. The
-chk should be a failure before we call this, and the list is a list
-of char*'s that will eventually be free'd by the logger. */
 static void
-fct_logger_record_failure(fctchk_t const* chk, fct_nlist_t* fail_list)
+fct_stream_logger__on_delete(fct_logger_i *self_, fct_logger_evt_t const *e)
 {
-    /* For now we will truncate the string to some set amount, later
-    we can work out a dynamic string object. */
-    char *str = (char*)malloc(sizeof(char)*FCT_MAX_LOG_LINE);
-    FCT_ASSERT( str != NULL );
-    fct_snprintf(
-        str,
-        FCT_MAX_LOG_LINE,
-        "%s(%d):\n    %s",
-        fctchk__file(chk),
-        fctchk__lineno(chk),
-        fctchk__msg(chk)
-    );
-    /* Append it to the listing ... */
-    fct_nlist__append(fail_list, (void*)str);
+    fct_unused(e);
+    fct_free(self_);
 }
 
 
-/* Another common routine, to print the failures at the end of a run. */
+static fct_logger_i *
+fct_stream_logger_new(fct_jobs_t *jobs)
+{
+    fct_stream_logger_t *self =
+        (fct_stream_logger_t*)fct_calloc(1, sizeof(fct_stream_logger_t));
+    if ( self == NULL )
+    {
+        return NULL;
+    }
+    fct_logger__init((fct_logger_i*)self);
+    self->vtable.on_chk = fct_stream_logger__on_chk;
+    self->vtable.on_test_start = fct_stream_logger__on_test_start;
+    self->vtable.on_test_end = fct_stream_logger__on_test_end;
+    self->vtable.on_test_skip = fct_stream_logger__on_test_skip;
+    self->vtable.on_warn = fct_stream_logger__on_warn;
+    self->vtable.on_delete = fct_stream_logger__on_delete;
+    self->jobs = jobs;
+    return (fct_logger_i*)self;
+}
+
+
+/* Builds a check out of its parts, the message is used as is. */
+static fctchk_t *
+fct_jobs__chk_new(fct_arena_t *arena,
+                  int is_pass,
+                  char const *cndtn,
+                  char const *file,
+                  int lineno,
+                  char const *format,
+                  ...)
+{
+    fctchk_t *chk =NULL;
+    va_list args;
+    va_start(args, format);
+    chk = fctchk_new(arena, is_pass, cndtn, file, lineno, format, args);
+    va_end(args);
+    return chk;
+}
+
+
+
+
+/* Called by the parent for each selected test, in order. Waits until
+the worker that ran it is done, and hands its records to our loggers. */
 static void
-fct_logger_print_failures(fct_nlist_t const *fail_list)
+fctkern__jobs_replay(fctkern_t *nk,
+                     fct_ts_t *ts,
+                     fct_ts_entry_t const *entry)
 {
-    puts(
-        "\n----------------------------------------------------------------------------\n"
-    );
-    puts("FAILED TESTS\n\n");
-    FCT_NLIST_FOREACH_BGN(char *, cndtn_str, fail_list)
+    fct_jobs_t *jobs = &(nk->jobs);
+    fct_test_t *test =NULL;
+    /* The last test to end, the teardown that follows is its own. */
+    fct_test_t *torn_down =NULL;
+    nbool_t is_abort =FCT_FALSE;
+    nbool_t is_done =FCT_FALSE;
+    size_t rec_i =0;
+    size_t keep_num =0;
+    /* Only the records that arrive while we wait need to be looked at
+    again. */
+    while ( !is_done )
+    {
+        for ( ; rec_i < fct_nlist__size(&(jobs->recs)); ++rec_i )
+        {
+            fct_jobs_rec_t const *rec =
+                (fct_jobs_rec_t const*)fct_nlist__at(&(jobs->recs), rec_i);
+            if ( rec->seq == entry->seq
+                    && (rec->type == FCT_JOBS_REC_DONE
+                        || rec->type == FCT_JOBS_REC_CRASH) )
+            {
+                is_done = FCT_TRUE;
+            }
+        }
+        if ( is_done )
+        {
+            break;
+        }
+        if ( jobs->fd < 0 )
+        {
+            /* Every worker is gone, nobody is left to run it. */
+            fct_jobs_rec_t *rec =
+                (fct_jobs_rec_t*)fct_calloc(1, sizeof(fct_jobs_rec_t));
+            FCT_ASSERT( rec != NULL );
+            rec->type = FCT_JOBS_REC_CRASH;
+            rec->seq = entry->seq;
+            rec->ival[0] = FCT_JOBS_NO_JOB;
+            fct_nlist__append(&(jobs->recs), rec);
+            break;
+        }
+        fct_jobs__pump(jobs);
+    }
+    /* Replay this test's records in the order they where sent, and keep
+    the rest for later. The tests aborted by a setup or teardown are
+    added to the suite without being logged, as in a serial run. */
+    for ( rec_i =0; rec_i != fct_nlist__size(&(jobs->recs)); ++rec_i )
+    {
+        fct_jobs_rec_t *rec =
+            (fct_jobs_rec_t*)fct_nlist__at(&(jobs->recs), rec_i);
+        char const *str0 = fct_jobs_rec__text(rec);
+        if ( rec->seq != entry->seq )
+        {
+            jobs->recs.itm_list[keep_num++] = rec;
+            continue;
+        }
+        switch ( rec->type )
+        {
+        case FCT_JOBS_REC_TEST_START:
+            test = fct_test_new2(str0, FCT_FALSE, fct_ts__arena(ts));
+            FCT_ASSERT( test != NULL );
+            test->setup_timer = rec->timer;
+            is_abort = (nbool_t)rec->ival[0];
+            if ( !is_abort )
+            {
+                fctkern__log_test_start(nk, test);
+            }
+            break;
+        case FCT_JOBS_REC_CHK:
+        {
+            char const *str1 = fct_jobs_rec__next_str(str0);
+            char const *str2 = fct_jobs_rec__next_str(str1);
+            fctchk_t *chk = fct_jobs__chk_new(
+                                fct_ts__arena(ts), (int)rec->ival[0], str0, str1,
+                                (int)rec->ival[1],
+                                "%s", str2
+                            );
+            FCT_ASSERT( chk != NULL );
+            /* The checks of an aborted test where logged as they
+            happened. */
+            if ( test == NULL || !is_abort )
+            {
+                fctkern__log_chk(nk, chk);
+            }
+            if ( test != NULL )
+            {
+                fct_test__add(test, chk);
+            }
+            else
+            {
+                fctchk__del(chk);
+            }
+            break;
+        }
+        case FCT_JOBS_REC_CRASH:
+        {
+            char msg[FCT_MAX_LOG_LINE];
+            fctchk_t *chk =NULL;
+            if ( rec->ival[0] == FCT_JOBS_NO_JOB )
+            {
+                fctstr_safe_cpy(msg, "no job left to run the test",
+                                sizeof(msg));
+            }
+            else
+            {
+                fct_snprintf(msg,
+                             sizeof(msg),
+                             (rec->ival[0]) ?
+                             "test process killed by signal %d" :
+                             "test process exited early with status %d",
+                             (int)rec->ival[1]);
+            }
+            if ( test == NULL || is_abort )
+            {
+                test = fct_test_new2(entry->name, FCT_FALSE, fct_ts__arena(ts));
+                FCT_ASSERT( test != NULL );
+                is_abort = FCT_FALSE;
+                fctkern__log_test_start(nk, test);
+            }
+            chk = fct_jobs__chk_new(fct_ts__arena(ts), FCT_FALSE, msg, fct_ts__name(ts), 1,
+                                    "%s", msg);
+            FCT_ASSERT( chk != NULL );
+            fctkern__log_chk(nk, chk);
+            fct_test__add(test, chk);
+            fct_ts__add_test(ts, test);
+            fctkern__log_test_end(nk, test);
+            test = NULL;
+            break;
+        }
+        case FCT_JOBS_REC_TEST_END:
+            FCT_ASSERT( test != NULL );
+            test->timer = rec->timer;
+            if ( rec->len > 0 )
+            {
+                char const *str1 = fct_jobs_rec__next_str(str0);
+                fct_perf__from_str(&(test->perf), str0);
+                fct_alloc__from_str(&(test->alloc), str1);
+                fct_rusage__from_str(&(test->rusage),
+                                     fct_jobs_rec__next_str(str1));
+            }
+            /* The passed checks only come as a count, and are only
+            counted: the loggers see the failures. */
+            test->num_passed += rec->ival[0];
+            test->num_dropped += rec->ival[1];
+            fct_ts__add_test(ts, test);
+            if ( !is_abort )
+            {
+                fctkern__log_test_end(nk, test);
+            }
+            torn_down = test;
+            test = NULL;
+            break;
+        case FCT_JOBS_REC_DONE:
+            if ( torn_down != NULL )
+            {
+                torn_down->teardown_timer = rec->timer;
+            }
+            break;
+        case FCT_JOBS_REC_BENCH:
+            if ( test != NULL )
+            {
+                char const *str1 = fct_jobs_rec__next_str(str0);
+                test->bench = fct_jobs__bench_new(
+                                  fct_ts__arena(ts), str0, str1,
+                                  fct_jobs_rec__next_str(str1)
+                              );
+            }
+            break;
+        case FCT_JOBS_REC_SKIP:
+            fctkern__log_test_skip(nk, str0, fct_jobs_rec__next_str(str0));
+            break;
+        case FCT_JOBS_REC_WARN:
+            fctkern__log_warn(nk, str0);
+            break;
+        default:
+            break;
+        }
+        fct_free(rec);
+    }
+    jobs->recs.used_itm_num = keep_num;
+    /* The workers are all gone without finishing the test, what was sent
+    is all we get. */
+    if ( test != NULL )
     {
-        printf("%s\n", cndtn_str);
+        fct_ts__add_test(ts, test);
+        if ( !is_abort )
+        {
+            fctkern__log_test_end(nk, test);
+        }
     }
-    FCT_NLIST_FOREACH_END();
+}
 
-    puts("\n");
+
+/* Worker only. Sends the tests that setup or teardown aborted, these
+are never logged. */
+static void
+fctkern__jobs_stream_aborts(fctkern_t *nk, fct_ts_t *ts)
+{
+    fct_jobs_t *jobs = &(nk->jobs);
+    size_t test_i =0;
+    for ( test_i = jobs->num_streamed;
+            test_i < fct_nlist__size(&(ts->test_list));
+            ++test_i )
+    {
+        fct_test_t const *test =
+            (fct_test_t const*)fct_nlist__at(&(ts->test_list), test_i);
+        char perf[FCT_MAX_LOG_LINE];
+        char alloc[FCT_MAX_LOG_LINE];
+        char rusage[FCT_MAX_LOG_LINE];
+        fct_nlist_t const *lists[2];
+        size_t list_i =0;
+        lists[0] = &(test->failed_chks);
+        lists[1] = &(test->passed_chks);
+        fct_jobs__write(jobs, FCT_JOBS_REC_TEST_START, jobs->claim, 1, 0,
+                        &(test->setup_timer), fct_test__name(test), NULL,
+                        NULL);
+        for ( list_i =0; list_i != 2; ++list_i )
+        {
+            FCT_NLIST_FOREACH_BGN(fctchk_t*, chk, lists[list_i])
+            {
+                fct_jobs__write(jobs,
+                                FCT_JOBS_REC_CHK,
+                                jobs->claim,
+                                (size_t)fctchk__is_pass(chk),
+                                (size_t)fctchk__lineno(chk),
+                                NULL,
+                                fctchk__cndtn(chk),
+                                fctchk__file(chk),
+                                fctchk__msg(chk));
+            }
+            FCT_NLIST_FOREACH_END();
+        }
+        fct_perf__to_str(&(test->perf), perf, sizeof(perf));
+        fct_alloc__to_str(&(test->alloc), alloc, sizeof(alloc));
+        fct_rusage__to_str(&(test->rusage), rusage, sizeof(rusage));
+        fct_jobs__write(jobs, FCT_JOBS_REC_TEST_END, jobs->claim,
+                        test->num_passed, test->num_dropped,
+                        &(test->timer), perf, alloc, rusage);
+    }
+    jobs->num_streamed = fct_nlist__size(&(ts->test_list));
 }
 
 
+/* Worker only. Tells the parent we are finished with our test, and
+claims the next one. If that one is in this suite it is selected. */
+static void
+fctkern__jobs_next(fctkern_t *nk, fct_ts_t *ts)
+{
+    fct_jobs_t *jobs = &(nk->jobs);
+    int entry_i =0;
+    fctkern__jobs_stream_aborts(nk, ts);
+    fct_jobs__write(jobs, FCT_JOBS_REC_DONE, jobs->claim, 0, 0,
+                    &(ts->teardown_timer), NULL, NULL, NULL);
+    if ( jobs->is_isolate )
+    {
+        (void)fflush(NULL);
+        _exit(EXIT_SUCCESS);
+    }
+    fct_jobs__claim(jobs);
+    for ( entry_i =0; entry_i != ts->entry_num; ++entry_i )
+    {
+        if ( ts->entries[entry_i].seq == jobs->claim )
+        {
+            ts->entries[entry_i].is_selected = FCT_TRUE;
+        }
+    }
+}
+#endif /* FCT_JOBS */
 
 
-/*
------------------------------------------------------------
-MINIMAL LOGGER
------------------------------------------------------------
-
-At the moment the MINIMAL LOGGER is currently disabled. Hope
-to bring it back online soon. The only reason it is
-disabled is that we don't currently have the ability to specify
-loggers.
-*/
-
-
-/* Minimal logger, reports the minimum amount of information needed
-to determine "something is happening". */
-struct _fct_minimal_logger_t
-{
-    _fct_logger_head;
-    /* A list of char*'s that needs to be cleaned up. */
-    fct_nlist_t failed_cndtns_list;
-};
+/* Forks the workers, the first time it is called after the command line
+was parsed, if we where asked to with --jobs or --isolate. Each worker
+returns from here with its loggers swapped out for a stream logger. */
+static void
+fctkern__jobs_start(fctkern_t *nk)
+{
+    fct_jobs_t *jobs = &(nk->jobs);
+    int num =0;
+    nbool_t is_isolate =FCT_FALSE;
+#if defined(FCT_JOBS)
+    int fds[2];
+    int worker_i =0;
+#endif /* FCT_JOBS */
+    if ( jobs->is_started || !fctkern__cl_is_parsed(nk) )
+    {
+        return;
+    }
+    jobs->is_started = FCT_TRUE;
+    num = atoi(fctkern__cl_val2(nk, FCT_OPT_JOBS, "0"));
+    is_isolate = fctkern__cl_is(nk, FCT_OPT_ISOLATE);
+    if ( num <= 1 && !is_isolate )
+    {
+        return;
+    }
+#if defined(FCT_JOBS)
+    if ( num < 1 )
+    {
+        num = 1;
+    }
+    if ( num > FCT_MAX_JOBS )
+    {
+        num = FCT_MAX_JOBS;
+    }
+    jobs->shm = (fct_jobs_shm_t*)mmap(NULL,
+                                      sizeof(fct_jobs_shm_t),
+                                      PROT_READ | PROT_WRITE,
+                                      MAP_SHARED | FCT_MAP_ANON,
+                                      -1,
+                                      0);
+    if ( jobs->shm == (fct_jobs_shm_t*)MAP_FAILED )
+    {
+        jobs->shm = NULL;
+        fctkern__log_warn(nk, "unable to start the jobs, running serially");
+        return;
+    }
+    if ( pipe(fds) != 0 )
+    {
+        (void)munmap((void*)jobs->shm, sizeof(fct_jobs_shm_t));
+        jobs->shm = NULL;
+        fctkern__log_warn(nk, "unable to start the jobs, running serially");
+        return;
+    }
+    jobs->pids = (int*)fct_calloc((size_t)num, sizeof(int));
+    FCT_ASSERT( jobs->pids != NULL );
+    /* Anything still buffered would be written out again by each worker. */
+    (void)fflush(NULL);
+    for ( worker_i =0; worker_i != num; ++worker_i )
+    {
+        pid_t pid = fork();
+        if ( pid == 0 )
+        {
+            fct_logger_i *stream =NULL;
+            (void)close(fds[0]);
+            jobs->fd = fds[1];
+            jobs->num = num;
+            jobs->worker_id = worker_i;
+            fct_free(jobs->pids);
+            jobs->pids = NULL;
+            fct_nlist__clear(&(nk->logger_list),
+                             (fct_nlist_on_del_t)fct_logger__del);
+            stream = fct_stream_logger_new(jobs);
+            FCT_ASSERT( stream != NULL );
+            fct_nlist__append(&(nk->logger_list), (void*)stream);
+            jobs->is_isolate = is_isolate;
+            if ( is_isolate )
+            {
+                fct_jobs__zygote(jobs);
+            }
+            else
+            {
+                fct_jobs__claim(jobs);
+            }
+            return;
+        }
+        if ( pid < 0 )
+        {
+            break;
+        }
+        jobs->pids[worker_i] = (int)pid;
+    }
+    (void)close(fds[1]);
+    if ( worker_i == 0 )
+    {
+        (void)close(fds[0]);
+        fct_free(jobs->pids);
+        jobs->pids = NULL;
+        (void)munmap((void*)jobs->shm, sizeof(fct_jobs_shm_t));
+        jobs->shm = NULL;
+        fctkern__log_warn(nk, "unable to start the jobs, running serially");
+        return;
+    }
+    jobs->fd = fds[0];
+    jobs->num = worker_i;
+    if ( worker_i < num )
+    {
+        fctkern__log_warn(nk, "unable to start all the jobs");
+    }
+#else
+    fct_unused(is_isolate);
+    fctkern__log_warn(nk, "--jobs is not supported here, running serially");
+#endif /* FCT_JOBS */
+}
 
 
+/* Numbers the selected tests of the suite. A worker keeps only the test
+it has claimed, the parent replays the results of all of them and keeps
+none. */
 static void
-fct_minimal_logger__on_chk(
-    fct_logger_i *self_,
-    fct_logger_evt_t const *e
-)
+fctkern__jobs_select(fctkern_t *nk, fct_ts_t *ts)
 {
-    fct_minimal_logger_t *self = (fct_minimal_logger_t*)self_;
-    if ( fctchk__is_pass(e->chk) )
+    fct_jobs_t *jobs = &(nk->jobs);
+    int entry_i =0;
+    jobs->seq_bgn = jobs->seq_next;
+    for ( entry_i =0; entry_i != ts->entry_num; ++entry_i )
     {
-        fputs(".", stdout);
+        fct_ts_entry_t *entry = &(ts->entries[entry_i]);
+        entry->seq = (entry->is_selected) ? jobs->seq_next++ : -1;
     }
-    else
+    jobs->seq_end = jobs->seq_next;
+    jobs->num_streamed = 0;
+    for ( entry_i =0; entry_i != ts->entry_num; ++entry_i )
     {
-        fputs("x", stdout);
-        fct_logger_record_failure(e->chk, &(self->failed_cndtns_list));
-
+        fct_ts_entry_t *entry = &(ts->entries[entry_i]);
+#if defined(FCT_JOBS)
+        if ( jobs->worker_id < 0 && entry->is_selected )
+        {
+            fctkern__jobs_replay(nk, ts, entry);
+        }
+#endif /* FCT_JOBS */
+        entry->is_selected = (jobs->worker_id >= 0
+                              && entry->seq >= 0
+                              && entry->seq == jobs->claim);
     }
 }
 
+
+/* Called once a test has been torn down. */
 static void
-fct_minimal_logger__on_fctx_end(
-    fct_logger_i *self_,
-    fct_logger_evt_t const *e
-)
+fctkern__jobs_test_end(fctkern_t *nk, fct_ts_t *ts)
 {
-    fct_minimal_logger_t *self = (fct_minimal_logger_t*)self_;
-    fct_unused(e);
-    if ( fct_nlist__size(&(self->failed_cndtns_list)) >0 )
+    if ( nk == NULL || nk->jobs.worker_id < 0 )
     {
-        fct_logger_print_failures(&(self->failed_cndtns_list));
+        return;
     }
+#if defined(FCT_JOBS)
+    fctkern__jobs_next(nk, ts);
+#else
+    fct_unused(ts);
+#endif /* FCT_JOBS */
 }
 
 
+/* Called as the suite ends. Claims that fall inside an aborted suite
+are given up, a serial run would never get to them either. */
 static void
-fct_minimal_logger__on_delete(
-    fct_logger_i *self_,
-    fct_logger_evt_t const *e
-)
+fctkern__jobs_suite_end(fctkern_t *nk, fct_ts_t *ts)
 {
-    fct_minimal_logger_t *self = (fct_minimal_logger_t*)self_;
-    fct_unused(e);
-    fct_nlist__final(&(self->failed_cndtns_list), free);
-    free(self);
-
+    if ( nk == NULL || nk->jobs.worker_id < 0 )
+    {
+        return;
+    }
+#if defined(FCT_JOBS)
+    fctkern__jobs_stream_aborts(nk, ts);
+    while ( nk->jobs.claim >= nk->jobs.seq_bgn
+            && nk->jobs.claim < nk->jobs.seq_end )
+    {
+        fctkern__jobs_next(nk, ts);
+    }
+#else
+    fct_unused(ts);
+#endif /* FCT_JOBS */
 }
 
 
-fct_logger_i*
-fct_minimal_logger_new(void)
+/* A worker leaves here and never comes back. The parent waits for all
+the workers to finish. */
+static void
+fctkern__jobs_end(fctkern_t *nk)
 {
-    fct_minimal_logger_t *self = (fct_minimal_logger_t*)\
-                                 calloc(1,sizeof(fct_minimal_logger_t));
-    if ( self == NULL )
+#if defined(FCT_JOBS)
+    fct_jobs_t *jobs = &(nk->jobs);
+    if ( jobs->num == 0 )
     {
-        return NULL;
+        return;
     }
-    fct_logger__init((fct_logger_i*)self);
-    self->vtable.on_chk = fct_minimal_logger__on_chk;
-    self->vtable.on_fctx_end = fct_minimal_logger__on_fctx_end;
-    self->vtable.on_delete = fct_minimal_logger__on_delete;
-    fct_nlist__init2(&(self->failed_cndtns_list), 0);
-    return (fct_logger_i*)self;
+    if ( jobs->worker_id >= 0 )
+    {
+        /* Our claim is past the last test, nobody needs to claim more. */
+        jobs->shm->is_drained = 1;
+        if ( !jobs->is_isolate )
+        {
+            jobs->shm->claims[jobs->worker_id] = -1;
+        }
+        (void)close(jobs->fd);
+        (void)fflush(NULL);
+        _exit(EXIT_SUCCESS);
+    }
+    while ( jobs->fd >= 0 )
+    {
+        fct_jobs__pump(jobs);
+    }
+    fct_nlist__clear(&(jobs->recs), (fct_nlist_on_del_t)fct_free_fn);
+    fct_free(jobs->pids);
+    jobs->pids = NULL;
+    (void)munmap((void*)jobs->shm, sizeof(fct_jobs_shm_t));
+    jobs->shm = NULL;
+    jobs->num = 0;
+#else
+    fct_unused(nk);
+#endif /* FCT_JOBS */
 }
 
 
 /*
 -----------------------------------------------------------
-STANDARD LOGGER
+THREADED SUITES
 -----------------------------------------------------------
-*/
-
-struct _fct_standard_logger_t
-{
-    _fct_logger_head;
 
-    /* Start time. For now we use the low-accuracy time_t version. */
-    fct_timer_t timer;
+When built with FCT_CONF_THREADS and run with --threads N, each
+FCTMF_SUITE_CALL hands its suite to a pool of N threads instead of
+running it there and then. Every suite gets a kernel of its own, a
+copy of ours that shares the command line and filters, but has its
+own namespace, its own list of suites, and a "buffer" logger that
+keeps the events for later. The check context (fct_xchk_*) is thread
+local. Before the next suite that is not called this way, and at
+FCT_END, we wait for the pool to finish. Then the buffered events of
+each suite are replayed into our loggers in the order the suites where
+called, and their results added to our list of suites. So the report
+is the same as a serial run, while a run of FCTMF_SUITE_CALLs goes in
+parallel.
+
+The suites need to be independent of each other, and of anything done
+in between the calls.
+*/
 
-    /* A list of char*'s that needs to be cleaned up. */
-    fct_nlist_t failed_cndtns_list;
+#if defined(FCT_THREADS)
+enum
+{
+    FCT_BUFFER_EVT_CHK =1,
+    FCT_BUFFER_EVT_TEST_START,
+    FCT_BUFFER_EVT_TEST_END,
+    FCT_BUFFER_EVT_TEST_SUITE_START,
+    FCT_BUFFER_EVT_TEST_SUITE_END,
+    FCT_BUFFER_EVT_TEST_SUITE_SKIP,
+    FCT_BUFFER_EVT_TEST_SKIP,
+    FCT_BUFFER_EVT_WARN
 };
 
-
-#define FCT_STANDARD_LOGGER_MAX_LINE 68
+/* A logged event. The checks, tests and suites are kept alive by the
+suite's kernel, so only the strings need to be copied. */
+typedef struct _fct_buffer_evt_t
+{
+    int type;
+    fctchk_t const *chk;
+    /* A passed check is not kept by its test, so we keep a copy, and
+    count how many times in a row it was made. */
+    fctchk_t *pass;
+    size_t num_pass;
+    fct_test_t *test;
+    fct_ts_t const *ts;
+    char *str0;
+    char *str1;
+} fct_buffer_evt_t;
 
 
-/* When a failure occurs, we will record the details so we can display
-them when the log "finishes" up. */
 static void
-fct_standard_logger__on_chk(
-    fct_logger_i *logger_,
-    fct_logger_evt_t const *e
-)
+fct_buffer_evt__del(fct_buffer_evt_t *evt)
 {
-    fct_standard_logger_t *logger = (fct_standard_logger_t*)logger_;
-    /* Only record failures. */
-    if ( !fctchk__is_pass(e->chk) )
+    if ( evt == NULL )
     {
-        fct_logger_record_failure(e->chk, &(logger->failed_cndtns_list));
+        return;
     }
+    fct_free(evt->str0);
+    fct_free(evt->str1);
+    fct_free(evt->pass);
+    fct_free(evt);
 }
 
 
-static void
-fct_standard_logger__on_test_skip(
-    fct_logger_i* logger_,
-    fct_logger_evt_t const *e
-)
+/* Keeps the events, in order, to be replayed later. */
+typedef struct _fct_buffer_logger_t
 {
-    char const *condition = e->cndtn;
-    char const *name = e->name;
-    char msg[256] = {'\0'};
-    fct_unused(logger_);
-    fct_unused(condition);
-    fct_snprintf(msg, sizeof(msg), "%s (%s)", name, condition);
-    msg[sizeof(msg)-1] = '\0';
-    fct_dotted_line_start(FCT_STANDARD_LOGGER_MAX_LINE, msg);
-    fct_dotted_line_end("- SKIP -");
-}
+    _fct_logger_head;
+    fct_nlist_t evts;
+} fct_buffer_logger_t;
 
 
 static void
-fct_standard_logger__on_test_start(
-    fct_logger_i *logger_,
-    fct_logger_evt_t const *e
-)
-{
-    fct_unused(logger_);
-    fct_dotted_line_start(
-        FCT_STANDARD_LOGGER_MAX_LINE,
-        fct_test__name(e->test)
-    );
+fct_buffer_logger__add(fct_logger_i *self_,
+                       int type,
+                       fct_logger_evt_t const *e,
+                       char const *str0,
+                       char const *str1)
+{
+    fct_buffer_logger_t *self = (fct_buffer_logger_t*)self_;
+    fct_buffer_evt_t *evt =
+        (fct_buffer_evt_t*)fct_calloc(1, sizeof(fct_buffer_evt_t));
+    FCT_ASSERT( evt != NULL );
+    evt->type = type;
+    evt->chk = e->chk;
+    evt->test = (fct_test_t*)e->test;
+    evt->ts = e->ts;
+    evt->str0 = (str0 == NULL) ? NULL : fctstr_clone(str0);
+    evt->str1 = (str1 == NULL) ? NULL : fctstr_clone(str1);
+    fct_nlist__append(&(self->evts), evt);
 }
 
 
-static void
-fct_standard_logger__on_test_end(
-    fct_logger_i *logger_,
-    fct_logger_evt_t const *e
-)
+#if !defined(FCT_CONF_KEEP_PASSED_CHKS)
+/* Returns true if the two checks say the same thing, from the same
+place. */
+static nbool_t
+fctchk__is_same(fctchk_t const *a, fctchk_t const *b)
 {
-    nbool_t is_pass;
-    fct_unused(logger_);
-    is_pass = fct_test__is_pass(e->test);
-    fct_dotted_line_end((is_pass) ? "PASS" : "FAIL ***" );
+    return a->is_pass == b->is_pass
+           && a->lineno == b->lineno
+           && fctstr_eq(a->file, b->file)
+           && fctstr_eq(a->cndtn, b->cndtn)
+           && fctstr_eq(a->msg, b->msg);
 }
+#endif /* FCT_CONF_KEEP_PASSED_CHKS */
 
 
 static void
-fct_standard_logger__on_fctx_start(
-    fct_logger_i *logger_,
-    fct_logger_evt_t const *e
-)
+fct_buffer_logger__on_chk(fct_logger_i *self_, fct_logger_evt_t const *e)
 {
-    fct_standard_logger_t *logger = (fct_standard_logger_t*)logger_;
-    fct_unused(e);
-    fct_timer__start(&(logger->timer));
+#if !defined(FCT_CONF_KEEP_PASSED_CHKS)
+    fct_buffer_logger_t *self = (fct_buffer_logger_t*)self_;
+    if ( fctchk__is_pass(e->chk) )
+    {
+        size_t num_evts = fct_nlist__size(&(self->evts));
+        fct_buffer_evt_t *last = (num_evts == 0) ? NULL :
+                                 (fct_buffer_evt_t*)fct_nlist__at(
+                                     &(self->evts), num_evts-1
+                                 );
+        if ( last != NULL
+                && last->pass != NULL
+                && fctchk__is_same(last->pass, e->chk) )
+        {
+            ++(last->num_pass);
+            return;
+        }
+        fct_buffer_logger__add(self_, FCT_BUFFER_EVT_CHK, e, NULL, NULL);
+        last = (fct_buffer_evt_t*)fct_nlist__at(&(self->evts), num_evts);
+        last->pass = fctchk_clone(e->chk);
+        FCT_ASSERT( last->pass != NULL );
+        last->chk = last->pass;
+        last->num_pass = 1;
+        return;
+    }
+#endif /* FCT_CONF_KEEP_PASSED_CHKS */
+    fct_buffer_logger__add(self_, FCT_BUFFER_EVT_CHK, e, NULL, NULL);
 }
 
 
 static void
-fct_standard_logger__on_fctx_end(
-    fct_logger_i *logger_,
-    fct_logger_evt_t const *e
-)
+fct_buffer_logger__on_test_start(fct_logger_i *self_,
+                                 fct_logger_evt_t const *e)
 {
-    fct_standard_logger_t *logger = (fct_standard_logger_t*)logger_;
-    nbool_t is_success =1;
-    double elasped_time =0;
-    size_t num_tests =0;
-    size_t num_passed =0;
-
-    fct_timer__stop(&(logger->timer));
+    fct_buffer_logger__add(self_, FCT_BUFFER_EVT_TEST_START, e, NULL, NULL);
+}
 
-    is_success = fct_nlist__size(&(logger->failed_cndtns_list)) ==0;
 
-    if (  !is_success )
-    {
-        fct_logger_print_failures(&(logger->failed_cndtns_list));
-    }
-    puts(
-        "\n----------------------------------------------------------------------------\n"
-    );
-    num_tests = fctkern__tst_cnt(e->kern);
-    num_passed = fctkern__tst_cnt_passed(e->kern);
-    printf(
-        "%s (%lu/%lu tests",
-        (is_success) ? "PASSED" : "FAILED",
-        (unsigned long) num_passed,
-        (unsigned long) num_tests
-    );
-    elasped_time = fct_timer__duration(&(logger->timer));
-    if ( elasped_time > 0.0000001 )
-    {
-        printf(" in %.6fs)\n", elasped_time);
-    }
-    else
-    {
-        /* Don't bother displaying the time to execute. */
-        puts(")\n");
-    }
+static void
+fct_buffer_logger__on_test_end(fct_logger_i *self_, fct_logger_evt_t const *e)
+{
+    fct_buffer_logger__add(self_, FCT_BUFFER_EVT_TEST_END, e, NULL, NULL);
 }
 
 
 static void
-fct_standard_logger__on_delete(
-    fct_logger_i *logger_,
-    fct_logger_evt_t const *e
-)
+fct_buffer_logger__on_test_suite_start(fct_logger_i *self_,
+                                       fct_logger_evt_t const *e)
 {
-    fct_standard_logger_t *logger = (fct_standard_logger_t*)logger_;
-    fct_unused(e);
-    fct_nlist__final(&(logger->failed_cndtns_list), free);
-    free(logger);
-    logger_ =NULL;
+    fct_buffer_logger__add(self_, FCT_BUFFER_EVT_TEST_SUITE_START, e,
+                           NULL, NULL);
 }
 
 
 static void
-fct_standard_logger__on_warn(
-    fct_logger_i* logger_,
-    fct_logger_evt_t const *e
-)
+fct_buffer_logger__on_test_suite_end(fct_logger_i *self_,
+                                     fct_logger_evt_t const *e)
 {
-    fct_unused(logger_);
-    (void)printf("WARNING: %s", e->msg);
+    fct_buffer_logger__add(self_, FCT_BUFFER_EVT_TEST_SUITE_END, e,
+                           NULL, NULL);
 }
 
 
-fct_logger_i*
-fct_standard_logger_new(void)
-{
-    fct_standard_logger_t *logger = (fct_standard_logger_t *)calloc(
-                                        1, sizeof(fct_standard_logger_t)
-                                    );
-    if ( logger == NULL )
-    {
-        return NULL;
-    }
-    fct_logger__init((fct_logger_i*)logger);
-    logger->vtable.on_chk = fct_standard_logger__on_chk;
-    logger->vtable.on_test_start = fct_standard_logger__on_test_start;
-    logger->vtable.on_test_end = fct_standard_logger__on_test_end;
-    logger->vtable.on_fctx_start = fct_standard_logger__on_fctx_start;
-    logger->vtable.on_fctx_end = fct_standard_logger__on_fctx_end;
-    logger->vtable.on_delete = fct_standard_logger__on_delete;
-    logger->vtable.on_warn = fct_standard_logger__on_warn;
-    logger->vtable.on_test_skip = fct_standard_logger__on_test_skip;
-    fct_nlist__init2(&(logger->failed_cndtns_list), 0);
-    fct_timer__init(&(logger->timer));
-    return (fct_logger_i*)logger;
+static void
+fct_buffer_logger__on_test_suite_skip(fct_logger_i *self_,
+                                      fct_logger_evt_t const *e)
+{
+    fct_buffer_logger__add(self_, FCT_BUFFER_EVT_TEST_SUITE_SKIP, e,
+                           e->cndtn, e->name);
 }
 
 
-/*
------------------------------------------------------------
-JUNIT LOGGER
------------------------------------------------------------
-*/
+static void
+fct_buffer_logger__on_test_skip(fct_logger_i *self_,
+                                fct_logger_evt_t const *e)
+{
+    fct_buffer_logger__add(self_, FCT_BUFFER_EVT_TEST_SKIP, e,
+                           e->cndtn, e->name);
+}
 
 
-/* JUnit logger */
-struct _fct_junit_logger_t
+static void
+fct_buffer_logger__on_warn(fct_logger_i *self_, fct_logger_evt_t const *e)
 {
-    _fct_logger_head;
-};
+    fct_buffer_logger__add(self_, FCT_BUFFER_EVT_WARN, e, e->msg, NULL);
+}
 
 
 static void
-fct_junit_logger__on_test_suite_start(
-    fct_logger_i *l,
-    fct_logger_evt_t const *e
-)
+fct_buffer_logger__on_delete(fct_logger_i *self_, fct_logger_evt_t const *e)
 {
-    fct_unused(l);
+    fct_buffer_logger_t *self = (fct_buffer_logger_t*)self_;
     fct_unused(e);
-    FCT_SWITCH_STDOUT_TO_BUFFER();
-    FCT_SWITCH_STDERR_TO_BUFFER();
+    fct_nlist__final(&(self->evts), (fct_nlist_on_del_t)fct_buffer_evt__del);
+    fct_free(self);
 }
 
 
-static void
-fct_junit_logger__on_test_suite_end(
-    fct_logger_i *logger_,
-    fct_logger_evt_t const *e
-)
+static fct_buffer_logger_t *
+fct_buffer_logger_new(void)
 {
-    fct_ts_t const *ts = e->ts; /* Test Suite */
-    nbool_t is_pass;
-    double elasped_time = 0;
-    char std_buffer[1024];
-    int read_length;
-    int first_out_line;
+    fct_buffer_logger_t *self =
+        (fct_buffer_logger_t*)fct_calloc(1, sizeof(fct_buffer_logger_t));
+    if ( self == NULL )
+    {
+        return NULL;
+    }
+    fct_logger__init((fct_logger_i*)self);
+    self->vtable.on_chk = fct_buffer_logger__on_chk;
+    self->vtable.on_test_start = fct_buffer_logger__on_test_start;
+    self->vtable.on_test_end = fct_buffer_logger__on_test_end;
+    self->vtable.on_test_suite_start = fct_buffer_logger__on_test_suite_start;
+    self->vtable.on_test_suite_end = fct_buffer_logger__on_test_suite_end;
+    self->vtable.on_test_suite_skip = fct_buffer_logger__on_test_suite_skip;
+    self->vtable.on_test_skip = fct_buffer_logger__on_test_skip;
+    self->vtable.on_warn = fct_buffer_logger__on_warn;
+    self->vtable.on_delete = fct_buffer_logger__on_delete;
+    fct_nlist__init2(&(self->evts), 0);
+    return self;
+}
 
-    fct_unused(logger_);
 
-    elasped_time = fct_ts__duration(ts);
+/* A suite handed to the pool. */
+struct _fct_task_t
+{
+    fctmf_suite_fn fn;
+    /* The suite's own kernel, see fct_task_new. */
+    fctkern_t kern;
+    fct_buffer_logger_t *buffer;
+};
 
-    FCT_SWITCH_STDOUT_TO_STDOUT();
-    FCT_SWITCH_STDERR_TO_STDERR();
 
-    /* opening testsuite tag */
-    printf("\t<testsuite errors=\"%lu\" failures=\"0\" tests=\"%lu\" "
-           "name=\"%s\" time=\"%.4f\">\n",
-           (unsigned long)   fct_ts__tst_cnt(ts)
-           - fct_ts__tst_cnt_passed(ts),
-           (unsigned long) fct_ts__tst_cnt(ts),
-           fct_ts__name(ts),
-           elasped_time);
+/* Builds a task for FN, its kernel is a copy of NK that shares the
+command line, filters and logger types, and nothing else. */
+static fct_task_t *
+fct_task_new(fctkern_t const *nk, fctmf_suite_fn fn)
+{
+    fct_task_t *task = (fct_task_t*)fct_calloc(1, sizeof(fct_task_t));
+    fctkern_t *kern =NULL;
+    FCT_ASSERT( task != NULL );
+    task->fn = fn;
+    kern = &(task->kern);
+    memcpy(kern, nk, sizeof(fctkern_t));
+    fct_namespace_init(&(kern->ns));
+    fct_nlist__init2(&(kern->logger_list), 0);
+    fct_nlist__init2(&(kern->ts_list), 0);
+    /* The suites are only counted, freed and timed once they are handed
+    to NK. */
+    kern->is_stream = FCT_FALSE;
+    kern->num_tests = 0;
+    kern->num_tests_passed = 0;
+    kern->num_chks = 0;
+    kern->timings_file = NULL;
+    kern->bench_file = NULL;
+    kern->num_expected_failures = 0;
+    memset(&(kern->jobs), 0, sizeof(fct_jobs_t));
+    kern->jobs.is_started = FCT_TRUE;
+    kern->jobs.worker_id = -1;
+    kern->jobs.fd = -1;
+    fct_nlist__init2(&(kern->jobs.recs), 0);
+    memset(&(kern->threads), 0, sizeof(fct_threads_t));
+    kern->threads.is_started = FCT_TRUE;
+    fct_nlist__init2(&(kern->threads.tasks), 0);
+    task->buffer = fct_buffer_logger_new();
+    FCT_ASSERT( task->buffer != NULL );
+    fct_nlist__append(&(kern->logger_list), (void*)task->buffer);
+    return task;
+}
 
-    FCT_NLIST_FOREACH_BGN(fct_test_t*, test, &(ts->test_list))
-    {
-        is_pass = fct_test__is_pass(test);
 
-        /* opening testcase tag */
-        if (is_pass)
-        {
-            printf("\t\t<testcase name=\"%s\" time=\"%.3f\"",
-                   fct_test__name(test),
-                   fct_test__duration(test)
-                  );
-        }
-        else
+/* Replays the task's events into NK's loggers, and hands its suites to
+NK. Then cleans up the task. */
+static void
+fct_task__merge(fct_task_t *task, fctkern_t *nk)
+{
+    FCT_NLIST_FOREACH_BGN(fct_buffer_evt_t*, evt, &(task->buffer->evts))
+    {
+        switch ( evt->type )
         {
-            printf("\t\t<testcase name=\"%s\" time=\"%.3f\">\n",
-                   fct_test__name(test),
-                   fct_test__duration(test)
-                  );
+        case FCT_BUFFER_EVT_CHK:
+            if ( evt->pass != NULL )
+            {
+                size_t pass_i =0;
+                for ( pass_i =0; pass_i != evt->num_pass; ++pass_i )
+                {
+                    fctkern__log_chk(nk, evt->pass);
+                }
+            }
+            else
+            {
+                fctkern__log_chk(nk, evt->chk);
+            }
+            break;
+        case FCT_BUFFER_EVT_TEST_START:
+            fctkern__log_test_start(nk, evt->test);
+            break;
+        case FCT_BUFFER_EVT_TEST_END:
+            fctkern__log_test_end(nk, evt->test);
+            break;
+        case FCT_BUFFER_EVT_TEST_SUITE_START:
+            fctkern__log_suite_start(nk, evt->ts);
+            break;
+        case FCT_BUFFER_EVT_TEST_SUITE_END:
+            fctkern__log_suite_end(nk, evt->ts);
+            break;
+        case FCT_BUFFER_EVT_TEST_SUITE_SKIP:
+            fctkern__log_suite_skip(nk, evt->str0, evt->str1);
+            break;
+        case FCT_BUFFER_EVT_TEST_SKIP:
+            fctkern__log_test_skip(nk, evt->str0, evt->str1);
+            break;
+        case FCT_BUFFER_EVT_WARN:
+            fctkern__log_warn(nk, evt->str0);
+            break;
+        default:
+            break;
         }
+    }
+    FCT_NLIST_FOREACH_END();
+    FCT_NLIST_FOREACH_BGN(fct_ts_t*, ts, &(task->kern.ts_list))
+    {
+        fctkern__add_ts(nk, ts);
+    }
+    FCT_NLIST_FOREACH_END();
+    fct_nlist__final(&(task->kern.ts_list), NULL);
+    fct_nlist__final(&(task->kern.logger_list),
+                     (fct_nlist_on_del_t)fct_logger__del);
+    fct_nlist__final(&(task->kern.jobs.recs), NULL);
+    fct_nlist__final(&(task->kern.threads.tasks), NULL);
+    fct_free(task);
+}
 
-        FCT_NLIST_FOREACH_BGN(fctchk_t*, chk, &(test->failed_chks))
+
+/* What each thread of the pool runs, until the pool is closing and no
+tasks are left. */
+static void *
+fct_threads__main(void *nk_)
+{
+    fct_threads_t *threads = &(((fctkern_t*)nk_)->threads);
+    for (;;)
+    {
+        fct_task_t *task =NULL;
+        pthread_mutex_lock(&(threads->lock));
+        while ( threads->next_task == fct_nlist__size(&(threads->tasks))
+                && !threads->is_closing )
         {
-            /* error tag */
-            printf("\t\t\t<error message=\"%s\" "
-                   "type=\"fctx\">", chk->msg);
-            printf("file:%s, line:%d", chk->file, chk->lineno);
-            printf("</error>\n");
+            pthread_cond_wait(&(threads->cond), &(threads->lock));
         }
-        FCT_NLIST_FOREACH_END();
-
-        /* closing testcase tag */
-        if (is_pass)
+        if ( threads->next_task < fct_nlist__size(&(threads->tasks)) )
         {
-            printf(" />\n");
+            task = (fct_task_t*)fct_nlist__at(&(threads->tasks),
+                                              threads->next_task);
+            ++(threads->next_task);
         }
-        else
+        pthread_mutex_unlock(&(threads->lock));
+        if ( task == NULL )
         {
-            printf("\t\t</testcase>\n");
+            break;
         }
+        task->fn(&(task->kern));
+        pthread_mutex_lock(&(threads->lock));
+        ++(threads->num_done);
+        pthread_cond_broadcast(&(threads->cond));
+        pthread_mutex_unlock(&(threads->lock));
     }
-    FCT_NLIST_FOREACH_END();
+#if defined(FCT_PERF)
+    fct_perf__close();
+#endif /* FCT_PERF */
+    return NULL;
+}
 
-    /* print the std streams */
-    first_out_line = 1;
-    printf("\t\t<system-out>\n\t\t\t<![CDATA[");
-    while ( (read_length = _fct_read(fct_stdout_pipe[0], std_buffer, 1024)) > 0)
+
+/* Starts the pool the first time it is called, if we where asked to
+with --threads. Returns FCT_TRUE if there is a pool to hand suites to. */
+static nbool_t
+fctkern__threads_start(fctkern_t *nk)
+{
+    fct_threads_t *threads = &(nk->threads);
+    int num =0;
+    int thread_i =0;
+    if ( threads->is_started )
     {
-        if (first_out_line)
-        {
-            printf("\n");
-            first_out_line = 0;
-        }
-        printf("%.*s", read_length, std_buffer);
+        return threads->num > 0;
     }
-    printf("]]>\n\t\t</system-out>\n");
-
-    first_out_line = 1;
-    printf("\t\t<system-err>\n\t\t\t<![CDATA[");
-    while ((read_length = _fct_read(fct_stderr_pipe[0], std_buffer, 1024)) > 0)
+    threads->is_started = FCT_TRUE;
+    num = atoi(fctkern__cl_val2(nk, FCT_OPT_THREADS, "0"));
+    /* Forking with threads running is asking for trouble. */
+    if ( num <= 1 || nk->jobs.num > 0 )
     {
-        if (first_out_line)
+        return FCT_FALSE;
+    }
+    threads->pool = (pthread_t*)fct_calloc((size_t)num, sizeof(pthread_t));
+    FCT_ASSERT( threads->pool != NULL );
+    pthread_mutex_init(&(threads->lock), NULL);
+    pthread_cond_init(&(threads->cond), NULL);
+    for ( thread_i =0; thread_i != num; ++thread_i )
+    {
+        if ( pthread_create(&(threads->pool[thread_i]),
+                            NULL,
+                            fct_threads__main,
+                            (void*)nk) != 0 )
         {
-            printf("\n");
-            first_out_line = 0;
+            fctkern__log_warn(nk, "unable to start all the threads");
+            break;
         }
-        printf("%.*s", read_length, std_buffer);
     }
-    printf("]]>\n\t\t</system-err>\n");
-
-    /* closing testsuite tag */
-    printf("\t</testsuite>\n");
+    threads->num = thread_i;
+#if defined(FCT_RUSAGE) && !defined(RUSAGE_THREAD) && !defined(__linux__)
+    if ( threads->num > 0 && nk->is_rusage )
+    {
+        fctkern__log_warn(nk, "no per thread usage, "
+                          "--rusage counts the whole process");
+    }
+#endif /* FCT_RUSAGE && !RUSAGE_THREAD && !__linux__ */
+    if ( threads->num == 0 )
+    {
+        pthread_cond_destroy(&(threads->cond));
+        pthread_mutex_destroy(&(threads->lock));
+        fct_free(threads->pool);
+        threads->pool = NULL;
+    }
+    return threads->num > 0;
 }
+#endif /* FCT_THREADS */
 
-static void
-fct_junit_logger__on_fct_start(
-    fct_logger_i *logger_,
-    fct_logger_evt_t const *e
-)
-{
-    fct_unused(logger_);
-    fct_unused(e);
-    printf("<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n");
-    printf("<testsuites>\n");
-}
 
+/* Runs the FCTMF suite FN, or hands it to the pool when running with
+--threads. */
 static void
-fct_junit_logger__on_fctx_end(
-    fct_logger_i *logger_,
-    fct_logger_evt_t const *e
-)
+fctkern__call_mf(fctkern_t *nk, char const *name, fctmf_suite_fn fn)
 {
-    fct_unused(logger_);
-    fct_unused(e);
-    printf("</testsuites>\n");
+    fct_unused(name);
+    /* Any workers are forked before a thread is started. */
+    fctkern__jobs_start(nk);
+#if defined(FCT_THREADS)
+    if ( fctkern__threads_start(nk) )
+    {
+        fct_task_t *task =NULL;
+        /* The copy of our kernel is taken under the lock, the pool
+        writes to its part of it. */
+        pthread_mutex_lock(&(nk->threads.lock));
+        task = fct_task_new(nk, fn);
+        fct_nlist__append(&(nk->threads.tasks), (void*)task);
+        pthread_cond_broadcast(&(nk->threads.cond));
+        pthread_mutex_unlock(&(nk->threads.lock));
+        return;
+    }
+#endif /* FCT_THREADS */
+    fn(nk);
 }
 
+
+/* Waits for the pool to run all the suites handed to it so far, and
+merges their results in the order the suites where called. */
 static void
-fct_junit_logger__on_delete(
-    fct_logger_i *logger_,
-    fct_logger_evt_t const *e
-)
+fctkern__threads_sync(fctkern_t *nk)
 {
-    fct_junit_logger_t *logger = (fct_junit_logger_t*)logger_;
-    fct_unused(e);
-    free(logger);
-    logger_ =NULL;
+#if defined(FCT_THREADS)
+    fct_threads_t *threads = &(nk->threads);
+    if ( threads->num == 0 )
+    {
+        return;
+    }
+    pthread_mutex_lock(&(threads->lock));
+    while ( threads->num_done != fct_nlist__size(&(threads->tasks)) )
+    {
+        pthread_cond_wait(&(threads->cond), &(threads->lock));
+    }
+    FCT_NLIST_FOREACH_BGN(fct_task_t*, task, &(threads->tasks))
+    {
+        fct_task__merge(task, nk);
+    }
+    FCT_NLIST_FOREACH_END();
+    fct_nlist__clear(&(threads->tasks), NULL);
+    threads->next_task = 0;
+    threads->num_done = 0;
+    pthread_mutex_unlock(&(threads->lock));
+#else
+    fct_unused(nk);
+#endif /* FCT_THREADS */
 }
 
 
-fct_junit_logger_t *
-fct_junit_logger_new(void)
+/* Merges what is left, and stops the pool. */
+static void
+fctkern__threads_end(fctkern_t *nk)
 {
-    fct_junit_logger_t *logger =
-        (fct_junit_logger_t *)calloc(1, sizeof(fct_junit_logger_t));
-    if ( logger == NULL )
+#if defined(FCT_THREADS)
+    fct_threads_t *threads = &(nk->threads);
+    int thread_i =0;
+    if ( threads->num == 0 )
     {
-        return NULL;
+        return;
     }
-    fct_logger__init((fct_logger_i*)logger);
-    logger->vtable.on_test_suite_start = fct_junit_logger__on_test_suite_start;
-    logger->vtable.on_test_suite_end = fct_junit_logger__on_test_suite_end;
-    logger->vtable.on_fctx_start = fct_junit_logger__on_fct_start;
-    logger->vtable.on_fctx_end = fct_junit_logger__on_fctx_end;
-    logger->vtable.on_delete = fct_junit_logger__on_delete;
-    return logger;
+    fctkern__threads_sync(nk);
+    pthread_mutex_lock(&(threads->lock));
+    threads->is_closing = FCT_TRUE;
+    pthread_cond_broadcast(&(threads->cond));
+    pthread_mutex_unlock(&(threads->lock));
+    for ( thread_i =0; thread_i != threads->num; ++thread_i )
+    {
+        pthread_join(threads->pool[thread_i], NULL);
+    }
+    pthread_cond_destroy(&(threads->cond));
+    pthread_mutex_destroy(&(threads->lock));
+    fct_free(threads->pool);
+    threads->pool = NULL;
+    threads->num = 0;
+#else
+    fct_unused(nk);
+#endif /* FCT_THREADS */
 }
 
 
@@ -3211,18 +8678,48 @@ they are needed, but at runtime, only the cheap, first call is made. */
             (void)fct_ts__test_begin(NULL);\
             (void)fct_ts__add_test(NULL, NULL);\
             (void)fct_ts__test_end(NULL);\
+            (void)fct_ts__setup_bgn(NULL);\
+            (void)fct_ts__teardown_stop(NULL);\
             (void)fct_ts__inc_total_test_num(NULL);\
             (void)fct_ts__make_abort_test(NULL);\
+            (void)fct_ts__new_test(NULL, NULL);\
             (void)fct_ts__setup_abort(NULL);\
             (void)fct_ts__setup_end(NULL);\
+            (void)fct_ts__add_entry(NULL, NULL, 0);\
+            (void)fct_ts__dispatch(NULL, NULL);\
             (void)fct_ts__teardown_end(NULL);\
             (void)fct_ts__cnt_end(NULL);\
             (void)fct_ts__is_test_cnt(NULL, 0);\
+            (void)fct_ts__is_in_place(NULL, 0, 0);\
+            fct_ts__walk_end(NULL);\
             (void)fct_xchk_fn(0, "");\
             (void)fct_xchk2_fn(NULL, 0, "");\
             (void)fctkern__cl_parse(NULL);\
             (void)fctkern__add_ts(NULL, NULL);\
             (void)fctkern__pass_filter(NULL, NULL);\
+            (void)fctkern__pass_suite_filter(NULL, NULL);\
+            (void)fctkern__registry_prime(NULL, NULL, NULL);\
+            (void)fctkern__select_tests(NULL, NULL);\
+            (void)fctkern__registry_call_mf(NULL);\
+            (void)fctkern__jobs_start(NULL);\
+            (void)fctkern__jobs_test_end(NULL, NULL);\
+            (void)fctkern__jobs_suite_end(NULL, NULL);\
+            (void)fctkern__jobs_end(NULL);\
+            (void)fctkern__call_mf(NULL, NULL, NULL);\
+            (void)fctkern__threads_sync(NULL);\
+            (void)fctkern__merge_chk_bufs(NULL, NULL);\
+            (void)fctkern__end(NULL);\
+            (void)fct_bench__init(NULL, NULL, NULL);\
+            (void)fct_bench__next(NULL);\
+            (void)fct_bench__end(NULL);\
+            (void)fct_bench__chk_baseline(NULL);\
+            fct_perf__to_str(NULL, NULL, 0);\
+            fct_perf__from_str(NULL, NULL);\
+            fct_alloc__to_str(NULL, NULL, 0);\
+            fct_alloc__from_str(NULL, NULL);\
+            fct_rusage__to_str(NULL, NULL, 0);\
+            fct_rusage__from_str(NULL, NULL);\
+            (void)fctkern__threads_end(NULL);\
             (void)fctkern__log_suite_start(NULL, NULL);\
             (void)fctkern__log_suite_end(NULL, NULL);\
             (void)fctkern__log_test_skip(NULL, NULL, NULL);\
@@ -3244,6 +8741,7 @@ they are needed, but at runtime, only the cheap, first call is made. */
             (void)fct_clp__is_param(NULL,NULL);\
             _fct_cmt("should never construct an object");\
             (void)fct_test_new(NULL);\
+            (void)fctchk_clone(NULL);\
             (void)fct_ts__chk_cnt(NULL);\
         }\
     }
@@ -3262,6 +8760,9 @@ they are needed, but at runtime, only the cheap, first call is made. */
  
 
 #define FCT_FINAL()                                                \
+   fctkern__threads_end(fctkern_ptr__);                            \
+   fctkern__registry_call_mf(fctkern_ptr__);                       \
+   fctkern__jobs_end(fctkern_ptr__);                               \
    fctkern_ptr__->ns.num_total_failed = fctkern__tst_cnt_failed(   \
             (fctkern_ptr__)                                        \
            );                                                      \
@@ -3326,26 +8827,41 @@ functions. */
 #define fctlog_install(_CUST_LOGGER_LIST_) \
     fctkern_ptr__->lt_usr = (_CUST_LOGGER_LIST_)
 
+/* Parses the command line, if it has not been done yet. The parse is
+delayed until it is needed, in order to allow for user customization. */
+#define _FCT_CL_PARSE_ONCE() \
+    if ( !fctkern__cl_is_parsed((fctkern_ptr__)) ) {\
+        int status = fctkern__cl_parse((fctkern_ptr__));\
+        _fct_cmt("Need to parse command line before we start logger.");\
+        fctkern__log_start((fctkern_ptr__));\
+        switch( status ) {\
+        case -1:\
+        case 0:\
+            fctkern__final(fctkern_ptr__);\
+            exit( (status == 0) ? (EXIT_FAILURE) : (EXIT_SUCCESS) );\
+            break;\
+        default:\
+            fct_pass();\
+        }\
+    }
+
+/* Marks the point where the process is warmed up and ready to be forked.
+With --jobs or --isolate the workers are forked here, rather than at the
+first suite, so any expensive start up before it is done only once and
+shared copy-on-write. Does nothing more than parse the command line
+otherwise. */
+#define FCT_ZYGOTE_READY() \
+    {\
+        _FCT_CL_PARSE_ONCE()\
+        fctkern__jobs_start(fctkern_ptr__);\
+    }
+
 /* Re-parses the command line options with the addition of user defined
 options. */
 #define fctcl_install(_CLO_INIT_) \
     {\
         fctkern_ptr__->cl_user_opts = (_CLO_INIT_);\
-        _fct_cmt("Delay parse in order to allow for user customization.");\
-        if ( !fctkern__cl_is_parsed((fctkern_ptr__)) ) {\
-              int status = fctkern__cl_parse((fctkern_ptr__));\
-              _fct_cmt("Need to parse command line before we start logger.");\
-              fctkern__log_start((fctkern_ptr__));\
-              switch( status ) {\
-              case -1:\
-              case 0:\
-                  fctkern__final(fctkern_ptr__);\
-                  exit( (status == 0) ? (EXIT_FAILURE) : (EXIT_SUCCESS) );\
-                  break;\
-              default:\
-                  fct_pass();\
-              }\
-          }\
+        _FCT_CL_PARSE_ONCE()\
     }
 
 
@@ -3360,31 +8876,43 @@ options. */
 /* We delay the first parse of the command line until we get the first
 test fixture. This allows the user to possibly add their own parse
 specification. */
+#if defined(FCT_REGISTRY)
+#   define _FCT_SUITE_DESC(_NAME_STR_) \
+       static fct_suite_desc_t const fct_suite_desc__ = \
+           { _NAME_STR_ };
+#   define _FCT_SUITE_PRIME() \
+       fctkern__registry_prime(\
+           fctkern_ptr__, fctkern_ptr__->ns.ts_curr, &fct_suite_desc__\
+       );
+#   define _FCT_TEST_DESC(_NAME_STR_, _ID_) \
+       static fct_test_desc_t const fct_test_desc__ = \
+           { &fct_suite_desc__, _NAME_STR_, (_ID_) };\
+       static fct_test_desc_t const *const fct_test_descp__ \
+           _FCT_SECTION("fct_tests") = &fct_test_desc__;
+#else
+#   define _FCT_SUITE_DESC(_NAME_STR_)
+#   define _FCT_SUITE_PRIME()
+#   define _FCT_TEST_DESC(_NAME_STR_, _ID_)
+#endif /* FCT_REGISTRY */
+
 #define FCT_FIXTURE_SUITE_BGN(_NAME_) \
    {\
-      fctkern_ptr__->ns.ts_curr = fct_ts_new( #_NAME_ );\
-      _fct_cmt("Delay parse in order to allow for user customization.");\
-      if ( !fctkern__cl_is_parsed((fctkern_ptr__)) ) {\
-          int status = fctkern__cl_parse((fctkern_ptr__));\
-          _fct_cmt("Need to parse command line before we start logger.");\
-          fctkern__log_start((fctkern_ptr__));\
-          switch( status ) {\
-          case -1:\
-          case 0:\
-              fct_ts__del((fctkern_ptr__->ns.ts_curr));\
-              fctkern__final(fctkern_ptr__);\
-              exit( (status == 0) ? (EXIT_FAILURE) : (EXIT_SUCCESS) );\
-              break;\
-          default:\
-              fct_pass();\
-          }\
-      }\
-      if ( fctkern_ptr__->ns.ts_curr == NULL ) {\
-         fctkern__log_warn((fctkern_ptr__), "out of memory");\
+      _FCT_SUITE_DESC( #_NAME_ )\
+      fctkern_ptr__->ns.ts_curr = NULL;\
+      _FCT_CL_PARSE_ONCE()\
+      fctkern__jobs_start(fctkern_ptr__);\
+      fctkern__threads_sync(fctkern_ptr__);\
+      _fct_cmt("A suite that can not match is passed over untouched.");\
+      if ( fctkern__pass_suite_filter(fctkern_ptr__, #_NAME_) ) {\
+         fctkern_ptr__->ns.ts_curr = fct_ts_new2( #_NAME_, FCT_TRUE );\
+         if ( fctkern_ptr__->ns.ts_curr == NULL ) {\
+            fctkern__log_warn((fctkern_ptr__), "out of memory");\
+         }\
       }\
-      else\
+      if ( fctkern_ptr__->ns.ts_curr != NULL )\
       {\
          fctkern__log_suite_start((fctkern_ptr__), fctkern_ptr__->ns.ts_curr);\
+         _FCT_SUITE_PRIME()\
          for (;;)\
          {\
              fctkern_ptr__->ns.test_num = -1;\
@@ -3398,16 +8926,22 @@ specification. */
 
 
 
-/*  Closes off a "Fixture" test suite. */
+/*  Closes off a "Fixture" test suite. The first brace closes the
+dispatch switch opened by FCT_SETUP_END. */
 #define FCT_FIXTURE_SUITE_END() \
+             }\
              if ( fct_ts__is_cnt_mode(fctkern_ptr__->ns.ts_curr) )\
              {\
+                fctkern__select_tests(fctkern_ptr__, fctkern_ptr__->ns.ts_curr);\
                 fct_ts__cnt_end(fctkern_ptr__->ns.ts_curr);\
              }\
+             fct_ts__walk_end(fctkern_ptr__->ns.ts_curr);\
           }\
-          fctkern__add_ts((fctkern_ptr__), fctkern_ptr__->ns.ts_curr);\
+          fctkern__jobs_suite_end((fctkern_ptr__), fctkern_ptr__->ns.ts_curr);\
+          fct_ts__stop_timer(fctkern_ptr__->ns.ts_curr);\
           fctkern__log_suite_end((fctkern_ptr__), fctkern_ptr__->ns.ts_curr);\
           fct_ts__end(fctkern_ptr__->ns.ts_curr);\
+          fctkern__add_ts((fctkern_ptr__), fctkern_ptr__->ns.ts_curr);\
           fctkern_ptr__->ns.ts_curr = NULL;\
           }\
       }
@@ -3415,7 +8949,8 @@ specification. */
 #define FCT_FIXTURE_SUITE_BGN_IF(_CONDITION_, _NAME_) \
     fctkern_ptr__->ns.ts_is_skip_suite = !(_CONDITION_);\
     fctkern_ptr__->ns.ts_skip_cndtn = #_CONDITION_;\
-    if ( fctkern_ptr__->ns.ts_is_skip_suite ) {\
+    if ( fctkern_ptr__->ns.ts_is_skip_suite \
+         && fctkern__pass_suite_filter(fctkern_ptr__, #_NAME_) ) {\
        fctkern__log_suite_skip((fctkern_ptr__), #_CONDITION_, #_NAME_);\
     }\
     FCT_FIXTURE_SUITE_BGN(_NAME_);
@@ -3426,15 +8961,25 @@ specification. */
     fctkern_ptr__->ns.ts_skip_cndtn =NULL;\
  
 #define FCT_SETUP_BGN()\
-   if ( fct_ts__is_setup_mode(fctkern_ptr__->ns.ts_curr) ) {
+   if ( fct_ts__is_setup_mode(fctkern_ptr__->ns.ts_curr) ) {\
+   fct_ts__setup_bgn(fctkern_ptr__->ns.ts_curr);
 
+/* After the setup we either jump straight to the current test, or walk
+the rest of the suite (counting, tearing down). The switch is closed by
+FCT_FIXTURE_SUITE_END. */
 #define FCT_SETUP_END() \
-   fct_ts__setup_end(fctkern_ptr__->ns.ts_curr); }
+   fct_ts__setup_end(fctkern_ptr__->ns.ts_curr); }\
+   switch ( fct_ts__dispatch(fctkern_ptr__->ns.ts_curr,\
+                             &(fctkern_ptr__->ns.test_num)) ) {\
+   default: ;
 
 #define FCT_TEARDOWN_BGN() \
    if ( fct_ts__is_teardown_mode(fctkern_ptr__->ns.ts_curr) ) {\
+   fct_ts__teardown_bgn(fctkern_ptr__->ns.ts_curr);
  
 #define FCT_TEARDOWN_END() \
+   fct_ts__teardown_stop(fctkern_ptr__->ns.ts_curr); \
+   fctkern__jobs_test_end(fctkern_ptr__, fctkern_ptr__->ns.ts_curr); \
    fct_ts__teardown_end(fctkern_ptr__->ns.ts_curr); \
    continue; \
    }
@@ -3462,10 +9007,17 @@ typedef enum
 } FCT_TEST_END_FLAG;
 
 
-#define FCT_TEST_BGN_IF(_CONDITION_, _NAME_) { \
+#define FCT_TEST_BGN_IF(_CONDITION_, _NAME_) \
+    _FCT_TEST_BGN_IF((_CONDITION_), #_CONDITION_, #_NAME_, _FCT_TEST_ID)
+
+/* The entry comes before the condition, so a jump to this test still
+evaluates it. */
+#define _FCT_TEST_BGN_IF(_CONDITION_, _CNDTN_STR_, _NAME_STR_, _ID_) { \
+    _FCT_TEST_DESC(_NAME_STR_, _ID_)\
+    _FCT_TEST_ENTRY(_ID_)\
     fctkern_ptr__->ns.test_is_skip = !(_CONDITION_);\
-    fctkern_ptr__->ns.test_skip_cndtn = #_CONDITION_;\
-    FCT_TEST_BGN(_NAME_) {\
+    fctkern_ptr__->ns.test_skip_cndtn = _CNDTN_STR_;\
+    { _FCT_TEST_START(_NAME_STR_, _ID_) {\
  
 #define FCT_TEST_END_IF() \
     } FCT_TEST_END();\
@@ -3475,62 +9027,123 @@ typedef enum
 
 
 /* Depending on whether or not we are counting the tests, we will have to
-first determine if the test is the "current" count. Then we have to determine
-if we can pass the filter. Finally we will execute everything so that when a
-check fails, we can "break" out to the end of the test. And in between all
-that we do a memory check and fail a test if we can't build a fct_test
-object (should be rare). */
-#define FCT_TEST_BGN(_NAME_) \
+first determine if the test is the "current" count. The filters where
+already applied when the suite finished counting, so a test that gets
+this far is always run (or skipped by its condition). Finally we will
+execute everything so that when a check fails, we can "break" out to
+the end of the test. And in between all that we do a memory check and
+fail a test if we can't build a fct_test object (should be rare). */
+#if defined(FCT_JUMP_DISPATCH)
+/* The "if (0)" keeps the case label from being a fall through. */
+#   define _FCT_TEST_ENTRY(_ID_)      if (0) { case (_ID_): ; }
+#else
+#   define _FCT_TEST_ENTRY(_ID_)
+#endif
+#if defined(FCT_REGISTRY)
+#   define _FCT_TEST_IN_PLACE(_ID_) \
+       fct_ts__is_in_place(fctkern_ptr__->ns.ts_curr,\
+                           fctkern_ptr__->ns.test_num, (_ID_))
+#else
+#   define _FCT_TEST_IN_PLACE(_ID_)   FCT_TRUE
+#endif
+#if defined(FCT_TEST_IDS)
+#   define _FCT_TEST_ID               __COUNTER__
+#else
+#   define _FCT_TEST_ID               0
+#endif
+
+#define FCT_TEST_BGN(_NAME_) _FCT_TEST_BGN(#_NAME_, _FCT_TEST_ID)
+
+#define _FCT_TEST_BGN(_NAME_STR_, _ID_) \
          {\
-            fctkern_ptr__->ns.curr_test_name = #_NAME_;\
+            _FCT_TEST_DESC(_NAME_STR_, _ID_)\
+            _FCT_TEST_ENTRY(_ID_)\
+            _FCT_TEST_START(_NAME_STR_, _ID_)
+
+#define _FCT_TEST_START(_NAME_STR_, _ID_) \
+            fctkern_ptr__->ns.curr_test_name = _NAME_STR_;\
             ++(fctkern_ptr__->ns.test_num);\
             if ( fct_ts__is_cnt_mode(fctkern_ptr__->ns.ts_curr) )\
             {\
                fct_ts__inc_total_test_num(fctkern_ptr__->ns.ts_curr);\
+               fct_ts__add_entry(fctkern_ptr__->ns.ts_curr, _NAME_STR_, (_ID_));\
             }\
-            else if ( fct_ts__is_test_mode(fctkern_ptr__->ns.ts_curr) \
+            else if ( _FCT_TEST_IN_PLACE(_ID_) \
+                      && fct_ts__is_test_mode(fctkern_ptr__->ns.ts_curr) \
                       && fct_ts__is_test_cnt(fctkern_ptr__->ns.ts_curr, fctkern_ptr__->ns.test_num) )\
             {\
                fct_ts__test_begin(fctkern_ptr__->ns.ts_curr);\
-               if ( fctkern__pass_filter(fctkern_ptr__,  fctkern_ptr__->ns.curr_test_name ) )\
-               {\
-                  fctkern_ptr__->ns.curr_test = fct_test_new( fctkern_ptr__->ns.curr_test_name );\
-                  if ( fctkern_ptr__->ns.curr_test  == NULL ) {\
-                    fctkern__log_warn(fctkern_ptr__, "out of memory");\
-                  } else if ( fctkern_ptr__->ns.ts_is_skip_suite \
-                              || fctkern_ptr__->ns.test_is_skip ) {\
-                       fct_ts__test_begin(fctkern_ptr__->ns.ts_curr);\
-                       fctkern__log_test_skip(\
-                            fctkern_ptr__,\
-                            fctkern_ptr__->ns.curr_test_name,\
-                            (fctkern_ptr__->ns.test_is_skip) ?\
-                                (fctkern_ptr__->ns.test_skip_cndtn) :\
-                                (fctkern_ptr__->ns.ts_skip_cndtn)\
-                       );\
-                       fct_ts__test_end(fctkern_ptr__->ns.ts_curr);\
-                       continue;\
-                 } else {\
-                      fctkern__log_test_start(fctkern_ptr__, fctkern_ptr__->ns.curr_test);\
-                      fct_test__start_timer(fctkern_ptr__->ns.curr_test);\
-                      for (;;) \
-                      {
+               if ( fctkern_ptr__->ns.ts_is_skip_suite \
+                    || fctkern_ptr__->ns.test_is_skip ) {\
+                  fctkern__log_test_skip(\
+                       fctkern_ptr__,\
+                       fctkern_ptr__->ns.curr_test_name,\
+                       (fctkern_ptr__->ns.test_is_skip) ?\
+                           (fctkern_ptr__->ns.test_skip_cndtn) :\
+                           (fctkern_ptr__->ns.ts_skip_cndtn)\
+                  );\
+                  _fct_cmt("FCT_TEST_END_IF is never reached, reset here.");\
+                  fctkern_ptr__->ns.test_is_skip = 0;\
+                  fctkern_ptr__->ns.test_skip_cndtn = NULL;\
+                  fct_ts__test_end(fctkern_ptr__->ns.ts_curr);\
+                  continue;\
+               }\
+               fctkern_ptr__->ns.curr_test = fct_ts__new_test( fctkern_ptr__->ns.ts_curr, fctkern_ptr__->ns.curr_test_name );\
+               if ( fctkern_ptr__->ns.curr_test  == NULL ) {\
+                  fctkern__log_warn(fctkern_ptr__, "out of memory");\
+               } else {\
+                  fctkern__log_test_start(fctkern_ptr__, fctkern_ptr__->ns.curr_test);\
+                  fct_test__start_timer(fctkern_ptr__->ns.curr_test);\
+                  for (;;) \
+                  {
 
 
 
 
 #define FCT_TEST_END() \
-                         break;\
-                      }\
-                      fct_test__stop_timer(fctkern_ptr__->ns.curr_test);\
-                 }\
-                 fct_ts__add_test(fctkern_ptr__->ns.ts_curr, fctkern_ptr__->ns.curr_test);\
-                 fctkern__log_test_end(fctkern_ptr__, fctkern_ptr__->ns.curr_test);\
+                     break;\
+                  }\
+                  fct_test__stop_timer(fctkern_ptr__->ns.curr_test);\
+                  fctkern__merge_chk_bufs(fctkern_ptr__, fctkern_ptr__->ns.curr_test);\
+                  fct_ts__add_test(fctkern_ptr__->ns.ts_curr, fctkern_ptr__->ns.curr_test);\
+                  fctkern__log_test_end(fctkern_ptr__, fctkern_ptr__->ns.curr_test);\
                }\
                fct_ts__test_end(fctkern_ptr__->ns.ts_curr);\
                continue;\
             }\
          }\
- 
+
+
+/* A test whose body is a benchmark, see BENCHMARK. Keep the checks out
+of the body, it is run a great many times with --bench. */
+#define FCT_BENCH_BGN(_NAME_) \
+    FCT_TEST_BGN(_NAME_)\
+    {\
+        fct_bench_t fct_bench__;\
+        int fct_bench_cmp__;\
+        fct_bench__init(&fct_bench__, fctkern_ptr__, fctkern_ptr__->ns.curr_test);\
+        while ( fct_bench__next(&fct_bench__) )\
+        {\
+            size_t fct_bench_i__;\
+            for ( fct_bench_i__ =0; \
+                  fct_bench_i__ != fct_bench__.batch; \
+                  ++fct_bench_i__ )\
+            {
+
+#define FCT_BENCH_END() \
+            }\
+        }\
+        fct_bench__end(&fct_bench__);\
+        fct_bench_cmp__ = fct_bench__chk_baseline(&fct_bench__);\
+        if ( fct_bench_cmp__ >= 0 )\
+        {\
+            fct_xchk2("benchmark no slower than its baseline",\
+                      fct_bench_cmp__,\
+                      "%s",\
+                      fct_bench__.msg);\
+        }\
+    }\
+    FCT_TEST_END()
 
 
 /*
@@ -3551,10 +9164,15 @@ the error handling in the APR library. The unfortunate thing is that we can
 not carry forth the actual test through a "stringize" operation, but if you
 wanted to do that you should use fct_chk. */
 
-static int fct_xchk_lineno =0;
-static char const *fct_xchk_file = NULL;
-static fct_test_t *fct_xchk_test = NULL;
-static fctkern_t *fct_xchk_kern =NULL;
+static FCT_TLS int fct_xchk_lineno =0;
+static FCT_TLS char const *fct_xchk_file = NULL;
+static FCT_TLS fct_test_t *fct_xchk_test = NULL;
+static FCT_TLS fctkern_t *fct_xchk_kern =NULL;
+
+#if !defined(FCT_CONF_KEEP_PASSED_CHKS)
+/* A check that passed is built here, logged and counted, and never kept. */
+static FCT_TLS fctchk_t fct_xchk_pass;
+#endif /* FCT_CONF_KEEP_PASSED_CHKS */
 
 
 static int
@@ -3566,22 +9184,76 @@ _fct_xchk_fn_varg(
 )
 {
     fctchk_t *chk =NULL;
-    chk = fctchk_new(
-              is_pass,
-              condition,
-              fct_xchk_file,
-              fct_xchk_lineno,
-              format,
-              args
-          );
-    if ( chk == NULL )
+    /* Past --max-failures a failure is only counted, the threads are
+    capped when their checks are merged. */
+    if ( !is_pass
+            && fct_test__is_owner(fct_xchk_test)
+            && fctkern__is_test_full(fct_xchk_kern, fct_xchk_test) )
+    {
+        ++(fct_xchk_test->num_dropped);
+        goto finally;
+    }
+#if !defined(FCT_CONF_KEEP_PASSED_CHKS)
+    if ( is_pass && fct_test__is_owner(fct_xchk_test) )
+    {
+        chk = &fct_xchk_pass;
+    }
+    else
+#endif /* FCT_CONF_KEEP_PASSED_CHKS */
+    {
+        /* Other threads can not share the arena, they use the heap. */
+        chk = fctchk__alloc(
+                  fct_test__is_owner(fct_xchk_test) ? fct_xchk_test->arena : NULL
+              );
+        if ( chk == NULL )
+        {
+            fctkern__log_warn(fct_xchk_kern, "out of memory (aborting test)");
+            goto finally;
+        }
+    }
+    /* The message is only formatted for a failure, a check that passes
+    keeps the format string as it is. */
+    if ( is_pass )
+    {
+        fctchk__init_plain(chk,
+                           is_pass,
+                           condition,
+                           fct_xchk_file,
+                           fct_xchk_lineno,
+                           (format != NULL) ? format : condition);
+    }
+    else if ( !fctchk__init(chk,
+                            is_pass,
+                            condition,
+                            fct_xchk_file,
+                            fct_xchk_lineno,
+                            format,
+                            args) )
     {
         fctkern__log_warn(fct_xchk_kern, "out of memory (aborting test)");
+        fctchk__del(chk);
+        goto finally;
+    }
+#if !defined(FCT_CONF_KEEP_PASSED_CHKS)
+    if ( chk == &fct_xchk_pass )
+    {
+        fctkern__log_chk(fct_xchk_kern, chk);
+        fct_test__add_pass(fct_xchk_test);
         goto finally;
     }
+#endif /* FCT_CONF_KEEP_PASSED_CHKS */
 
-    fct_test__add(fct_xchk_test, chk);
+    if ( !fct_test__is_owner(fct_xchk_test) )
+    {
+        /* Not safe to log from here, so it is done at FCT_TEST_END. */
+        if ( !fct_test__add_from_thread(fct_xchk_test, chk) )
+        {
+            fctchk__del(chk);
+        }
+        goto finally;
+    }
     fctkern__log_chk(fct_xchk_kern, chk);
+    fct_test__add(fct_xchk_test, chk);
 finally:
     fct_xchk_lineno =0;
     fct_xchk_file =NULL;
@@ -3621,26 +9293,41 @@ fct_xchk_fn(int is_pass, char const *format, ...)
 
 the bulk of this macro presets some globals to allow us to support
 variable argument lists on older compilers. The idea came from the APR
-libraries error checking routines. */
-#define fct_xchk  fct_xchk_kern = fctkern_ptr__,\
-                  fct_xchk_test = fctkern_ptr__->ns.curr_test,\
-                  fct_xchk_lineno =__LINE__,\
-                  fct_xchk_file=__FILE__,\
-                  fct_xchk_fn
-
-#define fct_xchk2  fct_xchk_kern = fctkern_ptr__,\
-                   fct_xchk_test = fctkern_ptr__->ns.curr_test,\
-                   fct_xchk_lineno =__LINE__,\
-                   fct_xchk_file=__FILE__,\
-                   fct_xchk2_fn
+libraries error checking routines.
+
+Where the compiler has variable argument macros, the condition is
+tested first, and the arguments for the message are only evaluated
+when it fails. */
+#define _FCT_XCHK_AT  fct_xchk_kern = fctkern_ptr__,\
+                      fct_xchk_test = fctkern_ptr__->ns.curr_test,\
+                      fct_xchk_lineno =__LINE__,\
+                      fct_xchk_file=__FILE__
+
+#if defined(FCT_VARIADIC_MACROS)
+#   define _FCT_VA_FIRST(_A_, ...) _A_
+#   define fct_xchk(_CNDTN_, ...) \
+        ((_CNDTN_) ?\
+         (_FCT_XCHK_AT, fct_xchk2_fn("<none-from-xchk>", 1,\
+                                     _FCT_VA_FIRST(__VA_ARGS__, ~))) :\
+         (_FCT_XCHK_AT, fct_xchk_fn(0, __VA_ARGS__)))
+#   define fct_xchk2(_CNDTN_STR_, _CNDTN_, ...) \
+        ((_CNDTN_) ?\
+         (_FCT_XCHK_AT, fct_xchk2_fn((_CNDTN_STR_), 1,\
+                                     _FCT_VA_FIRST(__VA_ARGS__, ~))) :\
+         (_FCT_XCHK_AT, fct_xchk2_fn((_CNDTN_STR_), 0, __VA_ARGS__)))
+#else
+#   define fct_xchk  _FCT_XCHK_AT, fct_xchk_fn
+#   define fct_xchk2 _FCT_XCHK_AT, fct_xchk2_fn
+#endif /* FCT_VARIADIC_MACROS */
 
 
 /* This checks the condition and reports the condition as a string
-if it fails. */
-#define fct_chk(_CNDTN_)  (fct_xchk((_CNDTN_) ? 1 : 0, #_CNDTN_))
+if it fails. The condition is kept as the literal it is, never formatted
+or cut short. */
+#define fct_chk(_CNDTN_)  (fct_xchk2(#_CNDTN_, (_CNDTN_) ? 1 : 0, NULL))
 
 #define _fct_req(_CNDTN_)  \
-    if ( !(fct_xchk((_CNDTN_) ? 1 : 0, #_CNDTN_)) ) { break; }
+    if ( !(fct_xchk2(#_CNDTN_, (_CNDTN_) ? 1 : 0, NULL)) ) { break; }
 
 
 /* When in test mode, construct a mock test object for fct_xchk to operate
@@ -3888,8 +9575,23 @@ See test_multi.c for an example.
 file to define your test suite.  */
 
 
+#if defined(FCT_REGISTRY)
+#   define _FCTMF_SUITE_DESC(NAME) \
+       void NAME (fctkern_t *);\
+       static fctmf_suite_desc_t fctmf_suite_desc_##NAME = { #NAME, NAME, 0 };\
+       static fctmf_suite_desc_t *const fctmf_suite_descp_##NAME \
+           _FCT_SECTION("fct_mf_suites") = &fctmf_suite_desc_##NAME;
+#   define _FCTMF_SUITE_CALLED(NAME) \
+       fctmf_suite_desc_##NAME.is_called = 1;
+#else
+#   define _FCTMF_SUITE_DESC(NAME)
+#   define _FCTMF_SUITE_CALLED(NAME)
+#endif /* FCT_REGISTRY */
+
 #define FCTMF_FIXTURE_SUITE_BGN(NAME) \
+    _FCTMF_SUITE_DESC(NAME)\
     void NAME (fctkern_t *fctkern_ptr__) {\
+        _FCTMF_SUITE_CALLED(NAME)\
         FCT_REFERENCE_FUNCS();\
         FCT_FIXTURE_SUITE_BGN( NAME ) {
 
@@ -3898,7 +9600,9 @@ file to define your test suite.  */
     }
 
 #define FCTMF_SUITE_BGN(NAME) \
+    _FCTMF_SUITE_DESC(NAME)\
     void NAME (fctkern_t *fctkern_ptr__) {\
+        _FCTMF_SUITE_CALLED(NAME)\
         FCT_REFERENCE_FUNCS();\
         FCT_SUITE_BGN( NAME ) {
 #define FCTMF_SUITE_END() \
@@ -3910,10 +9614,14 @@ file to define your test suite.  */
 #define FCTMF_SUITE_DEF(NAME)
 
 
-/* Executes a test suite defined by FCTMF_SUITE* */
+/* Executes a test suite defined by FCTMF_SUITE*, unless the suite was
+excluded on the command line. */
 #define FCTMF_SUITE_CALL(NAME)  {\
     void NAME (fctkern_t *);\
-    NAME (fctkern_ptr__);\
+    _FCT_CL_PARSE_ONCE()\
+    if ( fctkern__pass_suite_filter(fctkern_ptr__, #NAME) ) {\
+        fctkern__call_mf(fctkern_ptr__, #NAME, NAME);\
+    }\
     }
 
 
@@ -0,0 +1,73 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_alloc.c
+
+Checks that a test counts its own allocations and the most it had live,
+and not those FCTX makes for a failed check. The program is linked with
+the C library calls wrapped, see tests/CMakeLists.txt. We supply our own
+command line, so the tests are there to look at once they end.
+*/
+
+#define FCT_CONF_ALLOC
+#include "fct.h"
+#include "test_support.h"
+
+/* So the compiler can not do away with them. */
+static void *volatile block =NULL;
+FCT_BGN_FN(alloc_main)
+{
+    FCT_SUITE_BGN(alloc)
+    {
+        FCT_TEST_BGN(mallocs)
+        {
+            block = malloc(100);
+            block = realloc(block, 200);
+            free(block);
+            block = calloc(2, 50);
+            free(block);
+            block = NULL;
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(fails_without_allocating)
+        {
+            fct_chk(0);
+        }
+        FCT_TEST_END();
+    }
+    FCT_SUITE_END();
+
+#if defined(FCT_ALLOC)
+    {
+        fct_ts_t const *ts = (fct_ts_t const*)fct_nlist__at(
+                                 &(fctkern_ptr__->ts_list), 0
+                             );
+        fct_test_t const *test = (fct_test_t const*)fct_nlist__at(
+                                     &(ts->test_list), 0
+                                 );
+        test_chk_run(test->alloc.num_allocs == 3);
+        test_chk_run(test->alloc.num_bytes == 400);
+        test_chk_run(test->alloc.peak_bytes >= 200);
+        test_chk_run(test->alloc.live_bytes == 0);
+        test = (fct_test_t const*)fct_nlist__at(&(ts->test_list), 1);
+        test_chk_run(test->alloc.num_allocs == 0);
+    }
+#endif /* FCT_ALLOC */
+
+    TEST_EXPECTED_FAILURES(1);
+}
+FCT_END_FN();
+
+
+int main(int argc, char *argv[])
+{
+    char *test_argv[] = {NULL};
+    fct_unused(argc);
+    test_argv[0] = argv[0];
+    return alloc_main(1, test_argv);
+}
@@ -0,0 +1,117 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_bench.c
+
+Checks that a benchmark runs once without --bench, and is warmed up,
+timed in batches and reported with it. Then works out the figures for a
+known set of samples. We supply our own command line, so the test is
+there to look at once it ends.
+*/
+
+#include "fct.h"
+#include "test_support.h"
+
+static volatile unsigned long sink =0;
+static size_t num_runs =0;
+FCT_BGN_FN(bench_main)
+{
+    FCT_SUITE_BGN(bench)
+    {
+        FCT_BENCH_BGN(sums)
+        {
+            unsigned long add_i =0;
+            for ( add_i =0; add_i != 100; ++add_i )
+            {
+                sink += add_i;
+            }
+            ++num_runs;
+        }
+        FCT_BENCH_END();
+    }
+    FCT_SUITE_END();
+
+    FCT_SUITE_BGN(bench_stats)
+    {
+        FCT_TEST_BGN(one_outlier)
+        {
+            fct_bench_stats_t stats;
+            size_t sample_i =0;
+            memset(&stats, 0, sizeof(stats));
+            /* 1 to 9, out of order, and 100 */
+            for ( sample_i =0; sample_i != 9; ++sample_i )
+            {
+                stats.samples[sample_i] = (double)((sample_i * 4) % 9 + 1);
+            }
+            stats.samples[9] = 100.0;
+            stats.num_samples = 10;
+            fct_bench_stats__update(&stats);
+            fct_chk_eq_dbl(stats.median, 5.5);
+            fct_chk_eq_dbl(stats.min, 1.0);
+            /* Interpolated, so not exact. */
+            fct_chk(stats.p90 > 18.09 && stats.p90 < 18.11);
+            fct_chk(stats.p99 > 91.80 && stats.p99 < 91.82);
+            fct_chk_eq_dbl(stats.mad, 2.5);
+            fct_chk_eq_dbl(stats.ci_low, 2.0);
+            fct_chk_eq_dbl(stats.ci_high, 9.0);
+            fct_chk_eq_int((int)stats.num_outliers, 1);
+            /* The mean leaves the outlier out. */
+            fct_chk_eq_dbl(stats.ns_per_op, 5.0);
+        }
+        FCT_TEST_END();
+    }
+    FCT_SUITE_END();
+
+    {
+        fct_ts_t const *ts = (fct_ts_t const*)fct_nlist__at(
+                                 &(fctkern_ptr__->ts_list), 0
+                             );
+        fct_test_t const *test = (fct_test_t const*)fct_nlist__at(
+                                     &(ts->test_list), 0
+                                 );
+        fct_bench_stats_t const *stats = test->bench;
+        if ( !fctkern_ptr__->is_bench )
+        {
+            test_chk_run(num_runs == 1);
+            test_chk_run(stats == NULL);
+        }
+        else
+        {
+            test_chk_run(stats != NULL);
+            if ( stats != NULL )
+            {
+                test_chk_run(stats->num_samples >= FCT_BENCH_MIN_SAMPLES);
+                test_chk_run(stats->num_warmup_iters > 0);
+                test_chk_run(stats->ns_per_op > 0.0);
+                test_chk_run(num_runs == stats->num_warmup_iters
+                             + fct_bench_stats__num_iters(stats));
+            }
+        }
+    }
+
+    TEST_EXPECTED_FAILURES(0);
+}
+FCT_END_FN();
+
+
+int main(int argc, char *argv[])
+{
+    char *test_argv[] = {NULL, NULL, NULL, NULL};
+    char bench_opt[] = "--bench";
+    char bench_time_opt[] = "--bench-time";
+    char bench_time_val[] = "0.05";
+    int status =0;
+    fct_unused(argc);
+    test_argv[0] = argv[0];
+    status = bench_main(1, test_argv);
+    num_runs = 0;
+    test_argv[1] = bench_opt;
+    test_argv[2] = bench_time_opt;
+    test_argv[3] = bench_time_val;
+    status = status || bench_main(4, test_argv);
+    return status;
+}
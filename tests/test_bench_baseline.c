@@ -0,0 +1,122 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_bench_baseline.c
+
+Runs the benchmarks against a made up --bench-baseline, where one of
+them was far faster before, and checks that it fails. The --bench-out
+file is then read back in as the baseline, with a threshold that lets
+anything pass. We supply our own command line.
+*/
+
+#include "fct.h"
+#include "test_support.h"
+
+static volatile unsigned long sink =0;
+static int num_expected_failures =0;
+
+FCT_BGN_FN(bench_baseline_main)
+{
+    FCT_SUITE_BGN(bench_baseline)
+    {
+        FCT_BENCH_BGN(was_faster)
+        {
+            unsigned long add_i =0;
+            for ( add_i =0; add_i != 100; ++add_i )
+            {
+                sink += add_i;
+            }
+        }
+        FCT_BENCH_END();
+
+        FCT_BENCH_BGN(was_slower)
+        {
+            sink += 1;
+        }
+        FCT_BENCH_END();
+    }
+    FCT_SUITE_END();
+
+    TEST_EXPECTED_FAILURES(num_expected_failures);
+}
+FCT_END_FN();
+
+
+int main(int argc, char *argv[])
+{
+    char *test_argv[] = {NULL, NULL, NULL, NULL, NULL, NULL,
+                         NULL, NULL, NULL, NULL
+                        };
+    char bench_opt[] = "--bench";
+    char bench_time_opt[] = "--bench-time";
+    char bench_time_val[] = "0.02";
+    char baseline_opt[] = "--bench-baseline";
+    char out_opt[] = "--bench-out";
+    char threshold_opt[] = "--bench-threshold";
+    char threshold_val[] = "1000000";
+    char baseline_path[FCT_MAX_NAME];
+    char out_path[FCT_MAX_NAME];
+    char line[FCT_MAX_LOG_LINE];
+    FILE *file =NULL;
+    int sample_i =0;
+    int status =0;
+    fct_unused(argc);
+
+    test_scratch_name(baseline_path, sizeof(baseline_path), argv[0],
+                      "baseline");
+    test_scratch_name(out_path, sizeof(out_path), argv[0], "bench");
+    file = fopen(baseline_path, "w");
+    if ( file == NULL )
+    {
+        fprintf(stderr, "error: unable to write '%s'\n", baseline_path);
+        return 1;
+    }
+    fprintf(file, "bench_baseline.was_faster 1 ");
+    for ( sample_i =0; sample_i != 10; ++sample_i )
+    {
+        fprintf(file, "1 ");
+    }
+    fprintf(file, "\nbench_baseline.was_slower 1 ");
+    for ( sample_i =0; sample_i != 10; ++sample_i )
+    {
+        fprintf(file, "1000000 ");
+    }
+    fprintf(file, "\n");
+    fclose(file);
+
+    test_argv[0] = argv[0];
+    test_argv[1] = bench_opt;
+    test_argv[2] = bench_time_opt;
+    test_argv[3] = bench_time_val;
+    test_argv[4] = baseline_opt;
+    test_argv[5] = baseline_path;
+    test_argv[6] = out_opt;
+    test_argv[7] = out_path;
+    num_expected_failures = 1;
+    status = bench_baseline_main(8, test_argv);
+
+    file = fopen(out_path, "r");
+    test_chk_run(file != NULL);
+    if ( file != NULL )
+    {
+        test_chk_run(fgets(line, sizeof(line), file) != NULL
+                     && strncmp(line, "bench_baseline.was_faster ", 26) == 0);
+        fclose(file);
+    }
+
+    /* What we just measured is the baseline now, and the second run
+    fails if the --bench-out file was not right. */
+    test_argv[5] = out_path;
+    test_argv[6] = threshold_opt;
+    test_argv[7] = threshold_val;
+    num_expected_failures = 0;
+    status = status || bench_baseline_main(8, test_argv);
+
+    remove(baseline_path);
+    remove(out_path);
+    return status;
+}
@@ -63,10 +63,35 @@ FCT_BGN()
             fct_chk(req_cnt == 1);
         }
         FCT_TEST_END();
+
+        FCT_TEST_BGN(test_long_condition)
+        {
+            /* Fail, with a condition longer than FCT_MAX_LOG_LINE. */
+            fct_chk( chk_cnt == 0 && req_cnt == 0 && chk_cnt == 1 && req_cnt == 1
+                     && chk_cnt == 2 && req_cnt == 2 && chk_cnt == 3 && req_cnt == 3
+                     && chk_cnt == 4 && req_cnt == 4 && chk_cnt == 5 && req_cnt == 5
+                     && chk_cnt == 6 && req_cnt == 6 && chk_cnt == 7 && req_cnt == 7
+                     && chk_cnt == 8 && req_cnt == 8 && chk_cnt == 9 && req_cnt == 9 );
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(test_long_condition_not_cut)
+        {
+            fct_nlist_t const *tests = &(fctkern_ptr__->ns.ts_curr->test_list);
+            fct_test_t const *prev = (fct_test_t const*)fct_nlist__at(
+                                         tests, fct_nlist__size(tests)-1
+                                     );
+            fctchk_t const *chk = (fctchk_t const*)fct_nlist__at(
+                                      &(prev->failed_chks), 0
+                                  );
+            fct_chk_eq_str(fct_test__name(prev), "test_long_condition");
+            fct_chk( strlen(fctchk__cndtn(chk)) > FCT_MAX_LOG_LINE );
+        }
+        FCT_TEST_END();
     }
     FCT_FIXTURE_SUITE_END();
 
     printf("\n***TESTS ARE SUPPOSED TO REPORT FAILURES***\n");
-    FCT_EXPECTED_FAILURES(2);
+    FCT_EXPECTED_FAILURES(3);
 }
 FCT_END();
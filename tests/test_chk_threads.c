@@ -0,0 +1,102 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_chk_threads.c
+
+Makes checks from threads that the test starts itself, and checks that
+every one of them ends up in the enclosing test.
+*/
+
+#define FCT_USE_TEST_COUNT
+#include "fct.h"
+#include "test_support.h"
+
+#if defined(FCT_CHK_THREADS) && defined(_POSIX_VERSION)
+#   include <pthread.h>
+#   define NUM_THREADS 8
+#   define NUM_CHKS 10000
+#   define NUM_EXPECTED_FAILURES 1
+
+/* Each thread gets the kernel, so it can make its checks. */
+static void *
+chk_from_thread(void *arg)
+{
+    fctkern_t *fctkern_ptr__ =(fctkern_t*)arg;
+    int chk_i =0;
+    for ( chk_i =0; chk_i != NUM_CHKS; ++chk_i )
+    {
+        fct_chk_eq_int(chk_i, chk_i);
+    }
+    return NULL;
+}
+
+static void *
+fail_from_thread(void *arg)
+{
+    fctkern_t *fctkern_ptr__ =(fctkern_t*)arg;
+    fct_chk(0 && "expected to fail");
+    return NULL;
+}
+#else
+#   define NUM_THREADS 0
+#   define NUM_CHKS 0
+#   define NUM_EXPECTED_FAILURES 0
+#endif /* FCT_CHK_THREADS */
+
+
+FCT_BGN()
+{
+    FCT_SUITE_BGN(chk_threads)
+    {
+        FCT_TEST_BGN(chks_from_many_threads)
+        {
+#if NUM_THREADS > 0
+            pthread_t threads[NUM_THREADS];
+            int thread_i =0;
+            for ( thread_i =0; thread_i != NUM_THREADS; ++thread_i )
+            {
+                pthread_create(
+                    &threads[thread_i], NULL, chk_from_thread, fctkern_ptr__
+                );
+            }
+            fct_chk(1);
+            for ( thread_i =0; thread_i != NUM_THREADS; ++thread_i )
+            {
+                pthread_join(threads[thread_i], NULL);
+            }
+#else
+            fct_chk(1);
+#endif
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(fail_from_a_thread)
+        {
+#if NUM_THREADS > 0
+            pthread_t thread;
+            pthread_create(&thread, NULL, fail_from_thread, fctkern_ptr__);
+            pthread_join(thread, NULL);
+#endif
+            fct_chk(1);
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(after_threads)
+        {
+            fct_chk(1);
+        }
+        FCT_TEST_END();
+    }
+    FCT_SUITE_END();
+
+    test_chk_run(fctkern__chk_cnt(fctkern_ptr__)
+            == (size_t)(NUM_THREADS*NUM_CHKS + 3 + NUM_EXPECTED_FAILURES));
+    test_chk_run(fctkern__tst_cnt_passed(fctkern_ptr__)
+            == (size_t)(3 - NUM_EXPECTED_FAILURES));
+    TEST_EXPECTED_FAILURES(NUM_EXPECTED_FAILURES);
+}
+FCT_END();
@@ -28,6 +28,7 @@ FCT_BGN()
     int is_qtest_if_false =0;
     int is_test_if_true =0;
     int is_test_if_false =0;
+    int is_test_after_skip =0;
 
     /* ------------------------------------------------------------- */
 
@@ -121,6 +122,23 @@ FCT_BGN()
     }
     FCT_SUITE_END();
 
+    /* A skipped test should not take the rest of the suite with it. */
+    FCT_SUITE_BGN(test_if_false_then_more)
+    {
+        FCT_TEST_BGN_IF(false_condition, run_test_if_false_first)
+        {
+            is_test_if_false =1;
+        }
+        FCT_TEST_END_IF();
+
+        FCT_TEST_BGN(run_test_after_skip)
+        {
+            is_test_after_skip =1;
+        }
+        FCT_TEST_END();
+    }
+    FCT_SUITE_END();
+
     /* ------------------------------------------------------------- */
     puts("--- Confirm Conditionals Worked -- \n");
 
@@ -149,6 +167,7 @@ FCT_BGN()
     {
         fct_chk( is_test_if_true );
         fct_chk( !is_test_if_false );
+        fct_chk( is_test_after_skip );
     }
     FCT_QTEST_END();
 }
@@ -55,6 +55,36 @@ FCT_BGN()
     _FCT_GUTCHK(fctkern__tst_cnt(fctkern_ptr__) == 2);
     _FCT_GUTCHK(fctkern__chk_cnt(fctkern_ptr__) == 2);
 
+    /* Lots of passing checks are counted exactly, without being kept. */
+    FCT_SUITE_BGN(many_chks)
+    {
+        FCT_TEST_BGN(check_many)
+        {
+            int chk_i =0;
+            for ( chk_i =0; chk_i != 1000; ++chk_i )
+            {
+                fct_chk_eq_int(chk_i, chk_i);
+            }
+        }
+        FCT_TEST_END();
+    }
+    FCT_SUITE_END();
+    _FCT_GUTCHK(fctkern__tst_cnt(fctkern_ptr__) == 3);
+    _FCT_GUTCHK(fctkern__tst_cnt_passed(fctkern_ptr__) == 3);
+    _FCT_GUTCHK(fctkern__chk_cnt(fctkern_ptr__) == 1002);
+#if !defined(FCT_CONF_KEEP_PASSED_CHKS)
+    {
+        fct_ts_t const *ts = (fct_ts_t const*)fct_nlist__at(
+                                 &(fctkern_ptr__->ts_list), 3
+                             );
+        fct_test_t const *test = (fct_test_t const*)fct_nlist__at(
+                                     &(ts->test_list), 0
+                                 );
+        _FCT_GUTCHK(fct_nlist__size(&(test->passed_chks)) == 0);
+        /* The test came out of its suite's arena. */
+        _FCT_GUTCHK(test->arena == &(((fct_ts_t*)ts)->arena));
+    }
+#endif /* FCT_CONF_KEEP_PASSED_CHKS */
 
 }
 FCT_END();
@@ -0,0 +1,80 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_dispatch.c
+
+Checks that each test in a fixture suite is run exactly once, in order,
+with a setup before it and a teardown after it, when jumping straight to
+each test.
+*/
+
+#define FCT_CONF_JUMP_DISPATCH
+#include "fct.h"
+
+FCT_BGN()
+{
+    int num_setup =0;
+    int num_teardown =0;
+    int num_run =0;
+    int order_ok =1;
+    int fixture_ok =1;
+
+    FCT_FIXTURE_SUITE_BGN(dispatch)
+    {
+        /* Fixture variables live above the setup. */
+        int fixture =0;
+
+        FCT_SETUP_BGN()
+        {
+            ++num_setup;
+            fixture =num_setup;
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            ++num_teardown;
+        }
+        FCT_TEARDOWN_END();
+
+        FCT_TEST_BGN(dispatch_1)
+        {
+            order_ok = order_ok && (num_run == 0);
+            fixture_ok = fixture_ok && (fixture == num_setup);
+            ++num_run;
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(dispatch_2)
+        {
+            order_ok = order_ok && (num_run == 1);
+            fixture_ok = fixture_ok && (fixture == num_setup);
+            ++num_run;
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(dispatch_3)
+        {
+            order_ok = order_ok && (num_run == 2);
+            fixture_ok = fixture_ok && (fixture == num_setup);
+            ++num_run;
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    FCT_QTEST_BGN(dispatch__each_test_ran_once)
+    {
+        fct_chk_eq_int(num_run, 3);
+        fct_chk_eq_int(num_setup, 3);
+        fct_chk_eq_int(num_teardown, 3);
+        fct_chk(order_ok);
+        fct_chk(fixture_ok);
+    }
+    FCT_QTEST_END();
+}
+FCT_END();
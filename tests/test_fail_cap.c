@@ -0,0 +1,79 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_fail_cap.c
+
+Runs with --max-failures, and checks that a test that fails over and
+over keeps only so many failures, while the rest are still counted. The
+failures that are kept come from one line, and are listed once. We
+supply our own command line.
+*/
+
+#define FCT_USE_TEST_COUNT
+#include "fct.h"
+#include "test_support.h"
+
+#define MAX_FAILURES 10
+#define NUM_FAILS 1000
+
+FCT_BGN_FN(fail_cap_main)
+{
+    FCT_SUITE_BGN(fail_cap)
+    {
+        FCT_TEST_BGN(fails_often)
+        {
+            int chk_i =0;
+            for ( chk_i =0; chk_i != NUM_FAILS; ++chk_i )
+            {
+                fct_chk_eq_int(chk_i, -1);
+            }
+            fct_chk(1);
+        }
+        FCT_TEST_END();
+    }
+    FCT_SUITE_END();
+
+    test_chk_run(fctkern__chk_cnt(fctkern_ptr__) == NUM_FAILS + 1);
+    {
+        fct_ts_t const *ts = (fct_ts_t const*)fct_nlist__at(
+                                 &(fctkern_ptr__->ts_list), 0
+                             );
+        fct_test_t const *test = (fct_test_t const*)fct_nlist__at(
+                                     &(ts->test_list), 0
+                                 );
+        fct_fail_list_t list;
+        fct_fail_site_t const *site =NULL;
+        test_chk_run(fct_nlist__size(&(test->failed_chks)) == MAX_FAILURES);
+        test_chk_run(test->num_dropped == NUM_FAILS - MAX_FAILURES);
+        fct_fail_list__init(&list);
+        FCT_NLIST_FOREACH_BGN(fctchk_t const*, chk, &(test->failed_chks))
+        {
+            fct_fail_list__add(&list, chk);
+        }
+        FCT_NLIST_FOREACH_END();
+        site = (fct_fail_site_t const*)fct_nlist__at(&(list.sites), 0);
+        test_chk_run(fct_fail_list__size(&list) == 1);
+        test_chk_run(site->num_fails == MAX_FAILURES);
+        test_chk_run(site->num_msgs == FCT_FAIL_SITE_MAX_MSGS);
+        fct_fail_list__final(&list);
+    }
+    TEST_EXPECTED_FAILURES(1);
+}
+FCT_END_FN();
+
+
+int main(int argc, char *argv[])
+{
+    char *test_argv[] = {NULL, NULL, NULL};
+    char max_failures_opt[] = "--max-failures";
+    char max_failures_val[] = "10";
+    fct_unused(argc);
+    test_argv[0] = argv[0];
+    test_argv[1] = max_failures_opt;
+    test_argv[2] = max_failures_val;
+    return fail_cap_main(3, test_argv);
+}
@@ -11,6 +11,16 @@ File: test_fct_xchk2
 
 #include "fct.h"
 
+static int num_formatted =0;
+
+/* Stands in for an argument that costs something to work out. */
+static char const *
+format_arg(void)
+{
+    ++num_formatted;
+    return "expensive";
+}
+
 FCT_BGN()
 {
     FCT_QTEST_BGN(three_names)
@@ -33,6 +43,23 @@ FCT_BGN()
         }
     }
     FCT_QTEST_END();
+
+    /* The message arguments are only worked out for a failure. */
+    FCT_QTEST_BGN(pass_does_not_format)
+    {
+        int chk_i =0;
+        for ( chk_i =0; chk_i != 100; ++chk_i )
+        {
+            fct_xchk(chk_i >= 0, "failed with %s", format_arg());
+            fct_xchk2("chk_i >= 0", chk_i >= 0, "failed with %s", format_arg());
+        }
+#if defined(FCT_VARIADIC_MACROS)
+        fct_chk_eq_int(num_formatted, 0);
+#else
+        fct_chk_eq_int(num_formatted, 200);
+#endif /* FCT_VARIADIC_MACROS */
+    }
+    FCT_QTEST_END();
 }
 FCT_END();
 
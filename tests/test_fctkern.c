@@ -26,6 +26,71 @@ FCT_BGN()
         fct_chk( fctkern__filter_cnt(&k) == 1 );
         fct_chk( fctkern__pass_filter(&k, "aaaa") );
         fct_chk( !fctkern__pass_filter(&k, "aaab") );
+        fctkern__final(&k);
+    }
+    FCT_QTEST_END();
+
+    FCT_QTEST_BGN(fctkern_test_qualified_filter)
+    {
+        char const *argv_dummy[] = {"test"};
+        int argc_dummy = 1;
+        fctkern_t k;
+        fctkern__init(&k, argc_dummy, argv_dummy);
+        fctkern__add_prefix_filter(&k, "suite_a.aa");
+        fctkern__add_prefix_filter(&k, "suite_b.");
+        fct_chk( fctkern__pass_suite_filter(&k, "suite_a") );
+        fct_chk( fctkern__pass_suite_filter(&k, "suite_b") );
+        fct_chk( !fctkern__pass_suite_filter(&k, "suite_") );
+        fct_chk( !fctkern__pass_suite_filter(&k, "suite_c") );
+        fct_chk( fctkern__pass_filter2(&k, "suite_a", "aaaa") );
+        fct_chk( !fctkern__pass_filter2(&k, "suite_a", "abbb") );
+        fct_chk( fctkern__pass_filter2(&k, "suite_b", "anything") );
+        fct_chk( !fctkern__pass_filter2(&k, "suite_c", "aaaa") );
+        fct_chk( !fctkern__pass_filter(&k, "aaaa") );
+        fctkern__final(&k);
+    }
+    FCT_QTEST_END();
+
+    FCT_QTEST_BGN(fctkern_test_suite_filter)
+    {
+        char const *argv_dummy[] = {"test"};
+        int argc_dummy = 1;
+        fctkern_t k;
+        fctkern__init(&k, argc_dummy, argv_dummy);
+        fct_chk( fctkern__pass_suite_filter(&k, "suite_a") );
+        fctkern__add_suite_filter(&k, "suite_a,,suite_b");
+        fct_chk( fct_nlist__size(&(k.suite_list)) == 2 );
+        fct_chk( fctkern__pass_suite_filter(&k, "suite_a") );
+        fct_chk( fctkern__pass_suite_filter(&k, "suite_b") );
+        fct_chk( !fctkern__pass_suite_filter(&k, "suite_c") );
+        /* A plain prefix filter does not get around --run-suite. */
+        fctkern__add_prefix_filter(&k, "aa");
+        fct_chk( fctkern__pass_suite_filter(&k, "suite_a") );
+        fct_chk( !fctkern__pass_suite_filter(&k, "suite_c") );
+        fctkern__final(&k);
+    }
+    FCT_QTEST_END();
+
+    FCT_QTEST_BGN(fctkern_test_arena)
+    {
+        fct_arena_t arena;
+        char *small =NULL;
+        char *big =NULL;
+        char *after =NULL;
+        fct_arena__init(&arena);
+        small = (char*)fct_arena__alloc(&arena, 3);
+        big = (char*)fct_arena__alloc(&arena, FCT_ARENA_BLK_SZ*2);
+        after = (char*)fct_arena__alloc(&arena, 3);
+        fct_req( small != NULL && big != NULL && after != NULL );
+        fct_chk( (size_t)small % sizeof(fct_arena_align_t) == 0 );
+        fct_chk( (size_t)after % sizeof(fct_arena_align_t) == 0 );
+        /* A big one gets a block to itself, the next small one still goes
+        after the first. */
+        fct_chk( after == small + sizeof(fct_arena_align_t) );
+        memset(big, 'x', FCT_ARENA_BLK_SZ*2);
+        fct_chk_eq_str(fct_arena__strdup(&arena, "copied"), "copied");
+        fct_arena__final(&arena);
+        fct_chk( arena.blks == NULL );
     }
     FCT_QTEST_END();
 
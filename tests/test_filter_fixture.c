@@ -0,0 +1,98 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_filter_fixture.c
+
+Checks that tests removed by the prefix filter do not pay for a setup
+or teardown. We supply our own command line, so the filter is always
+the same.
+*/
+
+#include "fct.h"
+
+FCT_BGN_FN(filter_fixture_main)
+{
+    int num_setup =0;
+    int num_teardown =0;
+    int num_none_setup =0;
+
+    FCT_FIXTURE_SUITE_BGN(filter_fixture)
+    {
+        FCT_SETUP_BGN()
+        {
+            ++num_setup;
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            ++num_teardown;
+        }
+        FCT_TEARDOWN_END();
+
+        FCT_TEST_BGN(filter_out_1)
+        {
+            fct_chk(0 && "should be filtered out");
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(filter_in__wanted)
+        {
+            fct_chk(1);
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(filter_out_2)
+        {
+            fct_chk(0 && "should be filtered out");
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    /* Nothing in here passes the filter, so no fixture work at all. */
+    FCT_FIXTURE_SUITE_BGN(filter_none)
+    {
+        FCT_SETUP_BGN()
+        {
+            ++num_none_setup;
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+        }
+        FCT_TEARDOWN_END();
+
+        FCT_TEST_BGN(filter_out_3)
+        {
+            fct_chk(0 && "should be filtered out");
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    FCT_QTEST_BGN(filter_in__fixture_ran_once)
+    {
+        fct_chk_eq_int(num_setup, 1);
+        fct_chk_eq_int(num_teardown, 1);
+        fct_chk_eq_int(num_none_setup, 0);
+    }
+    FCT_QTEST_END();
+}
+FCT_END_FN();
+
+
+int main(int argc, char *argv[])
+{
+    char *test_argv[] = {NULL, NULL};
+    char filter[] = "filter_in__";
+    fct_unused(argc);
+    test_argv[0] = argv[0];
+    test_argv[1] = filter;
+    return filter_fixture_main(2, test_argv);
+}
@@ -0,0 +1,93 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_fixture_times.c
+
+Checks that the setup, the test and the teardown are timed apart, and
+that the suite is timed from beginning to end. We supply our own command
+line, so the suite is there to look at once it ends.
+*/
+
+#include "fct.h"
+#include "test_support.h"
+
+#if defined(FCT_CLOCK_GETTIME)
+#   define NAP_SECS 0.01
+
+static void
+nap(double secs)
+{
+    struct timespec ts;
+    ts.tv_sec = 0;
+    ts.tv_nsec = (long)(secs * 1000000000.0);
+    while ( nanosleep(&ts, &ts) != 0 )
+    {
+        fct_pass();
+    }
+}
+#else
+#   define NAP_SECS 0.0
+#   define nap(_SECS_)
+#endif /* FCT_CLOCK_GETTIME */
+
+
+FCT_BGN_FN(fixture_times_main)
+{
+    FCT_FIXTURE_SUITE_BGN(fixture_times)
+    {
+        FCT_SETUP_BGN()
+        {
+            nap(NAP_SECS);
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            nap(3*NAP_SECS);
+        }
+        FCT_TEARDOWN_END();
+
+        FCT_TEST_BGN(naps)
+        {
+            nap(2*NAP_SECS);
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+#if defined(FCT_CLOCK_GETTIME)
+    {
+        fct_ts_t const *ts = (fct_ts_t const*)fct_nlist__at(
+                                 &(fctkern_ptr__->ts_list), 0
+                             );
+        fct_test_t const *test = (fct_test_t const*)fct_nlist__at(
+                                     &(ts->test_list), 0
+                                 );
+        double setup = fct_test__setup_duration(test);
+        double body = fct_test__duration(test);
+        double teardown = fct_test__teardown_duration(test);
+        test_chk_run(setup >= 0.9*NAP_SECS);
+        test_chk_run(setup < body);
+        test_chk_run(body >= 1.9*NAP_SECS);
+        test_chk_run(body < teardown);
+        test_chk_run(teardown >= 2.9*NAP_SECS);
+        test_chk_run(fct_ts__duration(ts) >= setup + body + teardown);
+    }
+#endif /* FCT_CLOCK_GETTIME */
+
+    TEST_EXPECTED_FAILURES(0);
+}
+FCT_END_FN();
+
+
+int main(int argc, char *argv[])
+{
+    char *test_argv[] = {NULL};
+    fct_unused(argc);
+    test_argv[0] = argv[0];
+    return fixture_times_main(1, test_argv);
+}
@@ -0,0 +1,158 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_jobs.c
+
+Runs the tests with --jobs, and checks that the parent ends up with
+every result, in the same order as a serial run. We supply our own
+command line, so this always runs with the jobs.
+*/
+
+#include "fct.h"
+#include "test_support.h"
+
+#if defined(FCT_JOBS)
+#   define NUM_EXPECTED_FAILURES 2
+#else
+#   define NUM_EXPECTED_FAILURES 1
+#endif
+
+static char const *ordered_names[] =
+{
+    "first", "second", "third", "fourth", "fifth", NULL
+};
+
+FCT_BGN_FN(jobs_main)
+{
+    int num_setup =0;
+
+    FCT_SUITE_BGN(jobs_ordered)
+    {
+        FCT_TEST_BGN(first)
+        {
+            fct_chk(1);
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(second)
+        {
+            fct_chk(1);
+            fct_chk(1);
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(third)
+        {
+            fct_chk(0 && "expected to fail");
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(fourth)
+        {
+            fct_chk(1);
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(fifth)
+        {
+            fct_chk(1);
+        }
+        FCT_TEST_END();
+    }
+    FCT_SUITE_END();
+
+    FCT_FIXTURE_SUITE_BGN(jobs_fixture)
+    {
+        FCT_SETUP_BGN()
+        {
+            ++num_setup;
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+        }
+        FCT_TEARDOWN_END();
+
+        FCT_TEST_BGN(fixture_1)
+        {
+            fct_chk(num_setup > 0);
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN_IF(0, fixture_skipped)
+        {
+            fct_chk(0 && "should have been skipped");
+        }
+        FCT_TEST_END_IF();
+
+        FCT_TEST_BGN(fixture_2)
+        {
+            fct_chk(num_setup > 0);
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+#if defined(FCT_JOBS)
+    /* Losing the worker half way through the test makes it fail. */
+    FCT_SUITE_BGN(jobs_crash)
+    {
+        FCT_TEST_BGN(exits_early)
+        {
+            fct_chk(1);
+            _exit(3);
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(after_crash)
+        {
+            fct_chk(1);
+        }
+        FCT_TEST_END();
+    }
+    FCT_SUITE_END();
+#endif /* FCT_JOBS */
+
+    /* The workers only ever hold their own results, the parent has them
+    all but never runs a test itself. */
+    if ( fctkern_ptr__->jobs.worker_id < 0 )
+    {
+        fct_ts_t const *ts =
+            (fct_ts_t const*)fct_nlist__at(&(fctkern_ptr__->ts_list), 0);
+        size_t test_i =0;
+        for ( test_i =0; ordered_names[test_i] != NULL; ++test_i )
+        {
+            fct_test_t const *test =
+                (fct_test_t const*)fct_nlist__at(&(ts->test_list), test_i);
+            test_chk_run(fctstr_eq(fct_test__name(test),
+                                   ordered_names[test_i]));
+        }
+#if defined(FCT_JOBS)
+        test_chk_run(num_setup == 0);
+        test_chk_run(fctkern__tst_cnt(fctkern_ptr__) == 9);
+        test_chk_run(fctkern__tst_cnt_passed(fctkern_ptr__) == 7);
+#else
+        test_chk_run(fctkern__tst_cnt(fctkern_ptr__) == 7);
+#endif /* FCT_JOBS */
+    }
+    TEST_EXPECTED_FAILURES(NUM_EXPECTED_FAILURES);
+}
+FCT_END_FN();
+
+
+int main(int argc, char *argv[])
+{
+    char *test_argv[] = {NULL, NULL, NULL};
+    char jobs_opt[] = "--jobs";
+    char jobs_val[] = "3";
+    fct_unused(argc);
+    test_argv[0] = argv[0];
+    test_argv[1] = jobs_opt;
+    test_argv[2] = jobs_val;
+    return jobs_main(3, test_argv);
+}
@@ -0,0 +1,67 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_nested_tests.c
+
+Checks that by default a test may sit inside a loop in its suite, and
+that an initialized declaration may sit in a block between two tests,
+which C++ will only compile if the tests are not jumped to.
+*/
+
+#include "fct.h"
+
+static int runs[3] = {0, 0, 0};
+
+FCT_BGN()
+{
+    FCT_FIXTURE_SUITE_BGN(nested)
+    {
+        int loop_i =0;
+
+        FCT_SETUP_BGN()
+        {
+            fct_pass();
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            fct_pass();
+        }
+        FCT_TEARDOWN_END();
+
+        for ( loop_i =0; loop_i != 3; ++loop_i )
+        {
+            FCT_TEST_BGN(in_a_loop)
+            {
+                fct_req(loop_i >= 0 && loop_i < 3);
+                ++runs[loop_i];
+            }
+            FCT_TEST_END();
+        }
+
+        {
+            int const between =1;
+
+            FCT_TEST_BGN(after_a_declaration)
+            {
+                fct_chk_eq_int(between, 1);
+            }
+            FCT_TEST_END();
+        }
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    FCT_QTEST_BGN(nested__each_loop_ran_once)
+    {
+        fct_chk_eq_int(runs[0], 1);
+        fct_chk_eq_int(runs[1], 1);
+        fct_chk_eq_int(runs[2], 1);
+    }
+    FCT_QTEST_END();
+}
+FCT_END();
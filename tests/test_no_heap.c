@@ -0,0 +1,78 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_no_heap.c
+
+Builds with FCT_CONF_NO_HEAP, with the C library allocators poisoned so
+any call FCTX makes to them fails to link. Then checks that freed blocks
+are used again. Running out of the pool ends the run, that is checked by
+test_no_heap_multi.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define FCT_CONF_NO_HEAP
+#define FCT_POOL_SIZE (256*1024)
+
+/* Only FCTX is built after this point. */
+#define malloc(_SZ_)          fct_test_poisoned_malloc(_SZ_)
+#define calloc(_NUM_, _SZ_)   fct_test_poisoned_calloc(_NUM_, _SZ_)
+#define realloc(_PTR_, _SZ_)  fct_test_poisoned_realloc(_PTR_, _SZ_)
+#define free(_PTR_)           fct_test_poisoned_free(_PTR_)
+
+#include "fct.h"
+
+FCT_BGN_FN(no_heap_main)
+{
+    FCT_SUITE_BGN(no_heap)
+    {
+        FCT_TEST_BGN(many_checks)
+        {
+            int chk_i =0;
+            for ( chk_i =0; chk_i != 1000; ++chk_i )
+            {
+                fct_chk_eq_int(chk_i, chk_i);
+            }
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(fails)
+        {
+            fct_chk_eq_str("the pool", "the heap");
+        }
+        FCT_TEST_END();
+    }
+    FCT_SUITE_END();
+
+    FCT_EXPECTED_FAILURES(1);
+}
+FCT_END_FN();
+
+
+int main(int argc, char *argv[])
+{
+    int status =0;
+    size_t used =0;
+    status = no_heap_main(argc, argv);
+    used = fct_pool.used;
+    if ( status != 0 || used == 0 )
+    {
+        fprintf(stderr, "error: the run did not use the pool\n");
+        return 1;
+    }
+    /* Freed blocks are used again, rather than carving more. */
+    fct_free(fct_malloc(100));
+    fct_free(fct_malloc(100));
+    if ( fct_pool.used > used + 128 )
+    {
+        fprintf(stderr, "error: the pool did not reuse a block\n");
+        return 1;
+    }
+    return 0;
+}
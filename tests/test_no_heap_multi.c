@@ -0,0 +1,37 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_no_heap_multi.c
+
+Builds with FCT_CONF_NO_HEAP over two files, to check they share the one
+pool, and that running out of it in the other file ends the run. The
+run is split in two with a test name filter, see tests/CMakeLists.txt.
+*/
+
+#define FCT_CONF_NO_HEAP
+#define FCT_POOL_SIZE (256*1024)
+
+#include "fct.h"
+
+FCTMF_SUITE_DEF(no_heap_multi_overflow);
+
+/* In test_no_heap_multi_suite.c, the pool as that file sees it. */
+extern fct_pool_t *no_heap_multi_pool(void);
+
+FCT_BGN()
+{
+    FCT_QTEST_BGN(no_heap_multi__one_pool)
+    {
+#if defined(__GNUC__)
+        fct_chk( no_heap_multi_pool() == &fct_pool );
+#endif /* __GNUC__ */
+    }
+    FCT_QTEST_END();
+
+    FCTMF_SUITE_CALL(no_heap_multi_overflow);
+}
+FCT_END();
@@ -0,0 +1,32 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_no_heap_multi_suite.c
+*/
+
+#define FCT_CONF_NO_HEAP
+#define FCT_POOL_SIZE (256*1024)
+
+#include "fct.h"
+
+fct_pool_t *
+no_heap_multi_pool(void)
+{
+    return &fct_pool;
+}
+
+FCTMF_SUITE_BGN(no_heap_multi_overflow)
+{
+    FCT_TEST_BGN(no_heap_multi_overflow__runs_out)
+    {
+        /* Never comes back. */
+        (void)fct_malloc(FCT_POOL_SIZE);
+        fct_chk( !"the pool did not run out" );
+    }
+    FCT_TEST_END();
+}
+FCTMF_SUITE_END()
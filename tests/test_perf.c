@@ -0,0 +1,87 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_perf.c
+
+Checks that a test which spins counts instructions when the perf
+counters can be opened, and that nothing is counted when they can not.
+Also sends the counters through their text form and back. We supply our
+own command line, so the test is there to look at once it ends.
+*/
+
+#define FCT_CONF_PERF
+#include "fct.h"
+#include "test_support.h"
+
+static volatile unsigned long sink =0;
+FCT_BGN_FN(perf_main)
+{
+    FCT_SUITE_BGN(perf)
+    {
+        FCT_TEST_BGN(spins)
+        {
+            unsigned long add_i =0;
+            for ( add_i =0; add_i != 100000; ++add_i )
+            {
+                sink += add_i;
+            }
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(to_str_and_back)
+        {
+            fct_perf_t perf;
+            fct_perf_t copy;
+            char buf[FCT_MAX_LOG_LINE];
+            fct_perf__init(&perf);
+            fct_perf__init(&copy);
+            perf.mask = 1u << FCT_PERF_INSTRUCTIONS;
+            perf.counts[FCT_PERF_INSTRUCTIONS] = 12345.0;
+            fct_perf__to_str(&perf, buf, sizeof(buf));
+            fct_perf__from_str(&copy, buf);
+            fct_chk_eq_int((int)copy.mask, (int)perf.mask);
+            fct_chk_eq_dbl(copy.counts[FCT_PERF_INSTRUCTIONS], 12345.0);
+            fct_chk(!fct_perf__is_read(&copy, FCT_PERF_CYCLES));
+        }
+        FCT_TEST_END();
+    }
+    FCT_SUITE_END();
+
+    {
+        fct_ts_t const *ts = (fct_ts_t const*)fct_nlist__at(
+                                 &(fctkern_ptr__->ts_list), 0
+                             );
+        fct_test_t const *test = (fct_test_t const*)fct_nlist__at(
+                                     &(ts->test_list), 0
+                                 );
+        int cntr_i =0;
+        if ( fct_perf__is_read(&(test->perf), FCT_PERF_INSTRUCTIONS) )
+        {
+            test_chk_run(test->perf.counts[FCT_PERF_INSTRUCTIONS] > 100000.0);
+        }
+        else
+        {
+            /* Quietly fell back to timing only. */
+            for ( cntr_i =0; cntr_i != FCT_PERF_NUM; ++cntr_i )
+            {
+                test_chk_run(!fct_perf__is_read(&(test->perf), cntr_i));
+            }
+        }
+    }
+
+    TEST_EXPECTED_FAILURES(0);
+}
+FCT_END_FN();
+
+
+int main(int argc, char *argv[])
+{
+    char *test_argv[] = {NULL};
+    fct_unused(argc);
+    test_argv[0] = argv[0];
+    return perf_main(1, test_argv);
+}
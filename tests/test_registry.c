@@ -0,0 +1,158 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_registry.c
+
+Runs with the test registry turned on. Where the registry is not
+available (not ELF, not GCC) this falls back to the usual count pass,
+and the registry specific checks are skipped.
+*/
+
+#define FCT_CONF_REGISTRY
+#include "fct.h"
+
+static int mf_num_run =0;
+
+/* Never called with FCTMF_SUITE_CALL, the registry should run it. */
+FCTMF_SUITE_BGN(registry_mf)
+{
+    FCT_TEST_BGN(registry_mf__runs_once)
+    {
+        ++mf_num_run;
+        fct_chk_eq_int(mf_num_run, 1);
+    }
+    FCT_TEST_END();
+}
+FCTMF_SUITE_END();
+
+
+FCT_BGN_FN(registry_main)
+{
+    int num_setup =0;
+    int num_teardown =0;
+    int num_run =0;
+    int num_middle[3] = {0, 0, 0};
+    int num_after =0;
+    int num_last[2] = {0, 0};
+
+    FCT_FIXTURE_SUITE_BGN(registry)
+    {
+        FCT_SETUP_BGN()
+        {
+            ++num_setup;
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+        }
+        FCT_TEARDOWN_END();
+
+        FCT_TEST_BGN(registry__first)
+        {
+            fct_chk_eq_int(num_run, 0);
+            ++num_run;
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(registry__last)
+        {
+            fct_chk_eq_int(num_run, 1);
+            ++num_run;
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    FCT_SUITE_BGN(registry_empty)
+    {
+    }
+    FCT_SUITE_END();
+
+    /* A test in a loop is only registered once, the suite has to go
+    back to counting to run it each time round. */
+    FCT_FIXTURE_SUITE_BGN(registry_loop)
+    {
+        int loop_i =0;
+
+        FCT_SETUP_BGN()
+        {
+            ++num_setup;
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            ++num_teardown;
+        }
+        FCT_TEARDOWN_END();
+
+        for ( loop_i =0; loop_i != 3; ++loop_i )
+        {
+            FCT_TEST_BGN(registry_loop__middle)
+            {
+                ++num_middle[loop_i];
+            }
+            FCT_TEST_END();
+        }
+
+        FCT_TEST_BGN(registry_loop__after)
+        {
+            ++num_after;
+        }
+        FCT_TEST_END();
+
+        for ( loop_i =0; loop_i != 2; ++loop_i )
+        {
+            FCT_TEST_BGN(registry_loop__last)
+            {
+                ++num_last[loop_i];
+            }
+            FCT_TEST_END();
+        }
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    FCT_QTEST_BGN(registry__all_tests_ran)
+    {
+        fct_chk_eq_int(num_run, 2);
+        fct_chk_eq_int(num_middle[0], 1);
+        fct_chk_eq_int(num_middle[1], 1);
+        fct_chk_eq_int(num_middle[2], 1);
+        fct_chk_eq_int(num_after, 1);
+        fct_chk_eq_int(num_last[0], 1);
+        fct_chk_eq_int(num_last[1], 1);
+        /* Two in registry, and one for each of the six in registry_loop,
+        without any left open. With the registry, registry_loop also sets
+        up the walk that finds its tests out of place. */
+        fct_chk_eq_int(num_teardown, num_setup - 2);
+#if defined(FCT_REGISTRY)
+        fct_chk_eq_int(num_setup, 9);
+        /* The seven tests in this file, including the one in registry_mf,
+        with the ones in a loop counted once. */
+        fct_chk_eq_int((int)fctkern_ptr__->reg_test_cnt, 7);
+#else
+        fct_chk_eq_int(num_setup, 8);
+#endif /* FCT_REGISTRY */
+    }
+    FCT_QTEST_END();
+}
+FCT_END_FN();
+
+
+int main(int argc, char *argv[])
+{
+    int num_failed = registry_main(argc, argv);
+#if defined(FCT_REGISTRY)
+    if ( mf_num_run != 1 )
+    {
+        fprintf(stderr, "registry_mf was run %d times\n", mf_num_run);
+        return EXIT_FAILURE;
+    }
+#endif /* FCT_REGISTRY */
+    return num_failed;
+}
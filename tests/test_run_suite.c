@@ -0,0 +1,99 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_run_suite.c
+
+Checks that --run-suite and "suite.test" filters prune whole suites
+before they do any work. We supply our own command line, so the
+selection is always the same.
+*/
+
+#include "fct.h"
+
+FCT_BGN_FN(run_suite_main)
+{
+    int num_wanted_setup =0;
+    int num_unwanted_setup =0;
+    int num_kept =0;
+
+    FCT_FIXTURE_SUITE_BGN(wanted)
+    {
+        FCT_SETUP_BGN()
+        {
+            ++num_wanted_setup;
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+        }
+        FCT_TEARDOWN_END();
+
+        FCT_TEST_BGN(keep_1)
+        {
+            ++num_kept;
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(drop_1)
+        {
+            fct_chk(0 && "should be filtered out");
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    /* The test name passes the filter, but the suite is not named. */
+    FCT_FIXTURE_SUITE_BGN(unwanted)
+    {
+        FCT_SETUP_BGN()
+        {
+            ++num_unwanted_setup;
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+        }
+        FCT_TEARDOWN_END();
+
+        FCT_TEST_BGN(keep_2)
+        {
+            fct_chk(0 && "should be pruned with its suite");
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    FCT_QTEST_BGN(run_suite__check)
+    {
+        fct_chk_eq_int(num_wanted_setup, 1);
+        fct_chk_eq_int(num_kept, 1);
+        fct_chk_eq_int(num_unwanted_setup, 0);
+        /* Only "wanted" has finished, "unwanted" was never created. */
+        fct_chk_eq_int((int)fct_nlist__size(&(fctkern_ptr__->ts_list)), 1);
+    }
+    FCT_QTEST_END();
+}
+FCT_END_FN();
+
+
+int main(int argc, char *argv[])
+{
+    char *test_argv[] = {NULL, NULL, NULL, NULL, NULL};
+    char run_suite_opt[] = "--run-suite";
+    char run_suite_val[] = "wanted,run_suite__check";
+    char keep_filter[] = "keep";
+    char check_filter[] = "run_suite__check.";
+    fct_unused(argc);
+    test_argv[0] = argv[0];
+    test_argv[1] = run_suite_opt;
+    test_argv[2] = run_suite_val;
+    test_argv[3] = keep_filter;
+    test_argv[4] = check_filter;
+    return run_suite_main(5, test_argv);
+}
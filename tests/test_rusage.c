@@ -0,0 +1,92 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_rusage.c
+
+Checks that a test which spins takes CPU time and one that touches
+fresh memory takes page faults, and that the suite adds them up. We
+supply our own command line, with --rusage, so the suite is there to
+look at once it ends.
+*/
+
+#include "fct.h"
+#include "test_support.h"
+
+#define SPIN_SECS 0.02
+#define TOUCH_BYTES (4*1024*1024)
+
+static volatile char *touched =NULL;
+FCT_BGN_FN(rusage_main)
+{
+    FCT_SUITE_BGN(rusage)
+    {
+        FCT_TEST_BGN(spins)
+        {
+            fct_timer_t timer;
+            fct_timer__init(&timer);
+            fct_timer__start(&timer);
+            do
+            {
+                fct_timer__stop(&timer);
+            }
+            while ( fct_timer__duration(&timer) < SPIN_SECS );
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(touches)
+        {
+            size_t byte_i =0;
+            touched = (volatile char*)malloc(TOUCH_BYTES);
+            fct_req(touched != NULL);
+            for ( byte_i =0; byte_i < TOUCH_BYTES; byte_i += 512 )
+            {
+                touched[byte_i] = 1;
+            }
+            free((void*)touched);
+            touched = NULL;
+        }
+        FCT_TEST_END();
+    }
+    FCT_SUITE_END();
+
+#if defined(FCT_RUSAGE)
+    {
+        fct_ts_t const *ts = (fct_ts_t const*)fct_nlist__at(
+                                 &(fctkern_ptr__->ts_list), 0
+                             );
+        fct_test_t const *spins = (fct_test_t const*)fct_nlist__at(
+                                      &(ts->test_list), 0
+                                  );
+        fct_test_t const *touches = (fct_test_t const*)fct_nlist__at(
+                                        &(ts->test_list), 1
+                                    );
+        test_chk_run(fctkern_ptr__->is_rusage);
+        test_chk_run(spins->rusage.user_time + spins->rusage.sys_time > 0.0);
+        test_chk_run(touches->rusage.minor_faults > 0);
+        test_chk_run(ts->rusage.minor_faults
+                     == spins->rusage.minor_faults
+                     + touches->rusage.minor_faults);
+        test_chk_run(ts->rusage.vol_switches
+                     == spins->rusage.vol_switches
+                     + touches->rusage.vol_switches);
+    }
+#endif /* FCT_RUSAGE */
+
+    TEST_EXPECTED_FAILURES(0);
+}
+FCT_END_FN();
+
+
+int main(int argc, char *argv[])
+{
+    char *test_argv[] = {NULL, NULL};
+    char rusage_opt[] = "--rusage";
+    fct_unused(argc);
+    test_argv[0] = argv[0];
+    test_argv[1] = rusage_opt;
+    return rusage_main(2, test_argv);
+}
@@ -0,0 +1,275 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_shard.c
+
+Runs the same tests once per shard, and checks that every test ran in
+exactly one of them, with and without a prefix filter, and when packed
+by a --shard-plan. Also checks --timings-out. We supply our own
+command lines.
+*/
+
+#include "fct.h"
+#include "test_support.h"
+
+#define NUM_TESTS 12
+#define NUM_SHARDS 3
+
+/* How many times each test ran, over all the shards. */
+static int num_runs[NUM_TESTS];
+
+/* The tests that pass the "alpha" filter. */
+static int const is_alpha[NUM_TESTS] =
+{
+    1, 1, 1, 1, 0, 0, 0, 0, 1, 1, 0, 0
+};
+
+FCTMF_SUITE_BGN(shard_mf)
+{
+    FCT_TEST_BGN(alpha_mf_1)
+    {
+        ++num_runs[8];
+    }
+    FCT_TEST_END();
+
+    FCT_TEST_BGN(alpha_mf_2)
+    {
+        ++num_runs[9];
+    }
+    FCT_TEST_END();
+
+    FCT_TEST_BGN(beta_mf_1)
+    {
+        ++num_runs[10];
+    }
+    FCT_TEST_END();
+
+    FCT_TEST_BGN(beta_mf_2)
+    {
+        ++num_runs[11];
+    }
+    FCT_TEST_END();
+}
+FCTMF_SUITE_END();
+
+
+FCT_BGN_FN(shard_main)
+{
+    FCT_SUITE_BGN(shard_inline)
+    {
+        FCT_TEST_BGN(alpha_1)
+        {
+            ++num_runs[0];
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(alpha_2)
+        {
+            ++num_runs[1];
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(alpha_3)
+        {
+            ++num_runs[2];
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(alpha_4)
+        {
+            ++num_runs[3];
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(beta_1)
+        {
+            ++num_runs[4];
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(beta_2)
+        {
+            ++num_runs[5];
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(beta_3)
+        {
+            ++num_runs[6];
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(beta_4)
+        {
+            ++num_runs[7];
+        }
+        FCT_TEST_END();
+    }
+    FCT_SUITE_END();
+
+    FCTMF_SUITE_CALL(shard_mf);
+
+    TEST_EXPECTED_FAILURES(0);
+}
+FCT_END_FN();
+
+
+/* The number of tests that ran in each shard, on the last run_shards. */
+static int num_shard_runs[NUM_SHARDS];
+
+/* The long running test, alpha_1, and the rest all take a second. This
+leaves out beta_mf_2, so it goes by the hash. */
+static char const *plan_lines[] =
+{
+    "shard_inline.alpha_1 10.0\n",
+    "shard_inline.alpha_2 1.0\n",
+    "shard_inline.alpha_3 1.0\n",
+    "shard_inline.alpha_4 1.0\n",
+    "shard_inline.beta_1 1.0\n",
+    "shard_inline.beta_2 1.0\n",
+    "shard_inline.beta_3 1.0\n",
+    "shard_inline.beta_4 1.0\n",
+    "shard_mf.alpha_mf_1 1.0\n",
+    "shard_mf.alpha_mf_2 1.0\n",
+    "shard_mf.beta_mf_1 1.0\n",
+    NULL
+};
+
+/* Our own scratch files, see test_scratch_name. */
+static char plan_file[FCT_MAX_NAME];
+static char timings_file[FCT_MAX_NAME];
+
+
+static int
+sum_runs(void)
+{
+    int test_i =0;
+    int sum =0;
+    for ( test_i =0; test_i != NUM_TESTS; ++test_i )
+    {
+        sum += num_runs[test_i];
+    }
+    return sum;
+}
+
+
+/* Runs every shard, with the EXTRA options, and checks that each test
+ran once. When IS_FILTERED the extra options hold the "alpha" filter,
+and only those tests should have run. */
+static void
+run_shards(char *argv0, char *extra[], nbool_t is_filtered)
+{
+    char *test_argv[] = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+    char count_opt[] = "--shard-count";
+    char count_val[] = "3";
+    char index_opt[] = "--shard-index";
+    char index_val[] = "0";
+    int test_argc = 5;
+    int shard_i =0;
+    int test_i =0;
+    memset(num_runs, 0, sizeof(num_runs));
+    test_argv[0] = argv0;
+    test_argv[1] = count_opt;
+    test_argv[2] = count_val;
+    test_argv[3] = index_opt;
+    test_argv[4] = index_val;
+    for ( ; extra != NULL && *extra != NULL; ++extra )
+    {
+        test_argv[test_argc++] = *extra;
+    }
+    for ( shard_i =0; shard_i != NUM_SHARDS; ++shard_i )
+    {
+        int num_before = sum_runs();
+        index_val[0] = (char)('0' + shard_i);
+        test_chk_run(shard_main(test_argc, test_argv) == 0);
+        num_shard_runs[shard_i] = sum_runs() - num_before;
+    }
+    for ( test_i =0; test_i != NUM_TESTS; ++test_i )
+    {
+        int num_expected = (!is_filtered || is_alpha[test_i]) ? 1 : 0;
+        test_chk_run(num_runs[test_i] == num_expected);
+    }
+}
+
+
+/* Packs the tests by the times in the plan, the long test should get a
+shard to itself. */
+static void
+run_plan(char *argv0)
+{
+    char plan_opt[] = "--shard-plan";
+    char *extra[] = {NULL, NULL, NULL};
+    FILE *file =NULL;
+    char const **line =NULL;
+    int shard_i =0;
+    nbool_t is_alone =FCT_FALSE;
+    extra[0] = plan_opt;
+    extra[1] = plan_file;
+    file = fopen(plan_file, "w");
+    test_chk_run(file != NULL);
+    if ( file == NULL )
+    {
+        return;
+    }
+    for ( line = plan_lines; *line != NULL; ++line )
+    {
+        fputs(*line, file);
+    }
+    fclose(file);
+    run_shards(argv0, extra, FCT_FALSE);
+    for ( shard_i =0; shard_i != NUM_SHARDS; ++shard_i )
+    {
+        is_alone = is_alone || num_shard_runs[shard_i] == 1;
+    }
+    test_chk_run(is_alone);
+    remove(plan_file);
+}
+
+
+/* Writes the timings, and checks there is a line for every test. */
+static void
+run_timings(char *argv0)
+{
+    char *test_argv[] = {NULL, NULL, NULL};
+    char timings_opt[] = "--timings-out";
+    char line[FCT_MAX_LOG_LINE];
+    FILE *file =NULL;
+    int num_lines =0;
+    test_argv[0] = argv0;
+    test_argv[1] = timings_opt;
+    test_argv[2] = timings_file;
+    test_chk_run(shard_main(3, test_argv) == 0);
+    file = fopen(timings_file, "r");
+    test_chk_run(file != NULL);
+    if ( file == NULL )
+    {
+        return;
+    }
+    while ( fgets(line, sizeof(line), file) != NULL )
+    {
+        ++num_lines;
+    }
+    fclose(file);
+    remove(timings_file);
+    test_chk_run(num_lines == NUM_TESTS);
+}
+
+
+int main(int argc, char *argv[])
+{
+    char filter[] = "alpha";
+    char *extra[] = {filter, NULL};
+    fct_unused(argc);
+    test_scratch_name(plan_file, sizeof(plan_file), argv[0], "plan");
+    test_scratch_name(timings_file, sizeof(timings_file), argv[0],
+                      "timings");
+    run_shards(argv[0], NULL, FCT_FALSE);
+    run_shards(argv[0], extra, FCT_TRUE);
+    run_plan(argv[0]);
+    run_timings(argv[0]);
+    return (test_num_run_fails == 0) ? 0 : 1;
+}
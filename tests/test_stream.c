@@ -0,0 +1,103 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_stream.c
+
+Runs with --stream, and checks that no suite is kept once it is
+reported, while the totals and the --timings-out file still cover every
+test. We supply our own command line.
+*/
+
+#define FCT_USE_TEST_COUNT
+#include "fct.h"
+#include "test_support.h"
+
+#define NUM_SUITES 100
+
+FCTMF_SUITE_BGN(stream_mf)
+{
+    FCT_TEST_BGN(passes)
+    {
+        fct_chk(1);
+    }
+    FCT_TEST_END();
+}
+FCTMF_SUITE_END();
+
+
+FCT_BGN_FN(stream_main)
+{
+    int suite_i =0;
+
+    for ( suite_i =0; suite_i != NUM_SUITES; ++suite_i )
+    {
+        FCT_SUITE_BGN(stream)
+        {
+            FCT_TEST_BGN(passes)
+            {
+                fct_chk(1);
+                fct_chk(1);
+            }
+            FCT_TEST_END();
+
+            FCT_TEST_BGN(fails_on_the_first)
+            {
+                fct_chk(suite_i != 0 || !"expected to fail");
+            }
+            FCT_TEST_END();
+        }
+        FCT_SUITE_END();
+        test_chk_run(fct_nlist__size(&(fctkern_ptr__->ts_list)) == 0);
+    }
+
+    FCTMF_SUITE_CALL(stream_mf);
+
+    test_chk_run(fct_nlist__size(&(fctkern_ptr__->ts_list)) == 0);
+    test_chk_run(fctkern__tst_cnt(fctkern_ptr__) == 2*NUM_SUITES + 1);
+    test_chk_run(fctkern__tst_cnt_passed(fctkern_ptr__) == 2*NUM_SUITES);
+    test_chk_run(fctkern__chk_cnt(fctkern_ptr__) == 3*NUM_SUITES + 1);
+    TEST_EXPECTED_FAILURES(1);
+}
+FCT_END_FN();
+
+
+int main(int argc, char *argv[])
+{
+    char *test_argv[] = {NULL, NULL, NULL, NULL};
+    char stream_opt[] = "--stream";
+    char timings_opt[] = "--timings-out";
+    char timings_file[FCT_MAX_NAME];
+    char line[FCT_MAX_LOG_LINE];
+    FILE *file =NULL;
+    int num_lines =0;
+    int status =0;
+    fct_unused(argc);
+    test_scratch_name(timings_file, sizeof(timings_file), argv[0],
+                      "timings");
+    test_argv[0] = argv[0];
+    test_argv[1] = stream_opt;
+    test_argv[2] = timings_opt;
+    test_argv[3] = timings_file;
+    status = stream_main(4, test_argv);
+    file = fopen(timings_file, "r");
+    if ( file == NULL )
+    {
+        return 1;
+    }
+    while ( fgets(line, sizeof(line), file) != NULL )
+    {
+        ++num_lines;
+    }
+    fclose(file);
+    remove(timings_file);
+    if ( num_lines != 2*NUM_SUITES + 1 )
+    {
+        fprintf(stderr, "error: the timings missed some tests\n");
+        return 1;
+    }
+    return status;
+}
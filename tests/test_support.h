@@ -0,0 +1,70 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_support.h
+
+Helpers for the tests that look over their own run: scratch file
+names and checks on the run as a whole. Include it after fct.h.
+*/
+
+#if !defined(TEST_SUPPORT_H)
+#define TEST_SUPPORT_H
+
+#if defined(WIN32)
+#   include <process.h>
+#   define test_getpid  _getpid
+#else
+#   include <unistd.h>
+#   define test_getpid  getpid
+#endif
+
+/* Names a scratch file after the program and its process. ctest runs
+each test program several ways, and the C++ copy besides, and they may
+all be running at once. */
+static void
+test_scratch_name(char *buf, size_t len, char const *argv0,
+                  char const *suffix)
+{
+    fct_snprintf(buf, len, "%s.%lu.%s",
+                 argv0, (unsigned long)test_getpid(), suffix);
+}
+
+/* Checks on the run as a whole, made once its suites are done, where
+fct_chk has no test to go to. One that does not hold is printed with
+where it is, and makes TEST_EXPECTED_FAILURES fail the run. */
+#define test_chk_run(_CNDTN_) \
+    test_chk_run_fn((_CNDTN_) ? 1 : 0, #_CNDTN_, __FILE__, __LINE__)
+
+static size_t test_num_run_fails =0;
+
+static void
+test_chk_run_fn(int is_pass, char const *cndtn, char const *file,
+                int lineno)
+{
+    if ( is_pass )
+    {
+        return;
+    }
+    fprintf(stderr, "%s(%d): error: %s\n", file, lineno, cndtn);
+    ++test_num_run_fails;
+}
+
+/* Expects _NUM_ of the tests to fail, and none of the test_chk_run.
+Every test that includes this header calls it, so it also references
+the helpers that test does not use, as FCT_REFERENCE_FUNCS does. */
+#define TEST_EXPECTED_FAILURES(_NUM_) \
+    {\
+        int check = 0 && test_num_run_fails == 0;\
+        if ( check ) {\
+            test_scratch_name(NULL, 0, NULL, NULL);\
+            test_chk_run_fn(1, NULL, NULL, 0);\
+        }\
+        FCT_EXPECTED_FAILURES((test_num_run_fails == 0) ? (size_t)(_NUM_) \
+                              : (size_t)-1);\
+    }
+
+#endif /* TEST_SUPPORT_H */
@@ -0,0 +1,151 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_threads.c
+
+Runs a few FCTMF suites on a pool of threads, and checks that the
+results come out whole, and in the order the suites where called. We
+supply our own command line, so this always runs with the threads.
+*/
+
+#define FCT_CONF_THREADS
+#define FCT_USE_TEST_COUNT
+#include "fct.h"
+#include "test_support.h"
+
+#define NUM_CHKS 1000
+
+static int num_setup =0;
+
+static char const *ordered_names[] =
+{
+    "threads_a", "threads_b", "threads_c", "threads_d", "threads_inline", NULL
+};
+
+FCTMF_SUITE_BGN(threads_a)
+{
+    FCT_TEST_BGN(many_chks)
+    {
+        int chk_i =0;
+        for ( chk_i =0; chk_i != NUM_CHKS; ++chk_i )
+        {
+            fct_chk_eq_int(chk_i, chk_i);
+        }
+    }
+    FCT_TEST_END();
+}
+FCTMF_SUITE_END();
+
+
+FCTMF_SUITE_BGN(threads_b)
+{
+    FCT_TEST_BGN(fails_once)
+    {
+        fct_chk(1);
+        fct_chk(0 && "expected to fail");
+        fct_chk(1);
+    }
+    FCT_TEST_END();
+}
+FCTMF_SUITE_END();
+
+
+FCTMF_FIXTURE_SUITE_BGN(threads_c)
+{
+    FCT_SETUP_BGN()
+    {
+        ++num_setup;
+    }
+    FCT_SETUP_END();
+
+    FCT_TEARDOWN_BGN()
+    {
+    }
+    FCT_TEARDOWN_END();
+
+    FCT_TEST_BGN(sees_own_setup_1)
+    {
+        fct_chk_eq_int(num_setup, 1);
+    }
+    FCT_TEST_END();
+
+    FCT_TEST_BGN(sees_own_setup_2)
+    {
+        fct_chk_eq_int(num_setup, 2);
+    }
+    FCT_TEST_END();
+}
+FCTMF_FIXTURE_SUITE_END();
+
+
+FCTMF_SUITE_BGN(threads_d)
+{
+    FCT_TEST_BGN(many_chks)
+    {
+        int chk_i =0;
+        for ( chk_i =0; chk_i != NUM_CHKS; ++chk_i )
+        {
+            fct_chk(chk_i >= 0);
+        }
+    }
+    FCT_TEST_END();
+}
+FCTMF_SUITE_END();
+
+
+FCT_BGN_FN(threads_main)
+{
+    FCTMF_SUITE_CALL(threads_a);
+    FCTMF_SUITE_CALL(threads_b);
+    FCTMF_SUITE_CALL(threads_c);
+    FCTMF_SUITE_CALL(threads_d);
+
+    /* Waits for the ones above, so it is still reported last. */
+    FCT_SUITE_BGN(threads_inline)
+    {
+        FCT_TEST_BGN(runs_after)
+        {
+            fct_chk(1);
+        }
+        FCT_TEST_END();
+    }
+    FCT_SUITE_END();
+
+    {
+        size_t ts_i =0;
+        for ( ts_i =0; ordered_names[ts_i] != NULL; ++ts_i )
+        {
+            fct_ts_t const *ts =
+                (fct_ts_t const*)fct_nlist__at(&(fctkern_ptr__->ts_list), ts_i);
+            test_chk_run(fctstr_eq(fct_ts__name(ts), ordered_names[ts_i]));
+        }
+    }
+    test_chk_run(fctkern__tst_cnt(fctkern_ptr__) == 6);
+    test_chk_run(fctkern__tst_cnt_passed(fctkern_ptr__) == 5);
+    test_chk_run(fctkern__chk_cnt(fctkern_ptr__) == 2*NUM_CHKS + 6);
+    TEST_EXPECTED_FAILURES(1);
+}
+FCT_END_FN();
+
+
+int main(int argc, char *argv[])
+{
+#if defined(FCT_THREADS)
+    char *test_argv[] = {NULL, NULL, NULL};
+    char threads_opt[] = "--threads";
+    char threads_val[] = "4";
+    fct_unused(argc);
+    test_argv[0] = argv[0];
+    test_argv[1] = threads_opt;
+    test_argv[2] = threads_val;
+    return threads_main(3, test_argv);
+#else
+    /* No threads here, the suites simply run one after the other. */
+    fct_unused(argc);
+    return threads_main(1, argv);
+#endif /* FCT_THREADS */
+}
@@ -0,0 +1,56 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_timer.c
+
+Checks that the timer sees a sleep as wall clock time but next to no
+CPU time, and that a spin takes CPU time.
+*/
+
+#include "fct.h"
+
+#define NAP_SECS 0.02
+
+FCT_BGN()
+{
+    FCT_QTEST_BGN(timer__sleeps)
+    {
+#if defined(FCT_CLOCK_GETTIME)
+        fct_timer_t timer;
+        struct timespec nap;
+        nap.tv_sec = 0;
+        nap.tv_nsec = (long)(NAP_SECS * 1000000000.0);
+        fct_timer__init(&timer);
+        fct_timer__start(&timer);
+        while ( nanosleep(&nap, &nap) != 0 )
+        {
+            fct_pass();
+        }
+        fct_timer__stop(&timer);
+        fct_chk(fct_timer__duration(&timer) >= NAP_SECS*0.9);
+        fct_chk(fct_timer__thread_duration(&timer)
+                < fct_timer__duration(&timer));
+#endif /* FCT_CLOCK_GETTIME */
+    }
+    FCT_QTEST_END();
+
+    FCT_QTEST_BGN(timer__spins)
+    {
+        fct_timer_t timer;
+        fct_timer__init(&timer);
+        fct_timer__start(&timer);
+        do
+        {
+            fct_timer__stop(&timer);
+        }
+        while ( fct_timer__duration(&timer) < NAP_SECS );
+        fct_chk(fct_timer__thread_duration(&timer) > 0.0);
+        fct_chk(fct_timer__cpu_duration(&timer) > 0.0);
+    }
+    FCT_QTEST_END();
+}
+FCT_END();
@@ -0,0 +1,95 @@
+/*
+====================================================================
+Copyright (c) 2010 Ian Blumel.  All rights reserved.
+
+This software is licensed as described in the file LICENSE, which
+you should have received as part of this distribution.
+====================================================================
+File: test_zygote.c
+
+Runs the tests with --isolate, forked from FCT_ZYGOTE_READY. The start
+up before it should happen once, and every test should see the process
+as it was at that point. We supply our own command line, so this always
+runs isolated.
+*/
+
+#include "fct.h"
+#include "test_support.h"
+
+#if defined(FCT_JOBS)
+#   define NUM_EXPECTED_FAILURES 1
+#else
+#   define NUM_EXPECTED_FAILURES 0
+#endif
+
+static int num_warm_up =0;
+static int is_dirty =0;
+
+FCT_BGN_FN(zygote_main)
+{
+    /* Stands in for some expensive start up. */
+    ++num_warm_up;
+    FCT_ZYGOTE_READY();
+
+    FCT_SUITE_BGN(zygote)
+    {
+        FCT_TEST_BGN(makes_a_mess)
+        {
+            fct_chk_eq_int(num_warm_up, 1);
+            is_dirty = 1;
+        }
+        FCT_TEST_END();
+
+#if defined(FCT_JOBS)
+        /* Forked afresh, the mess is not seen here. */
+        FCT_TEST_BGN(sees_no_mess)
+        {
+            fct_chk_eq_int(num_warm_up, 1);
+            fct_chk_eq_int(is_dirty, 0);
+        }
+        FCT_TEST_END();
+
+        /* Only this test's process goes, the next test still runs. */
+        FCT_TEST_BGN(exits_early)
+        {
+            _exit(5);
+        }
+        FCT_TEST_END();
+#endif /* FCT_JOBS */
+
+        FCT_TEST_BGN(after_exit)
+        {
+            fct_chk_eq_int(num_warm_up, 1);
+        }
+        FCT_TEST_END();
+    }
+    FCT_SUITE_END();
+
+    if ( fctkern_ptr__->jobs.worker_id < 0 )
+    {
+#if defined(FCT_JOBS)
+        test_chk_run(!is_dirty);
+        test_chk_run(fctkern__tst_cnt(fctkern_ptr__) == 4);
+        test_chk_run(fctkern__tst_cnt_passed(fctkern_ptr__) == 3);
+#else
+        test_chk_run(fctkern__tst_cnt(fctkern_ptr__) == 2);
+#endif /* FCT_JOBS */
+    }
+    TEST_EXPECTED_FAILURES(NUM_EXPECTED_FAILURES);
+}
+FCT_END_FN();
+
+
+int main(int argc, char *argv[])
+{
+    char *test_argv[] = {NULL, NULL, NULL, NULL};
+    char isolate_opt[] = "--isolate";
+    char jobs_opt[] = "--jobs";
+    char jobs_val[] = "2";
+    fct_unused(argc);
+    test_argv[0] = argv[0];
+    test_argv[1] = isolate_opt;
+    test_argv[2] = jobs_opt;
+    test_argv[3] = jobs_val;
+    return zygote_main(4, test_argv);
+}